@@ -1,6 +1,500 @@
+/**
+ * @file
+ * Hauptprogramm ulam: beantwortet Anfragen an die ULAM-Funktionen
+ * stapelweise. Die Anfragen (siehe ulam_query.h) werden zeilenweise aus
+ * einer Datei oder von der Standardeingabe gelesen, in Stapeln parallel
+ * ausgewertet und in der Reihenfolge der Eingabe ausgegeben, je Anfrage eine
+ * Zeile mit dem Ergebnis. Am Ende werden Durchsatz und Perzentile der
+ * Bearbeitungszeit auf der Standardfehlerausgabe ausgegeben.
+ *
+ * Aufruf: ulam [-t threads] [-b stapelgröße] [-r hi] [-i indexdatei] [datei]
+ *         ulam [-t threads] [-r hi] [-i indexdatei] [-c einträge] --serve socket
+ *
+ * <ul>
+ *   <li> -t   Anzahl der Threads (0 = Anzahl der Prozessoren)
+ *   <li> -b   Anzahl der Anfragen je Stapel
+ *   <li> -r   Lauf-Index für [1, hi] aufbauen (siehe ulam_runs.h), damit
+ *             twins/multiples bis hi parallel beantwortet werden
+ *   <li> -i   Indexdatei mit vorberechneten Maxima öffnen (ulam_index.h)
+ *   <li> -c   Anzahl der Einträge des LRU-Caches im Server-Betrieb
+ *   <li> --serve  statt Datei bzw. Standardeingabe Anfragen über das
+ *             Unix-Domain-Socket beantworten (siehe ulam_server.h), bis
+ *             SIGINT oder SIGTERM eintrifft
+ * </ul>
+ *
+ * Die Eingabe wird in großen Blöcken gelesen und direkt im Lesepuffer
+ * zerlegt, die Ausgabe in einem großen Puffer gesammelt.
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <signal.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "ulam_index.h"
+#include "ulam_parallel.h"
+#include "ulam_query.h"
+#include "ulam_runs.h"
+#include "ulam_server.h"
+
+
+/* ============================================================================
+ * Symbolische Konstanten
+ * ========================================================================= */
+
+/** Größe des Lesepuffers in Byte; längere Zeilen sind ungültig */
+#define ULAM_APP_READ_SIZE (1 << 20)
+
+/** Größe des Ausgabepuffers in Byte */
+#define ULAM_APP_WRITE_SIZE (4 << 20)
+
+/** Voreingestellte Anzahl der Anfragen je Stapel */
+#define ULAM_APP_BATCH 65536
+
+/** Voreingestellte Anzahl der Einträge des LRU-Caches im Server-Betrieb */
+#define ULAM_APP_LRU 65536
+
+
+/* ============================================================================
+ * Typdefinitionen
+ * ========================================================================= */
+
+/**
+ * Zustand der Stapelverarbeitung.
+ */
+typedef struct
+{
+    ulam_query *batch;      /**< Anfragen des aktuellen Stapels */
+    int batch_size;         /**< Kapazität des Stapels */
+    int batch_count;        /**< Anzahl der Anfragen im Stapel */
+    char *out;              /**< Ausgabepuffer */
+    size_t out_len;         /**< belegte Bytes im Ausgabepuffer */
+    int64_t *latencies;     /**< Bearbeitungszeiten aller Anfragen */
+    size_t latency_count;   /**< Anzahl der Bearbeitungszeiten */
+    size_t latency_cap;     /**< Kapazität von latencies */
+} ulam_app;
+
+
+/* ============================================================================
+ * Prototypen der privaten Funktionen
+ * ========================================================================= */
+
+/**
+ * Nimmt eine Zeile in den Stapel auf und verarbeitet den Stapel, wenn er
+ * voll ist. Leere Zeilen werden übersprungen.
+ *
+ * @param app       Zustand
+ * @param line      Beginn der Zeile
+ * @param len       Länge der Zeile ohne Zeilenende
+ */
+static void ulam_app_line(ulam_app *app, const char *line, size_t len);
+
+/**
+ * Wertet den aktuellen Stapel aus und schreibt die Ergebnisse in den
+ * Ausgabepuffer.
+ *
+ * @param app       Zustand
+ */
+static void ulam_app_flush_batch(ulam_app *app);
+
+/**
+ * Schreibt den Ausgabepuffer auf die Standardausgabe.
+ *
+ * @param app       Zustand
+ */
+static void ulam_app_flush_output(ulam_app *app);
+
+/**
+ * Vergleichsfunktion für qsort() über Bearbeitungszeiten.
+ */
+static int ulam_app_compare(const void *a, const void *b);
+
+/**
+ * Beantwortet Anfragen über ein Unix-Domain-Socket, bis SIGINT oder SIGTERM
+ * eintrifft, und gibt danach die Statistik des Servers aus.
+ *
+ * @param socket_path   Pfad des Sockets
+ * @param lru_capacity  Anzahl der Einträge des LRU-Caches
+ * @return              EXIT_SUCCESS oder EXIT_FAILURE
+ */
+static int ulam_app_serve(const char *socket_path, int lru_capacity);
+
+/**
+ * Signal-Handler, der den Server beendet.
+ */
+static void ulam_app_signal(int signum);
+
+/**
+ * Liefert die aktuelle Zeit in Sekunden (monoton).
+ */
+static double ulam_app_now(void);
+
+
+/* ============================================================================
+ * Funktionsdefinitionen
+ * ========================================================================= */
+
+/* ----------------------------------------------------------------------------
+ * Funktion: main
+ * ------------------------------------------------------------------------- */
+int main(int argc, char **argv)
+{
+    ulam_app app;
+    const char *path = NULL;
+    const char *index_path = NULL;
+    const char *socket_path = NULL;
+    char *in;
+    char *newline;
+    size_t used;        /* belegte Bytes im Lesepuffer */
+    size_t pos;         /* Beginn der nächsten Zeile */
+    int skipping = 0;   /* 1, solange der Rest einer zu langen Zeile
+                           verworfen wird */
+    ssize_t n;
+    double start;
+    double seconds;
+    int runs_hi = 0;
+    int lru_capacity = ULAM_APP_LRU;
+    int status;
+    int fd;
+    int i;
+
+    memset(&app, 0, sizeof(app));
+    app.batch_size = ULAM_APP_BATCH;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+        {
+            ulam_parallel_set_threads(atoi(argv[++i]));
+        }
+        else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc)
+        {
+            app.batch_size = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+        {
+            runs_hi = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc)
+        {
+            index_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+        {
+            lru_capacity = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--serve") == 0 && i + 1 < argc)
+        {
+            socket_path = argv[++i];
+        }
+        else if (argv[i][0] != '-' && path == NULL)
+        {
+            path = argv[i];
+        }
+        else
+        {
+            fprintf(stderr, "Aufruf: %s [-t threads] [-b stapelgroesse] "
+                    "[-r hi] [-i indexdatei] [-c eintraege] "
+                    "[--serve socket | datei]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (app.batch_size < 1)
+    {
+        app.batch_size = ULAM_APP_BATCH;
+    }
+
+    if (index_path != NULL && ulam_index_open(index_path, 0) != 0)
+    {
+        fprintf(stderr, "Indexdatei %s ist ungueltig\n", index_path);
+        return EXIT_FAILURE;
+    }
+    if (runs_hi > 0 && ulam_runs_build(runs_hi) != 0)
+    {
+        fprintf(stderr, "Lauf-Index bis %d kann nicht aufgebaut werden\n",
+                runs_hi);
+        return EXIT_FAILURE;
+    }
+
+    if (socket_path != NULL)
+    {
+        status = ulam_app_serve(socket_path, lru_capacity);
+        ulam_runs_release();
+        ulam_index_close();
+        return status;
+    }
+
+    fd = (path != NULL) ? open(path, O_RDONLY) : STDIN_FILENO;
+    if (fd < 0)
+    {
+        fprintf(stderr, "%s kann nicht gelesen werden\n", path);
+        return EXIT_FAILURE;
+    }
+
+    in = (char *) malloc(ULAM_APP_READ_SIZE);
+    app.out = (char *) malloc(ULAM_APP_WRITE_SIZE);
+    app.batch = (ulam_query *) malloc((size_t) app.batch_size
+                                      * sizeof(ulam_query));
+    if (in == NULL || app.out == NULL || app.batch == NULL)
+    {
+        fprintf(stderr, "Nicht genuegend Speicher\n");
+        return EXIT_FAILURE;
+    }
+
+    start = ulam_app_now();
+    used = 0;
+
+    for (;;)
+    {
+        n = read(fd, in + used, ULAM_APP_READ_SIZE - used);
+        if (n <= 0)
+        {
+            break;
+        }
+        used += (size_t) n;
+        pos = 0;
+
+        if (skipping)
+        {
+            /* Rest der zu langen Zeile bis zum Zeilenende verwerfen */
+            newline = (char *) memchr(in, '\n', used);
+            if (newline == NULL)
+            {
+                used = 0;
+                continue;
+            }
+            pos = (size_t) (newline - in) + 1;
+            skipping = 0;
+        }
+
+        /* Alle vollständigen Zeilen direkt im Puffer zerlegen */
+        while ((newline = (char *) memchr(in + pos, '\n', used - pos))
+               != NULL)
+        {
+            ulam_app_line(&app, in + pos, (size_t) (newline - (in + pos)));
+            pos = (size_t) (newline - in) + 1;
+        }
+
+        if (pos == 0 && used == ULAM_APP_READ_SIZE)
+        {
+            /* Zeile passt nicht in den Puffer: einmal als ungültig melden
+             * und den Rest der Zeile überspringen */
+            ulam_app_line(&app, "?", 1);
+            skipping = 1;
+            used = 0;
+            continue;
+        }
+
+        /* Angefangene Zeile an den Pufferanfang verschieben */
+        memmove(in, in + pos, used - pos);
+        used -= pos;
+    }
+
+    /* Letzte Zeile ohne Zeilenende */
+    if (used > 0)
+    {
+        ulam_app_line(&app, in, used);
+    }
+    ulam_app_flush_batch(&app);
+    ulam_app_flush_output(&app);
+
+    seconds = ulam_app_now() - start;
+
+    /* Durchsatz und Perzentile der Bearbeitungszeit */
+    if (app.latency_count > 0)
+    {
+        qsort(app.latencies, app.latency_count, sizeof(int64_t),
+              ulam_app_compare);
+        fprintf(stderr, "%zu Anfragen in %.3f s (%.0f Anfragen/s)\n",
+                app.latency_count, seconds, app.latency_count / seconds);
+        fprintf(stderr, "Bearbeitungszeit [us]: p50 %.2f  p90 %.2f  "
+                "p99 %.2f  p99.9 %.2f  max %.2f\n",
+                app.latencies[app.latency_count * 50 / 100] / 1000.0,
+                app.latencies[app.latency_count * 90 / 100] / 1000.0,
+                app.latencies[app.latency_count * 99 / 100] / 1000.0,
+                app.latencies[app.latency_count * 999 / 1000] / 1000.0,
+                app.latencies[app.latency_count - 1] / 1000.0);
+    }
+
+    if (fd != STDIN_FILENO)
+    {
+        close(fd);
+    }
+    free(in);
+    free(app.out);
+    free(app.batch);
+    free(app.latencies);
+    ulam_runs_release();
+    ulam_index_close();
+
+    return EXIT_SUCCESS;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_app_line
+ * ------------------------------------------------------------------------- */
+static void ulam_app_line(ulam_app *app, const char *line, size_t len)
+{
+    /* Windows-Zeilenende und Leerzeilen */
+    if (len > 0 && line[len - 1] == '\r')
+    {
+        len--;
+    }
+    if (len == 0)
+    {
+        return;
+    }
+
+    ulam_query_parse(line, len, &app->batch[app->batch_count]);
+    app->batch_count++;
+
+    if (app->batch_count == app->batch_size)
+    {
+        ulam_app_flush_batch(app);
+    }
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_app_flush_batch
+ * ------------------------------------------------------------------------- */
+static void ulam_app_flush_batch(ulam_app *app)
+{
+    int64_t *grown;
+    size_t cap;
+    int i;
+
+    if (app->batch_count == 0)
+    {
+        return;
+    }
+
+    ulam_query_eval_batch(app->batch, app->batch_count);
+
+    /* Platz für die Bearbeitungszeiten */
+    if (app->latency_count + app->batch_count > app->latency_cap)
+    {
+        cap = (app->latency_cap > 0) ? 2 * app->latency_cap
+                                     : (size_t) app->batch_size;
+        while (cap < app->latency_count + app->batch_count)
+        {
+            cap *= 2;
+        }
+        grown = (int64_t *) realloc(app->latencies, cap * sizeof(int64_t));
+        if (grown != NULL)
+        {
+            app->latencies = grown;
+            app->latency_cap = cap;
+        }
+    }
+
+    for (i = 0; i < app->batch_count; i++)
+    {
+        if (ULAM_APP_WRITE_SIZE - app->out_len < 32)
+        {
+            ulam_app_flush_output(app);
+        }
+        app->out_len += (size_t) ulam_query_format(&app->batch[i],
+                                                   app->out + app->out_len,
+                                                   ULAM_APP_WRITE_SIZE
+                                                   - app->out_len);
+        if (app->latency_count < app->latency_cap)
+        {
+            app->latencies[app->latency_count++] = app->batch[i].latency_ns;
+        }
+    }
+
+    app->batch_count = 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_app_flush_output
+ * ------------------------------------------------------------------------- */
+static void ulam_app_flush_output(ulam_app *app)
+{
+    size_t written = 0;
+    ssize_t n;
+
+    while (written < app->out_len)
+    {
+        n = write(STDOUT_FILENO, app->out + written, app->out_len - written);
+        if (n <= 0)
+        {
+            break;
+        }
+        written += (size_t) n;
+    }
+
+    app->out_len = 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_app_compare
+ * ------------------------------------------------------------------------- */
+static int ulam_app_compare(const void *a, const void *b)
+{
+    int64_t x = *(const int64_t *) a;
+    int64_t y = *(const int64_t *) b;
+
+    return (x > y) - (x < y);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_app_serve
+ * ------------------------------------------------------------------------- */
+static int ulam_app_serve(const char *socket_path, int lru_capacity)
+{
+    ulam_server_stats stats;
+
+    signal(SIGINT, ulam_app_signal);
+    signal(SIGTERM, ulam_app_signal);
+
+    if (ulam_server_run(socket_path, (lru_capacity > 0) ? lru_capacity : 1)
+        != 0)
+    {
+        fprintf(stderr, "Socket %s kann nicht angelegt werden\n",
+                socket_path);
+        return EXIT_FAILURE;
+    }
+
+    ulam_server_get_stats(&stats);
+    fprintf(stderr, "%lld Anfragen in %lld Stapeln, %lld aus dem Cache\n",
+            stats.requests, stats.batches, stats.cache_hits);
+    fprintf(stderr, "Stapelgroesse: max %d  mittel %.2f\n",
+            stats.queue_max, stats.queue_avg);
+    fprintf(stderr, "Antwortzeit [us]: p50 %.2f  p99 %.2f\n",
+            stats.p50_us, stats.p99_us);
+
+    return EXIT_SUCCESS;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_app_signal
+ * ------------------------------------------------------------------------- */
+static void ulam_app_signal(int signum)
+{
+    (void) signum;
+    ulam_server_stop();
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_app_now
+ * ------------------------------------------------------------------------- */
+static double ulam_app_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
 
-int main ( ) {
-    printf( "hello!\n" );
-    return 0;
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
 }
@@ -25,11 +25,19 @@
  * Header-Dateien 
  * ========================================================================= */
 
-#include <stdio.h>
 #include <stdlib.h>
 #include <limits.h>
 #include <assert.h>
 
+#include "ulam.h"
+#include "ulam_cache.h"
+#include "ulam_constexpr.h"
+#include "ulam_index.h"
+#include "ulam_jump.h"
+#include "ulam_overflow.h"
+#include "ulam_sparse.h"
+#include "ulam_stats.h"
+
 
 
 /* ============================================================================
@@ -37,95 +45,50 @@
  * ========================================================================= */
 
 /**
- * Erreicht ein ungerader Wert der ULAM-Folge den Wert #ULAM_MAX, kann die Folge
- * nicht weiter berechnet werden, da es sonst zu einem Überlauf kommen würde. 
+ * Anzahl der Folgenglieder, die ulam_max() bei Nutzung des Caches höchstens
+ * zwischenspeichert, um deren maximale ULAM-Werte nachzutragen. Die längste
+ * ULAM-Folge für Startzahlen im int-Bereich hat weniger als 1000 Glieder.
  */
-#define ULAM_MAX INT_MAX / 3 + 1
+#define ULAM_CACHE_PATH_LEN 1024
 
 
 /* ============================================================================
- * Funktions-Prototypen
+ * Globale Variablen
  * ========================================================================= */
 
-/**
- * Liefert den nächsten ULAM-Wert zu einer positiven ganzen Zahl. Die 
- * ULAM-Funktion ist wie folgt definiert:
- * 
- * ULAM(an) =  
- * <ul>
- *   <li> an / 2,     falls an gerade und an > 1
- *   <li> 3 * an + 1, falls an ungerade und an > 0
- * </ul>
- * 
- * Die Funktion liefert -1, wenn an <= 0 oder wenn es während der Berechnung 
- * zu einem Überlauf kommen würde.
- *
- * @param an        positive ganze Zahl, zu der der nächste ULAM-Wert
- *                  geliefert werden soll.
- * @return          der nächste ULAM-Wert zur übergebenen Zahl
- */
-int ulam(int an);
+/** Maxima der kleinen Startzahlen, vom Compiler erzeugt */
+static constexpr ulam_constexpr_table<ULAM_CONSTEXPR_BITS> ulam_small_peaks;
 
-/**
- * Liefert für eine positive ganze Zahl a0 den maximalen Wert in der Folge 
- * ihrer ULAM-Werte, bspw. liefert ulam_max(5) den Wert 16 und ulam_max(7) den 
- * Wert 52. Wird eine Zahl < 1 übergeben, liefert die Funktion den Wert -1.
- * 
- * Die Funktion liefert -1, wenn a0 < 1 oder wenn es während der Berechnung 
- * zu einem Überlauf kommen würde.
- * 
- * @param a0        ganze Zahl, zu der der maximale ULAM-Wert geliefert 
- *                  werden soll.
- * @return          der maximale ULAM-Wert zur übergebenen Zahl 
- *                  oder -1 bei Überlauf oder wenn a0 < 1 ist
- */
-int ulam_max(int a0);
+
+/* ============================================================================
+ * Prototypen der privaten Funktionen
+ * ========================================================================= */
 
 /**
- * Prüft für alle positiven ganzen Zahlen a0 von 1 bis einschließlich limit, 
- * ob es ULAM-Zwillinge gibt, d.h. ob zwei benachbarte Werte a0 und a0+1 im 
- * Intervall vollständig enthalten sind, deren maximale ULAM_Werte gleich sind.
- * 
- * Die Funktion liefert a0, wenn ein Paar gefunden wurde und a0 die kleinere 
- * Zahl in einem solchen Paar ist. Sind mehrere Paare im Intervall enthalten, 
- * wird der kleinere Index des letzten Paars zurück gegeben.
- * 
- * Die Funktion liefert -1, wenn kein solches Zwillingspaar gefunden wird oder
- * es während der Berechnung zu einem Überlauf kommen würde.
- * 
- * @param limit     ganze Zahl, bis zu der nach ULAM-Zwillingen 
- *                  gesucht werden soll.
- * @return          die kleinere Zahl des letzten ULAM-Zwillingspaars
- *                  oder -1 bei Überlauf oder wenn es kein solches Paar gibt 
- *                  oder limit < 1 ist
+ * Berechnet ulam_max(a0) mit Hilfe eines dichten Caches (siehe 
+ * ulam_cache.h). Die Folge wird nur so lange berechnet, bis ein Folgenglied
+ * erreicht wird, dessen maximaler ULAM-Wert bereits im Cache steht.
+ * Anschließend werden die maximalen ULAM-Werte aller durchlaufenen
+ * Folgenglieder im Cache-Bereich nachgetragen. Folgenglieder oberhalb des
+ * dichten Caches werden im dünnen Cache (siehe ulam_sparse.h) gesucht und
+ * abgelegt; dieser ist threadsicher, der dichte Cache nicht.
+ *
+ * @param a0        positive ganze Zahl, zu der der maximale ULAM-Wert 
+ *                  geliefert werden soll.
+ * @param peaks     dichter Cache oder NULL
+ * @param size      Anzahl der Einträge in peaks
+ * @return          der maximale ULAM-Wert zur übergebenen Zahl
  */
-int ulam_twins(int limit);
+static int ulam_max_cached(int a0, int *peaks, int size);
 
 /**
- * Prüft, ob im Intervall von 1 bis einschließlich limit ULAM-Mehrlinge 
- * mit der Anzahl number vollständig enthalten sind, d.h. für number = 3 
- * Drillinge, für number = 4 Vierlinge usw. 
- *
- * Die Funktion liefert a0, wenn Mehrlinge gefunden wurden und a0 die 
- * kleinste Zahl ist, die zu den Mehrlingen gehört. Sind weitere 
- * Mehrlingsgruppen im Intervall enthalten, wird der kleinste Index der 
- * letzte Gruppe zurück gegeben.
- * 
- * Die Funktion liefert -1, wenn die Parameter nicht sinnvoll sind 
- * (limit < number, number < 2), keine solchen Mehrlinge gefunden wurden 
- * oder es während der Berechnung zu einem Überlauf kommen würde.
+ * Berechnet ulam_max(a0) für eine Suche mit deren eigenem Cache.
  *
- * Bspw. liefert ulam_multiples für (1000, 2) den Wert 5, für (1000, 3) den 
- * Wert 107, für (108, 3) den Wert -1 und für (391, 6) den Wert 386.
- * 
- * @param limit     positive ganze Zahl, bis zu der nach ULAM-Mehrlingen 
- *                  gesucht werden soll.
- * @param number    positive Zahl, die die Anzahl der gesuchten Mehrlinge angibt
- * @return          die kleinste Zahl des letzten "ULAM-Mehrlings" oder -1, wenn
- *                  keine Mehrlinge gefunden wurden, limit < number oder 
- *                  number < 2.
+ * @param a0        Startzahl (Werte < 1 liefern -1)
+ * @param view      Cache der Suche
+ * @return          der maximale ULAM-Wert zur übergebenen Zahl
  */
-int ulam_multiples(int limit, int number);
+static int ulam_max_view(int a0, const ulam_cache_view *view);
 
 
 /* ============================================================================
@@ -139,33 +102,49 @@ int ulam(int an)
 {
     int ulam_an;
     
+    switch (ulam_step(an, &ulam_an))
+    {
+        case ULAM_OK:
+            return ulam_an;
+
+        case ULAM_OVERFLOW:
+            /* Keine Ausgabe, der Aufrufer wertet die Statistik aus */
+            ulam_overflow_record(an, an);
+            return -1;
+
+        default:
+            return -1;
+    }
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_step
+ * ------------------------------------------------------------------------- */
+ulam_status ulam_step(int an, int *next)
+{
     /* Für negative Zahlen und 0 gibt es keinen nächsten ULAM-Wert. */
     if (an < 1)
     {
-        return -1;
+        return ULAM_INVALID;
     }
 
     /* Berechnung des nächsten ULAM-Werts */
     if (an % 2 == 0)
     {
         /* an ist gerade */
-        ulam_an = (an / 2);
+        *next = an / 2;
     }
     else
     {
         /* an ist ungerade */
-        if (an < ULAM_MAX)
-        {
-            ulam_an = (3 * an + 1);
-        }
-        else
+        if (an >= ULAM_MAX)
         {
-            printf("Ueberlauf bei Berechnung des Ulam-Wert von %d\n", an);
-            ulam_an = -1;
+            return ULAM_OVERFLOW;
         }
+        *next = 3 * an + 1;
     }
 
-    return ulam_an;
+    return ULAM_OK;
 }
 
 /* ----------------------------------------------------------------------------
@@ -173,9 +152,13 @@ int ulam(int an)
  * ------------------------------------------------------------------------- */
 int ulam_max(int a0)
 {
+    int max_ulam_value; /* max. ULAM-Wert in der Folge von a0 bis an */
+#ifdef ULAM_STATS
     int an;             /* Zahl, deren ULAM-Wert berechnet wird */
     int ulam_value;     /* ULAM-Wert zu an */
-    int max_ulam_value; /* max. ULAM-Wert in der Folge von a0 bis an */
+    long steps = 0;     /* Anzahl der Schritte bzw. ungeraden Schritte */
+    long odd_steps = 0;
+#endif
 
     /* Für negative Zahlen und 0 kann kein maximaler ULAM-Wert berechnet 
      * werden. */
@@ -183,14 +166,48 @@ int ulam_max(int a0)
     {
         return -1;
     }
+
+    /* Kleine Startzahlen stehen in der beim Übersetzen erzeugten Tabelle */
+    if (a0 < ulam_small_peaks.size)
+    {
+        return ulam_small_peaks.peak[a0];
+    }
     
-    /* Berechnung des maximalen ULAM-Werts für a0 */
+    /* Liegt a0 im geöffneten Index, wird der Wert dort nachgeschlagen */
+    max_ulam_value = ulam_index_lookup(a0);
+    if (max_ulam_value > 0)
+    {
+        return max_ulam_value;
+    }
+
+    /* Ist ein Cache angelegt, wird die Berechnung dort abgekürzt */
+    if (ulam_cache_size > 0 || ulam_sparse_size > 0)
+    {
+        return ulam_max_cached(a0, ulam_cache_peaks, ulam_cache_size);
+    }
+
+#ifndef ULAM_STATS
+    /* Ohne Instrumentierung rechnet der Sprung-Kernel (siehe ulam_jump.h);
+     * er vermerkt Überläufe wie die Schleife unten */
+    return ulam_max_jump(a0);
+#else
+    /* Berechnung des maximalen ULAM-Werts für a0, Schritt für Schritt, damit
+     * alle Schritte gezählt werden */
     an = a0;
     max_ulam_value = a0;
 
     while (an > 1)
     {
-        ulam_value = ulam(an);
+        if (ulam_step(an, &ulam_value) != ULAM_OK)
+        {
+            /* Überlauf: die Folge endet mit dem bisherigen Maximum */
+            ulam_overflow_record(a0, an);
+            break;
+        }
+#ifdef ULAM_STATS
+        steps++;
+        odd_steps += an % 2;
+#endif
         if (ulam_value > max_ulam_value)
         {
             max_ulam_value = ulam_value;
@@ -198,7 +215,137 @@ int ulam_max(int a0)
         an = ulam_value;
     }
 
+    ULAM_STATS_TRAJECTORY(steps, odd_steps);
+
     return max_ulam_value;
+#endif
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_max_cached
+ * ------------------------------------------------------------------------- */
+static int ulam_max_cached(int a0, int *peaks, int size)
+{
+    int path[ULAM_CACHE_PATH_LEN]; /* durchlaufene Folgenglieder */
+    int path_len;       /* Anzahl der Einträge in path */
+    int rest_max;       /* max. Folgenglied, das nicht in path passte */
+    int an;             /* Zahl, deren ULAM-Wert berechnet wird */
+    int next;           /* ULAM-Wert zu an */
+    int cached;         /* Cache-Eintrag zu an */
+    int max_ulam_value; /* max. ULAM-Wert ab dem jeweiligen Folgenglied */
+
+    /* 
+     * Folge berechnen, bis 1 erreicht wird, es zu einem Überlauf kommt oder 
+     * ein Folgenglied gefunden wird, dessen Maximum bereits bekannt ist. 
+     */
+    path_len = 0;
+    rest_max = 0;
+    max_ulam_value = 0;
+    an = a0;
+
+    while (an > 0)
+    {
+        if (an < size)
+        {
+            cached = peaks[an];
+            if (cached != 0)
+            {
+                ULAM_STATS_ADD(cache_hits, 1);
+                max_ulam_value = cached;
+                break;
+            }
+        }
+        else if (an % ULAM_SPARSE_SAMPLE == 0 && ulam_sparse_size > 0)
+        {
+            /* Große Folgenglieder im dünnen Cache */
+            cached = ulam_sparse_lookup(an);
+            if (cached != 0)
+            {
+                ULAM_STATS_ADD(cache_hits, 1);
+                max_ulam_value = cached;
+                break;
+            }
+        }
+
+        if (path_len < ULAM_CACHE_PATH_LEN)
+        {
+            path[path_len++] = an;
+        }
+        else if (an > rest_max)
+        {
+            rest_max = an;
+        }
+
+        if (an == 1)
+        {
+            ULAM_STATS_ADD(cache_misses, 1);
+            an = 0;
+        }
+        else if (ulam_step(an, &next) != ULAM_OK)
+        {
+            ULAM_STATS_ADD(cache_misses, 1);
+            ulam_overflow_record(a0, an);
+            an = 0;
+        }
+        else
+        {
+            ULAM_STATS_ADD(steps, 1);
+            ULAM_STATS_ADD(odd_steps, an % 2);
+            an = next;
+        }
+    }
+
+    /* 
+     * Rückwärts die Maxima der Teilfolgen bilden und für alle Folgenglieder
+     * im Cache-Bereich eintragen. Das Maximum einer Teilfolge ist das 
+     * Maximum aus ihrem ersten Glied und dem Maximum der restlichen Folge.
+     */
+    if (rest_max > max_ulam_value)
+    {
+        max_ulam_value = rest_max;
+    }
+
+    while (path_len > 0)
+    {
+        path_len--;
+        an = path[path_len];
+        if (an > max_ulam_value)
+        {
+            max_ulam_value = an;
+        }
+        if (an < size)
+        {
+            peaks[an] = max_ulam_value;
+        }
+        else if (an % ULAM_SPARSE_SAMPLE == 0)
+        {
+            ulam_sparse_insert(an, max_ulam_value);
+        }
+    }
+
+    return max_ulam_value;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_max_view
+ * ------------------------------------------------------------------------- */
+static int ulam_max_view(int a0, const ulam_cache_view *view)
+{
+    int peak;
+
+    /* Tabelle, Index und Cache-lose Berechnung wie bei ulam_max() */
+    if (a0 < ulam_small_peaks.size || view->size == 0)
+    {
+        return ulam_max(a0);
+    }
+
+    peak = ulam_index_lookup(a0);
+    if (peak > 0)
+    {
+        return peak;
+    }
+
+    return ulam_max_cached(a0, view->peaks, view->size);
 }
 
 /* ----------------------------------------------------------------------------
@@ -210,6 +357,7 @@ int ulam_twins(int limit)
     int ulam_max_2;
     int twin_index;     /* Index des kleineren Zwilling */
     int a0;             /* Zahl, für die der ULAM_Max-Wert berechnet wird */
+    ulam_cache_view cache; /* Cache dieser Suche */
     
     /* limit muss mind. 1 sein, um Zwillinge berechnen zu können. */
     if (limit < 1)
@@ -224,11 +372,13 @@ int ulam_twins(int limit)
      * Iteration der ULAM-Wert für jedes a0 nur einmal berechnet.
      */
     twin_index = -1;
-    ulam_max_1 = ulam_max(limit);
+    ulam_cache_acquire(&cache, limit);
+    ulam_max_1 = ulam_max_view(limit, &cache);
     
     for (a0 = limit - 1; a0 >= 0 && twin_index == -1; a0--)
     {
-        ulam_max_2 = ulam_max(a0);
+        ulam_cache_grow(&cache, limit - a0);
+        ulam_max_2 = ulam_max_view(a0, &cache);
         if (ulam_max_1 == ulam_max_2)
         {
             twin_index = a0;
@@ -239,6 +389,12 @@ int ulam_twins(int limit)
         }
     }
 
+    ulam_cache_done(&cache);
+
+    ULAM_STATS_ADD(searches, 1);
+    ULAM_STATS_ADD(search_seeds, limit - a0);
+    ULAM_STATS_ADD(search_early_exits, twin_index != -1);
+
     return twin_index;
 }
 
@@ -252,6 +408,7 @@ int ulam_multiples(int limit, int number)
     int count;           /* Anzahl der bereits gefundenen Mehrlinge */
     int multiples_index; /* Index des kleinsten Mehrlings */
     int a0;              /* Zahl, für die der ULAM-Maxwert berechnet wird */
+    ulam_cache_view cache; /* Cache dieser Suche */
 
     /* Es müssen mind. Zwillinge gesucht werden und das Intervall muss mind. so 
      * viele Werte enthalten wie Mehrlinge gesucht werden */
@@ -267,12 +424,14 @@ int ulam_multiples(int limit, int number)
      * in der gesamten Iteration der ULAM-Wert für jedes a0 nur einmal berechnet.
      */
     multiples_index = -1; /* Wert -1 bedeutet: noch kein Mehrling gefunden */
-    ulam_max_1 = ulam_max(limit);
+    ulam_cache_acquire(&cache, limit);
+    ulam_max_1 = ulam_max_view(limit, &cache);
     count = 1;
     
     for (a0 = limit - 1; a0 >= 0 && multiples_index == -1; a0--)
     {
-        ulam_max_2 = ulam_max(a0);
+        ulam_cache_grow(&cache, limit - a0);
+        ulam_max_2 = ulam_max_view(a0, &cache);
         if (ulam_max_1 == ulam_max_2)
         {
             /* einen weiteren gleichen ULAM-Wert gefunden */
@@ -293,6 +452,12 @@ int ulam_multiples(int limit, int number)
         }
     }
 
+    ulam_cache_done(&cache);
+
+    ULAM_STATS_ADD(searches, 1);
+    ULAM_STATS_ADD(search_seeds, limit - a0);
+    ULAM_STATS_ADD(search_early_exits, multiples_index != -1);
+
     return multiples_index;
 }
 
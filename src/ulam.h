@@ -0,0 +1,143 @@
+/**
+ * @file
+ * Dieses Modul deklariert die Berechnungen mit der ULAM-Funktion. Es werden
+ * ULAM-Folgen, ULAM-Zwillinge und ULAM-Mehrlinge berechnet.
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+#ifndef ULAM_H
+#define ULAM_H
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <limits.h>
+
+
+/* ============================================================================
+ * Symbolische Konstanten
+ * ========================================================================= */
+
+/**
+ * Erreicht ein ungerader Wert der ULAM-Folge den Wert #ULAM_MAX, kann die Folge
+ * nicht weiter berechnet werden, da es sonst zu einem Überlauf kommen würde. 
+ */
+#define ULAM_MAX (INT_MAX / 3 + 1)
+
+
+/* ============================================================================
+ * Typdefinitionen
+ * ========================================================================= */
+
+/**
+ * Ergebnis eines Berechnungsschritts mit ulam_step().
+ */
+typedef enum
+{
+    ULAM_OK = 0,        /**< nächster ULAM-Wert berechnet */
+    ULAM_INVALID,       /**< an <= 0, es gibt keinen nächsten ULAM-Wert */
+    ULAM_OVERFLOW       /**< 3 * an + 1 ist nicht mit int darstellbar */
+} ulam_status;
+
+
+/* ============================================================================
+ * Funktions-Prototypen
+ * ========================================================================= */
+
+/**
+ * Liefert den nächsten ULAM-Wert zu einer positiven ganzen Zahl. Die 
+ * ULAM-Funktion ist wie folgt definiert:
+ * 
+ * ULAM(an) =  
+ * <ul>
+ *   <li> an / 2,     falls an gerade und an > 1
+ *   <li> 3 * an + 1, falls an ungerade und an > 0
+ * </ul>
+ * 
+ * Die Funktion liefert -1, wenn an <= 0 oder wenn es während der Berechnung 
+ * zu einem Überlauf kommen würde. Ein Überlauf wird ohne Ausgabe in der
+ * Überlaufstatistik des Threads vermerkt (siehe ulam_overflow.h).
+ *
+ * @param an        positive ganze Zahl, zu der der nächste ULAM-Wert
+ *                  geliefert werden soll.
+ * @return          der nächste ULAM-Wert zur übergebenen Zahl
+ */
+int ulam(int an);
+
+/**
+ * Berechnet wie ulam() den nächsten ULAM-Wert, meldet Fehler aber über den
+ * Rückgabewert. Die Funktion hat keine Nebenwirkungen, insbesondere wird
+ * ein Überlauf nicht in der Überlaufstatistik vermerkt.
+ *
+ * @param an        Zahl, zu der der nächste ULAM-Wert berechnet werden soll
+ * @param next      Ziel für den nächsten ULAM-Wert; bleibt bei einem Fehler
+ *                  unverändert
+ * @return          #ULAM_OK, #ULAM_INVALID für an <= 0 oder #ULAM_OVERFLOW
+ */
+ulam_status ulam_step(int an, int *next);
+
+/**
+ * Liefert für eine positive ganze Zahl a0 den maximalen Wert in der Folge 
+ * ihrer ULAM-Werte, bspw. liefert ulam_max(5) den Wert 16 und ulam_max(7) den 
+ * Wert 52. Wird eine Zahl < 1 übergeben, liefert die Funktion den Wert -1.
+ * 
+ * Die Funktion liefert -1, wenn a0 < 1 oder wenn es während der Berechnung 
+ * zu einem Überlauf kommen würde.
+ * 
+ * @param a0        ganze Zahl, zu der der maximale ULAM-Wert geliefert 
+ *                  werden soll.
+ * @return          der maximale ULAM-Wert zur übergebenen Zahl 
+ *                  oder -1 bei Überlauf oder wenn a0 < 1 ist
+ */
+int ulam_max(int a0);
+
+/**
+ * Prüft für alle positiven ganzen Zahlen a0 von 1 bis einschließlich limit, 
+ * ob es ULAM-Zwillinge gibt, d.h. ob zwei benachbarte Werte a0 und a0+1 im 
+ * Intervall vollständig enthalten sind, deren maximale ULAM_Werte gleich sind.
+ * 
+ * Die Funktion liefert a0, wenn ein Paar gefunden wurde und a0 die kleinere 
+ * Zahl in einem solchen Paar ist. Sind mehrere Paare im Intervall enthalten, 
+ * wird der kleinere Index des letzten Paars zurück gegeben.
+ * 
+ * Die Funktion liefert -1, wenn kein solches Zwillingspaar gefunden wird oder
+ * es während der Berechnung zu einem Überlauf kommen würde.
+ * 
+ * @param limit     ganze Zahl, bis zu der nach ULAM-Zwillingen 
+ *                  gesucht werden soll.
+ * @return          die kleinere Zahl des letzten ULAM-Zwillingspaars
+ *                  oder -1 bei Überlauf oder wenn es kein solches Paar gibt 
+ *                  oder limit < 1 ist
+ */
+int ulam_twins(int limit);
+
+/**
+ * Prüft, ob im Intervall von 1 bis einschließlich limit ULAM-Mehrlinge 
+ * mit der Anzahl number vollständig enthalten sind, d.h. für number = 3 
+ * Drillinge, für number = 4 Vierlinge usw. 
+ *
+ * Die Funktion liefert a0, wenn Mehrlinge gefunden wurden und a0 die 
+ * kleinste Zahl ist, die zu den Mehrlingen gehört. Sind weitere 
+ * Mehrlingsgruppen im Intervall enthalten, wird der kleinste Index der 
+ * letzte Gruppe zurück gegeben.
+ * 
+ * Die Funktion liefert -1, wenn die Parameter nicht sinnvoll sind 
+ * (limit < number, number < 2), keine solchen Mehrlinge gefunden wurden 
+ * oder es während der Berechnung zu einem Überlauf kommen würde.
+ *
+ * Bspw. liefert ulam_multiples für (1000, 2) den Wert 5, für (1000, 3) den 
+ * Wert 107, für (108, 3) den Wert -1 und für (391, 6) den Wert 386.
+ * 
+ * @param limit     positive ganze Zahl, bis zu der nach ULAM-Mehrlingen 
+ *                  gesucht werden soll.
+ * @param number    positive Zahl, die die Anzahl der gesuchten Mehrlinge angibt
+ * @return          die kleinste Zahl des letzten "ULAM-Mehrlings" oder -1, wenn
+ *                  keine Mehrlinge gefunden wurden, limit < number oder 
+ *                  number < 2.
+ */
+int ulam_multiples(int limit, int number);
+
+#endif /* ULAM_H */
@@ -0,0 +1,153 @@
+/**
+ * @file
+ * Dieses Modul implementiert asynchrone, abbrechbare Suchen nach
+ * ULAM-Mehrlingen (siehe ulam_async.h).
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "ulam_parallel.h"
+#include "ulam_async.h"
+
+
+/* ============================================================================
+ * Prototypen der privaten Funktionen
+ * ========================================================================= */
+
+/**
+ * Hauptfunktion des Threads einer Suche.
+ *
+ * @param arg       Auftrag (ulam_async)
+ * @return          NULL
+ */
+static void *ulam_async_main(void *arg);
+
+
+/* ============================================================================
+ * Funktionsdefinitionen
+ * ========================================================================= */
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_async_multiples
+ * ------------------------------------------------------------------------- */
+int ulam_async_multiples(ulam_async *job, int limit, int number,
+                         long long timeout_us, ulam_parallel_progress progress,
+                         void *arg)
+{
+    struct timespec now;
+
+    memset(job, 0, sizeof(*job));
+    job->limit = limit;
+    job->number = number;
+    job->result = -1;
+    job->status = ULAM_ASYNC_RUNNING;
+    job->control.cancel = &job->cancel;
+    job->control.progress = progress;
+    job->control.arg = arg;
+
+    /* Die Frist beginnt mit dem Aufruf, nicht mit dem Start des Threads */
+    if (timeout_us > 0)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        job->control.deadline_ns = (long long) now.tv_sec * 1000000000LL
+                                   + now.tv_nsec + timeout_us * 1000LL;
+    }
+
+    if (pthread_create(&job->thread, NULL, ulam_async_main, job) != 0)
+    {
+        /* Ohne Thread ist der Auftrag sofort beendet, nichts ist geprüft */
+        job->verified_lo = limit;
+        job->status = ULAM_ASYNC_FAILED;
+        job->joined = 1;
+        __atomic_store_n(&job->finished, 1, __ATOMIC_RELEASE);
+        return -1;
+    }
+
+    return 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_async_twins
+ * ------------------------------------------------------------------------- */
+int ulam_async_twins(ulam_async *job, int limit, long long timeout_us,
+                     ulam_parallel_progress progress, void *arg)
+{
+    /* Zwillinge sind Mehrlinge mit der Anzahl 2; für limit < 2 liefert
+     * die Suche sofort -1 */
+    return ulam_async_multiples(job, limit, 2, timeout_us, progress, arg);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_async_cancel
+ * ------------------------------------------------------------------------- */
+void ulam_async_cancel(ulam_async *job)
+{
+    __atomic_store_n(&job->cancel, 1, __ATOMIC_RELAXED);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_async_done
+ * ------------------------------------------------------------------------- */
+int ulam_async_done(const ulam_async *job)
+{
+    return __atomic_load_n(&job->finished, __ATOMIC_ACQUIRE);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_async_wait
+ * ------------------------------------------------------------------------- */
+ulam_async_status ulam_async_wait(ulam_async *job, int *result, 
+                                  int *verified_lo)
+{
+    if (!job->joined)
+    {
+        pthread_join(job->thread, NULL);
+        job->joined = 1;
+    }
+
+    *result = job->result;
+    if (verified_lo != NULL)
+    {
+        *verified_lo = job->verified_lo;
+    }
+
+    return job->status;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_async_main
+ * ------------------------------------------------------------------------- */
+static void *ulam_async_main(void *arg)
+{
+    ulam_async *job = (ulam_async *) arg;
+
+    job->result = ulam_multiples_partial(job->limit, job->number, 
+                                         &job->control, &job->verified_lo);
+
+    /* Ohne Fund und mit verified_lo > 0 endete die Suche vorzeitig */
+    if (job->result >= 0 || job->verified_lo == 0)
+    {
+        job->status = ULAM_ASYNC_DONE;
+    }
+    else if (__atomic_load_n(&job->cancel, __ATOMIC_RELAXED))
+    {
+        job->status = ULAM_ASYNC_CANCELLED;
+    }
+    else
+    {
+        job->status = ULAM_ASYNC_EXPIRED;
+    }
+
+    __atomic_store_n(&job->finished, 1, __ATOMIC_RELEASE);
+
+    return NULL;
+}
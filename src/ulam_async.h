@@ -0,0 +1,129 @@
+/**
+ * @file
+ * Dieses Modul führt lange Suchen nach ULAM-Zwillingen und -Mehrlingen
+ * asynchron aus. ulam_async_multiples() startet die Suche in einem eigenen
+ * Thread mit ulam_multiples_partial() und kehrt sofort zurück; über den
+ * Auftrag (#ulam_async) kann der Aufrufer den Stand abfragen, die Suche
+ * abbrechen und auf das Ergebnis warten. Eine Frist begrenzt die Laufzeit,
+ * eine Callback-Funktion meldet den Fortschritt.
+ *
+ * Abbruch und Frist werden vor jedem Abschnitt der parallelen Suche
+ * geprüft. Eine vorzeitig beendete Suche liefert als Teilergebnis die
+ * Grenze verified_lo: im Intervall [verified_lo, limit] beginnt kein
+ * Mehrling. Für das gesamte Intervall ist das Ergebnis dann offen.
+ *
+ * Da der Scheduler (siehe ulam_sched.h) Aufträge nacheinander ausführt,
+ * laufen mehrere asynchrone Suchen abwechselnd fensterweise.
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+#ifndef ULAM_ASYNC_H
+#define ULAM_ASYNC_H
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <pthread.h>
+
+#include "ulam_parallel.h"
+
+
+/* ============================================================================
+ * Typdefinitionen
+ * ========================================================================= */
+
+/**
+ * Zustand eines asynchronen Auftrags.
+ */
+typedef enum
+{
+    ULAM_ASYNC_RUNNING,     /**< die Suche läuft noch */
+    ULAM_ASYNC_DONE,        /**< die Suche ist vollständig */
+    ULAM_ASYNC_CANCELLED,   /**< abgebrochen, nur Teilergebnis */
+    ULAM_ASYNC_EXPIRED,     /**< Frist abgelaufen, nur Teilergebnis */
+    ULAM_ASYNC_FAILED       /**< Thread nicht gestartet, kein Ergebnis */
+} ulam_async_status;
+
+/**
+ * Asynchroner Auftrag.
+ */
+typedef struct
+{
+    pthread_t thread;               /**< Thread der Suche */
+    int limit;                      /**< obere Grenze der Suche */
+    int number;                     /**< Anzahl der gesuchten Mehrlinge */
+    int cancel;                     /**< 1 nach ulam_async_cancel() */
+    int finished;                   /**< 1, sobald die Suche beendet ist */
+    int joined;                     /**< 1 nach ulam_async_wait() */
+    ulam_parallel_control control;  /**< Abbruch, Frist und Fortschritt */
+    int result;                     /**< Ergebnis wie ulam_multiples() */
+    int verified_lo;                /**< [verified_lo, limit] ist geprüft */
+    ulam_async_status status;       /**< Zustand nach dem Ende */
+} ulam_async;
+
+
+/* ============================================================================
+ * Funktions-Prototypen
+ * ========================================================================= */
+
+/**
+ * Startet ulam_multiples(limit, number) asynchron.
+ *
+ * @param job           Auftrag, der bis ulam_async_wait() gültig bleiben
+ *                      muss
+ * @param limit         positive ganze Zahl, bis zu der nach ULAM-Mehrlingen
+ *                      gesucht werden soll.
+ * @param number        Anzahl der gesuchten Mehrlinge
+ * @param timeout_us    Frist in Mikrosekunden ab dem Aufruf, 0 = keine
+ * @param progress      Callback-Funktion, die nach jedem Fenster aus dem
+ *                      Thread der Suche aufgerufen wird, oder NULL
+ * @param arg           Argument für progress
+ * @return              0 oder -1, wenn der Thread nicht gestartet werden
+ *                      kann; der Auftrag ist dann sofort mit
+ *                      #ULAM_ASYNC_FAILED beendet
+ */
+int ulam_async_multiples(ulam_async *job, int limit, int number,
+                         long long timeout_us, ulam_parallel_progress progress,
+                         void *arg);
+
+/**
+ * Startet ulam_twins(limit) asynchron, siehe ulam_async_multiples().
+ */
+int ulam_async_twins(ulam_async *job, int limit, long long timeout_us,
+                     ulam_parallel_progress progress, void *arg);
+
+/**
+ * Bricht eine laufende Suche ab. Die Suche endet nach dem aktuellen
+ * Abschnitt; das Teilergebnis liefert ulam_async_wait().
+ *
+ * @param job       Auftrag
+ */
+void ulam_async_cancel(ulam_async *job);
+
+/**
+ * Prüft, ohne zu warten, ob die Suche beendet ist.
+ *
+ * @param job       Auftrag
+ * @return          1, wenn die Suche beendet ist, sonst 0
+ */
+int ulam_async_done(const ulam_async *job);
+
+/**
+ * Wartet auf das Ende der Suche und liefert ihr Ergebnis. Danach kann der
+ * Auftrag neu gestartet werden.
+ *
+ * @param job           Auftrag
+ * @param result        Ziel für das Ergebnis wie ulam_multiples(); bei
+ *                      einem Teilergebnis -1
+ * @param verified_lo   Ziel für die Grenze des geprüften Intervalls oder
+ *                      NULL (siehe ulam_multiples_partial())
+ * @return              #ULAM_ASYNC_DONE, #ULAM_ASYNC_CANCELLED,
+ *                      #ULAM_ASYNC_EXPIRED oder #ULAM_ASYNC_FAILED
+ */
+ulam_async_status ulam_async_wait(ulam_async *job, int *result, 
+                                  int *verified_lo);
+
+#endif /* ULAM_ASYNC_H */
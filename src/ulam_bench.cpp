@@ -0,0 +1,358 @@
+/**
+ * @file
+ * Benchmark der ULAM-Berechnungen. Das Programm misst ulam(), ulam_max(),
+ * ulam_max_range(), ulam_twins() und ulam_multiples() in mehreren typischen
+ * Bereichen (kleine Startzahlen, bis 10^6, ab 10^8 und knapp unter
+ * #ULAM_MAX) und gibt je Fall die Zeit pro Startzahl, die Schritte pro
+ * Sekunde und die Takte pro Schritt aus. Die Ergebnisse werden zusätzlich
+ * als JSON-Datei geschrieben, damit Messungen verschiedener Versionen
+ * automatisch verglichen werden können.
+ *
+ * Aufruf: ulam_bench [json-datei] [wiederholungen]
+ *
+ * Jeder Fall wird mehrfach gemessen, ausgegeben wird die schnellste Messung.
+ * Als Schritt zählt eine Anwendung der ULAM-Funktion bis zum Erreichen von 1
+ * bzw. bis zum Überlauf.
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "ulam.h"
+#include "ulam_parallel.h"
+#include "ulam_range.h"
+
+
+/* ============================================================================
+ * Symbolische Konstanten
+ * ========================================================================= */
+
+/** Voreingestellte Anzahl der Wiederholungen je Fall */
+#define ULAM_BENCH_REPEAT 3
+
+/** Größe der Blöcke für ulam_max_range() */
+#define ULAM_BENCH_BLOCK 65536
+
+
+/* ============================================================================
+ * Typdefinitionen
+ * ========================================================================= */
+
+/**
+ * Gemessene Funktion. Sie bearbeitet die Startzahlen lo bis hi und liefert
+ * eine Prüfsumme, damit der Compiler die Berechnung nicht entfernt.
+ */
+typedef long long (*ulam_bench_fn)(int lo, int hi);
+
+/**
+ * Ein Benchmark-Fall.
+ */
+typedef struct
+{
+    const char *name;       /**< Name des Falls */
+    ulam_bench_fn fn;       /**< gemessene Funktion */
+    int lo;                 /**< kleinste Startzahl bzw. 0 für Suchen */
+    int hi;                 /**< größte Startzahl bzw. limit */
+    int single_step;        /**< 1, wenn fn je Startzahl nur einen Schritt
+                                 rechnet (ulam()) */
+} ulam_bench_case;
+
+
+/* ============================================================================
+ * Prototypen der privaten Funktionen
+ * ========================================================================= */
+
+static long long ulam_bench_ulam(int lo, int hi);
+static long long ulam_bench_max(int lo, int hi);
+static long long ulam_bench_max_range(int lo, int hi);
+static long long ulam_bench_twins(int lo, int hi);
+static long long ulam_bench_multiples(int lo, int hi);
+
+/**
+ * Zählt die Schritte aller Folgen der Startzahlen lo bis hi.
+ *
+ * @param lo        kleinste Startzahl
+ * @param hi        größte Startzahl
+ * @return          Summe der Schritte bis 1 bzw. bis zum Überlauf
+ */
+static long long ulam_bench_steps(int lo, int hi);
+
+/**
+ * Liefert die aktuelle Zeit in Sekunden (monoton).
+ */
+static double ulam_bench_now(void);
+
+/**
+ * Liefert den Stand des Taktzählers oder 0, wenn er nicht verfügbar ist.
+ */
+static uint64_t ulam_bench_cycles(void);
+
+
+/* ============================================================================
+ * Globale Variablen
+ * ========================================================================= */
+
+/** Ziel der Prüfsummen, damit die Messungen nicht wegoptimiert werden */
+static volatile long long ulam_bench_sink;
+
+/** alle Benchmark-Fälle; bei Suchen ist lo = 0 und hi das limit */
+static const ulam_bench_case ulam_bench_cases[] =
+{
+    { "ulam/1e6",               ulam_bench_ulam,      1, 1000000, 1 },
+    { "ulam_max/small",         ulam_bench_max,       1, 10000, 0 },
+    { "ulam_max/1e6",           ulam_bench_max,       1, 1000000, 0 },
+    { "ulam_max/1e8",           ulam_bench_max,       100000000, 100999999, 0 },
+    { "ulam_max/ulam_max",      ulam_bench_max,       ULAM_MAX - 1000000, 
+                                                      ULAM_MAX - 1, 0 },
+    { "ulam_max_range/1e6",     ulam_bench_max_range, 1, 1000000, 0 },
+    { "ulam_max_range/1e8",     ulam_bench_max_range, 100000000, 100999999, 0 },
+    { "ulam_max_range/ulam_max", ulam_bench_max_range, ULAM_MAX - 1000000, 
+                                                      ULAM_MAX - 1, 0 },
+    { "ulam_twins/1e6",         ulam_bench_twins,     0, 1000000, 0 },
+    { "ulam_twins/1e8",         ulam_bench_twins,     0, 100000000, 0 },
+    { "ulam_twins/ulam_max",    ulam_bench_twins,     0, ULAM_MAX, 0 },
+    { "ulam_multiples/1e6",     ulam_bench_multiples, 0, 1000000, 0 },
+    { "ulam_multiples/1e8",     ulam_bench_multiples, 0, 100000000, 0 },
+    { "ulam_multiples/ulam_max", ulam_bench_multiples, 0, ULAM_MAX, 0 },
+};
+
+
+/* ============================================================================
+ * Funktionsdefinitionen
+ * ========================================================================= */
+
+/* ----------------------------------------------------------------------------
+ * Funktion: main
+ * ------------------------------------------------------------------------- */
+int main(int argc, char **argv)
+{
+    const char *path = (argc > 1) ? argv[1] : "bench_result.json";
+    int repeat = (argc > 2) ? atoi(argv[2]) : ULAM_BENCH_REPEAT;
+    int cases = (int) (sizeof(ulam_bench_cases) / sizeof(ulam_bench_cases[0]));
+    const ulam_bench_case *bc;
+    FILE *json;
+    long long seeds;
+    long long steps;
+    long long result;
+    double seconds;
+    double best_seconds;
+    double start;
+    uint64_t cycles;
+    uint64_t best_cycles;
+    int lo;
+    int c;
+    int r;
+
+    if (repeat < 1)
+    {
+        repeat = 1;
+    }
+
+    json = fopen(path, "w");
+    if (json == NULL)
+    {
+        fprintf(stderr, "%s kann nicht geschrieben werden\n", path);
+        return EXIT_FAILURE;
+    }
+
+    fprintf(json, "{\n  \"threads\": %d,\n  \"isa\": %d,\n  \"repeat\": %d,\n"
+            "  \"cases\": [\n", ulam_parallel_get_threads(), 
+            (int) ulam_range_get_isa(), repeat);
+    printf("%-26s %12s %14s %10s %10s\n", "Fall", "ns/Startzahl", 
+           "Schritte/s", "Takte/S.", "Ergebnis");
+
+    for (c = 0; c < cases; c++)
+    {
+        bc = &ulam_bench_cases[c];
+
+        best_seconds = 0.0;
+        best_cycles = 0;
+        result = 0;
+        for (r = 0; r < repeat; r++)
+        {
+            start = ulam_bench_now();
+            cycles = ulam_bench_cycles();
+            result = bc->fn(bc->lo, bc->hi);
+            cycles = ulam_bench_cycles() - cycles;
+            seconds = ulam_bench_now() - start;
+            ulam_bench_sink = ulam_bench_sink + result;
+
+            if (r == 0 || seconds < best_seconds)
+            {
+                best_seconds = seconds;
+                best_cycles = cycles;
+            }
+        }
+
+        /* Suchen bearbeiten die Startzahlen vom Ergebnis bis limit */
+        lo = bc->lo;
+        if (lo == 0)
+        {
+            lo = (result > 0) ? (int) result : 1;
+        }
+        seeds = (long long) bc->hi - lo + 1;
+        steps = bc->single_step ? seeds : ulam_bench_steps(lo, bc->hi);
+
+        printf("%-26s %12.2f %14.4g %10.2f %10lld\n", bc->name,
+               best_seconds * 1e9 / seeds, steps / best_seconds,
+               (double) best_cycles / steps, result);
+        fprintf(json, "    { \"name\": \"%s\", \"lo\": %d, \"hi\": %d, "
+                "\"seeds\": %lld, \"steps\": %lld, \"seconds\": %.9f, "
+                "\"ns_per_seed\": %.3f, \"steps_per_second\": %.6g, "
+                "\"cycles_per_step\": %.3f, \"result\": %lld }%s\n",
+                bc->name, lo, bc->hi, seeds, steps, best_seconds,
+                best_seconds * 1e9 / seeds, steps / best_seconds,
+                (double) best_cycles / steps, result,
+                (c + 1 < cases) ? "," : "");
+    }
+
+    fprintf(json, "  ]\n}\n");
+    fclose(json);
+
+    return EXIT_SUCCESS;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_bench_ulam
+ * ------------------------------------------------------------------------- */
+static long long ulam_bench_ulam(int lo, int hi)
+{
+    long long sum = 0;
+    int a0;
+
+    for (a0 = lo; a0 <= hi; a0++)
+    {
+        sum += ulam(a0);
+    }
+
+    return sum;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_bench_max
+ * ------------------------------------------------------------------------- */
+static long long ulam_bench_max(int lo, int hi)
+{
+    long long sum = 0;
+    int a0;
+
+    for (a0 = lo; a0 <= hi; a0++)
+    {
+        sum += ulam_max(a0);
+    }
+
+    return sum;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_bench_max_range
+ * ------------------------------------------------------------------------- */
+static long long ulam_bench_max_range(int lo, int hi)
+{
+    static int out[ULAM_BENCH_BLOCK];
+    long long sum = 0;
+    int block_lo;
+    int block_hi;
+    int i;
+
+    for (block_lo = lo; block_lo <= hi; block_lo = block_hi + 1)
+    {
+        block_hi = (hi - block_lo < ULAM_BENCH_BLOCK - 1)
+                   ? hi : block_lo + ULAM_BENCH_BLOCK - 1;
+        ulam_max_range(block_lo, block_hi, out);
+        for (i = 0; i <= block_hi - block_lo; i++)
+        {
+            sum += out[i];
+        }
+        if (block_hi == hi)
+        {
+            break;
+        }
+    }
+
+    return sum;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_bench_twins
+ * ------------------------------------------------------------------------- */
+static long long ulam_bench_twins(int lo, int hi)
+{
+    (void) lo;
+
+    return ulam_twins(hi);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_bench_multiples
+ * ------------------------------------------------------------------------- */
+/* Drillinge: für größere Gruppen liegt die letzte Gruppe unter ULAM_MAX
+ * sehr weit unter limit, die Messung würde Minuten dauern */
+static long long ulam_bench_multiples(int lo, int hi)
+{
+    (void) lo;
+
+    return ulam_multiples(hi, 3);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_bench_steps
+ * ------------------------------------------------------------------------- */
+static long long ulam_bench_steps(int lo, int hi)
+{
+    long long steps = 0;
+    int an;
+    int a0;
+
+    for (a0 = lo; a0 <= hi && a0 > 0; a0++)
+    {
+        an = a0;
+        while (an > 1 && ulam_step(an, &an) == ULAM_OK)
+        {
+            steps++;
+        }
+        if (a0 == INT_MAX)
+        {
+            break;
+        }
+    }
+
+    /* Mindestens ein Schritt, damit die Quotienten definiert sind */
+    return (steps > 0) ? steps : 1;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_bench_now
+ * ------------------------------------------------------------------------- */
+static double ulam_bench_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_bench_cycles
+ * ------------------------------------------------------------------------- */
+static uint64_t ulam_bench_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
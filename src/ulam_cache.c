@@ -0,0 +1,285 @@
+/**
+ * @file
+ * Dieses Modul implementiert die Speicherverwaltung des Caches für maximale
+ * ULAM-Werte (siehe ulam_cache.h).
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "ulam_cache.h"
+
+
+/* ============================================================================
+ * Globale Variablen
+ * ========================================================================= */
+
+int *ulam_cache_peaks = NULL;
+int ulam_cache_size = 0;
+
+/** Speicherbudget des Caches in Byte */
+static size_t ulam_cache_budget = ULAM_CACHE_DEFAULT_BUDGET;
+
+/** 1, wenn der Cache über mehrere Bereichssuchen erhalten bleiben soll */
+static int ulam_cache_persistent = 0;
+
+
+/* ============================================================================
+ * Prototypen der privaten Funktionen
+ * ========================================================================= */
+
+/**
+ * Ändert die Größe des Caches auf size Einträge. Neu hinzukommende Einträge
+ * werden mit 0 (unbekannt) initialisiert.
+ *
+ * @param size      gewünschte Anzahl der Einträge
+ * @return          die Anzahl der Einträge nach der Änderung
+ */
+static int ulam_cache_resize(int size);
+
+/**
+ * Liefert die Anzahl der Einträge für 0 bis limit, begrenzt durch das
+ * Speicherbudget.
+ *
+ * @param limit     größte Startzahl
+ * @return          Anzahl der Einträge (>= 0)
+ */
+static int ulam_cache_entries(int limit);
+
+
+/* ============================================================================
+ * Funktionsdefinitionen
+ * ========================================================================= */
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_cache_set_budget
+ * ------------------------------------------------------------------------- */
+void ulam_cache_set_budget(size_t bytes)
+{
+    size_t max_entries = bytes / sizeof(int);
+
+    ulam_cache_budget = bytes;
+
+    /* Ein zu großer Cache wird auf das neue Budget verkleinert */
+    if ((size_t) ulam_cache_size > max_entries)
+    {
+        ulam_cache_resize((int) max_entries);
+    }
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_cache_get_budget
+ * ------------------------------------------------------------------------- */
+size_t ulam_cache_get_budget(void)
+{
+    return ulam_cache_budget;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_cache_set_persistent
+ * ------------------------------------------------------------------------- */
+void ulam_cache_set_persistent(int persistent)
+{
+    ulam_cache_persistent = persistent;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_cache_get_persistent
+ * ------------------------------------------------------------------------- */
+int ulam_cache_get_persistent(void)
+{
+    return ulam_cache_persistent;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_cache_prepare
+ * ------------------------------------------------------------------------- */
+int ulam_cache_prepare(int limit)
+{
+    int wanted;
+
+    if (limit < 1)
+    {
+        return ulam_cache_size;
+    }
+
+    /* Einträge für 0 bis limit, höchstens aber so viele wie das Budget
+     * zulässt */
+    wanted = ulam_cache_entries(limit);
+    if (wanted > ulam_cache_size)
+    {
+        ulam_cache_resize(wanted);
+    }
+
+    return ulam_cache_size;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_cache_finish
+ * ------------------------------------------------------------------------- */
+void ulam_cache_finish(void)
+{
+    if (!ulam_cache_persistent)
+    {
+        ulam_cache_release();
+    }
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_cache_release
+ * ------------------------------------------------------------------------- */
+void ulam_cache_release(void)
+{
+    free(ulam_cache_peaks);
+    ulam_cache_peaks = NULL;
+    ulam_cache_size = 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_cache_acquire
+ * ------------------------------------------------------------------------- */
+void ulam_cache_acquire(ulam_cache_view *view, int limit)
+{
+    memset(view, 0, sizeof(*view));
+
+    if (ulam_cache_persistent)
+    {
+        ulam_cache_prepare(limit);
+        view->peaks = ulam_cache_peaks;
+        view->size = ulam_cache_size;
+        view->max_size = ulam_cache_size;
+        view->shared = 1;
+        return;
+    }
+
+    view->max_size = ulam_cache_entries(limit);
+    view->size = (view->max_size < ULAM_CACHE_INITIAL_SIZE)
+                 ? view->max_size : ULAM_CACHE_INITIAL_SIZE;
+    view->peaks = (view->size > 0) 
+                  ? (int *) calloc((size_t) view->size, sizeof(int)) : NULL;
+    if (view->peaks == NULL)
+    {
+        /* Ohne Speicher sucht die Suche ohne Cache */
+        view->size = 0;
+        view->max_size = 0;
+    }
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_cache_grow
+ * ------------------------------------------------------------------------- */
+void ulam_cache_grow(ulam_cache_view *view, int scanned)
+{
+    long long wanted = (long long) scanned * ULAM_CACHE_GROWTH;
+    int *peaks;
+    int size;
+
+    if (view->shared || view->size >= view->max_size || wanted <= view->size)
+    {
+        return;
+    }
+
+    /* Verdoppeln, damit nur logarithmisch oft kopiert wird */
+    size = (view->size > view->max_size / 2) ? view->max_size 
+                                              : 2 * view->size;
+    peaks = (int *) realloc(view->peaks, (size_t) size * sizeof(int));
+    if (peaks == NULL)
+    {
+        /* Kein Speicher: die Suche behält den bisherigen Cache */
+        view->max_size = view->size;
+        return;
+    }
+
+    memset(peaks + view->size, 0, 
+           (size_t) (size - view->size) * sizeof(int));
+    view->peaks = peaks;
+    view->size = size;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_cache_done
+ * ------------------------------------------------------------------------- */
+void ulam_cache_done(ulam_cache_view *view)
+{
+    if (!view->shared)
+    {
+        free(view->peaks);
+    }
+    memset(view, 0, sizeof(*view));
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_cache_entries
+ * ------------------------------------------------------------------------- */
+static int ulam_cache_entries(int limit)
+{
+    size_t max_entries = ulam_cache_budget / sizeof(int);
+    size_t wanted;
+
+    if (limit < 0)
+    {
+        return 0;
+    }
+
+    wanted = (size_t) limit + 1;
+    if (wanted > max_entries)
+    {
+        wanted = max_entries;
+    }
+    if (wanted > INT_MAX)
+    {
+        wanted = INT_MAX;
+    }
+
+    return (int) wanted;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_cache_resize
+ * ------------------------------------------------------------------------- */
+static int ulam_cache_resize(int size)
+{
+    int *peaks;
+
+    if (size <= 0)
+    {
+        ulam_cache_release();
+        return 0;
+    }
+
+    /* Ein neuer Cache wird mit calloc angelegt, damit das Betriebssystem 
+     * die Seiten erst bei Benutzung bereitstellt */
+    if (ulam_cache_peaks == NULL)
+    {
+        peaks = (int *) calloc((size_t) size, sizeof(int));
+    }
+    else
+    {
+        peaks = (int *) realloc(ulam_cache_peaks, 
+                                (size_t) size * sizeof(int));
+    }
+    if (peaks == NULL)
+    {
+        /* Kein Speicher: der bisherige Cache bleibt unverändert bestehen */
+        return ulam_cache_size;
+    }
+
+    if (ulam_cache_peaks != NULL && size > ulam_cache_size)
+    {
+        memset(peaks + ulam_cache_size, 0,
+               (size_t) (size - ulam_cache_size) * sizeof(int));
+    }
+
+    ulam_cache_peaks = peaks;
+    ulam_cache_size = size;
+
+    return ulam_cache_size;
+}
@@ -0,0 +1,172 @@
+/**
+ * @file
+ * Dieses Modul verwaltet einen dichten Cache für maximale ULAM-Werte. Der
+ * Cache ist über die Startzahl a0 indiziert und enthält zu jedem bereits
+ * berechneten a0 den Wert ulam_max(a0) bzw. 0, falls der Wert noch nicht
+ * bekannt ist.
+ *
+ * ulam_max() konsultiert den Cache, sobald die Folge einen Wert unterhalb
+ * der Cache-Grenze erreicht, und trägt die Maxima aller Folgenglieder im
+ * Cache-Bereich nach.
+ *
+ * ulam_twins() und ulam_multiples() legen je Aufruf einen eigenen Cache an
+ * (#ulam_cache_view), der klein beginnt und mit der Anzahl der bereits
+ * durchsuchten Startzahlen wächst, höchstens bis zum Suchintervall bzw. bis
+ * zum einstellbaren Speicherbudget. Suchen, die nach wenigen Startzahlen
+ * enden, legen so kein großes Feld an, und gleichzeitige Aufrufe aus
+ * mehreren Threads stören sich nicht. Nur im persistenten Modus benutzen
+ * sie den globalen Cache, der über mehrere Aufrufe hinweg erhalten bleibt;
+ * dann dürfen sie nicht gleichzeitig aufgerufen werden.
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+#ifndef ULAM_CACHE_H
+#define ULAM_CACHE_H
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <stddef.h>
+
+
+/* ============================================================================
+ * Symbolische Konstanten
+ * ========================================================================= */
+
+/**
+ * Voreingestelltes Speicherbudget des Caches in Byte (64 MiB, d.h. etwa
+ * 16 Mio. Einträge).
+ */
+#define ULAM_CACHE_DEFAULT_BUDGET ((size_t) 64 * 1024 * 1024)
+
+/** Anzahl der Einträge, mit der der Cache einer Suche beginnt */
+#define ULAM_CACHE_INITIAL_SIZE 4096
+
+/** Der Cache einer Suche wächst auf das Vielfache der Anzahl der bereits
+ *  durchsuchten Startzahlen */
+#define ULAM_CACHE_GROWTH 16
+
+
+/* ============================================================================
+ * Typdefinitionen
+ * ========================================================================= */
+
+/**
+ * Cache, den eine einzelne Suche benutzt: entweder ein eigenes Feld oder
+ * im persistenten Modus der globale Cache.
+ */
+typedef struct
+{
+    int *peaks;         /**< peaks[a0] enthält ulam_max(a0) oder 0 */
+    int size;           /**< Anzahl der Einträge in peaks */
+    int max_size;       /**< Größe, bis zu der der Cache wachsen darf */
+    int shared;         /**< 1, wenn peaks der globale Cache ist */
+} ulam_cache_view;
+
+
+/* ============================================================================
+ * Globale Variablen
+ * ========================================================================= */
+
+/**
+ * Cache-Einträge: ulam_cache_peaks[a0] enthält ulam_max(a0) oder 0, falls
+ * der Wert noch nicht berechnet wurde.
+ */
+extern int *ulam_cache_peaks;
+
+/**
+ * Anzahl der Einträge in #ulam_cache_peaks; 0, wenn kein Cache angelegt ist.
+ */
+extern int ulam_cache_size;
+
+
+/* ============================================================================
+ * Funktions-Prototypen
+ * ========================================================================= */
+
+/**
+ * Legt fest, wie viel Speicher der Cache höchstens belegen darf. Ist der
+ * aktuelle Cache größer, wird er entsprechend verkleinert. Ein Budget von 0
+ * schaltet den Cache ab.
+ *
+ * @param bytes     maximale Größe des Caches in Byte
+ */
+void ulam_cache_set_budget(size_t bytes);
+
+/**
+ * Liefert das aktuell eingestellte Speicherbudget des Caches in Byte.
+ *
+ * @return          das Speicherbudget in Byte
+ */
+size_t ulam_cache_get_budget(void);
+
+/**
+ * Schaltet den persistenten Modus ein oder aus. Im persistenten Modus wird
+ * der Cache nach ulam_twins() und ulam_multiples() nicht freigegeben, so dass
+ * Folgeaufrufe bereits berechnete Werte wiederverwenden.
+ *
+ * @param persistent    1, um den Cache zu behalten, 0 sonst
+ */
+void ulam_cache_set_persistent(int persistent);
+
+/**
+ * Liefert, ob der persistente Modus eingeschaltet ist.
+ *
+ * @return          1 im persistenten Modus, sonst 0
+ */
+int ulam_cache_get_persistent(void);
+
+/**
+ * Stellt sicher, dass der Cache alle Startzahlen von 0 bis einschließlich
+ * limit abdeckt, soweit das Speicherbudget dies erlaubt. Bereits vorhandene
+ * Einträge bleiben erhalten.
+ *
+ * @param limit     größte Startzahl, die im Cache abgelegt werden soll
+ * @return          die Anzahl der Einträge im Cache
+ */
+int ulam_cache_prepare(int limit);
+
+/**
+ * Beendet die Nutzung des Caches durch eine Bereichssuche. Außerhalb des
+ * persistenten Modus wird der Cache dabei freigegeben.
+ */
+void ulam_cache_finish(void);
+
+/**
+ * Gibt den Cache unabhängig vom eingestellten Modus frei.
+ */
+void ulam_cache_release(void);
+
+/**
+ * Stellt einer Suche bis limit einen Cache bereit. Im persistenten Modus
+ * ist das der globale Cache (wie ulam_cache_prepare()), sonst ein eigenes
+ * Feld mit #ULAM_CACHE_INITIAL_SIZE Einträgen, höchstens aber limit + 1
+ * bzw. so vielen, wie das Budget zulässt.
+ *
+ * @param view      zu initialisierender Cache der Suche
+ * @param limit     größte Startzahl der Suche
+ */
+void ulam_cache_acquire(ulam_cache_view *view, int limit);
+
+/**
+ * Vergrößert den eigenen Cache einer Suche auf das #ULAM_CACHE_GROWTH-fache
+ * der durchsuchten Startzahlen, sobald er kleiner ist. Der globale Cache
+ * und ein Cache, der nicht wachsen darf, bleiben unverändert.
+ *
+ * @param view      Cache der Suche
+ * @param scanned   Anzahl der bereits durchsuchten Startzahlen
+ */
+void ulam_cache_grow(ulam_cache_view *view, int scanned);
+
+/**
+ * Beendet die Nutzung des Caches durch eine Suche und gibt ein eigenes Feld
+ * frei.
+ *
+ * @param view      Cache der Suche
+ */
+void ulam_cache_done(ulam_cache_view *view);
+
+#endif /* ULAM_CACHE_H */
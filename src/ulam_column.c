@@ -0,0 +1,669 @@
+/**
+ * @file
+ * Dieses Modul implementiert das spaltenweise Binärformat für Ergebnisse je
+ * Startzahl (siehe ulam_column.h).
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "ulam_traj.h"
+#include "ulam_column.h"
+
+
+/* ============================================================================
+ * Symbolische Konstanten
+ * ========================================================================= */
+
+/** Größe der kodierten Spalten eines Blocks höchstens: je Zeile 5 Byte
+ *  Startzahl, 5 Byte Maximum und 4 Byte Schritte */
+#define ULAM_COLUMN_MAX_SIZE (ULAM_COLUMN_BLOCK_ROWS * 14 + 8)
+
+/** Größe des Schreibpuffers der Datei in Byte */
+#define ULAM_COLUMN_BUFFER (1 << 20)
+
+/** Startwert der FNV-1a-Prüfsumme */
+#define ULAM_COLUMN_FNV_OFFSET 14695981039346656037ULL
+
+/** Multiplikator der FNV-1a-Prüfsumme */
+#define ULAM_COLUMN_FNV_PRIME 1099511628211ULL
+
+
+/* ============================================================================
+ * Typdefinitionen
+ * ========================================================================= */
+
+/**
+ * Kopf einer Datei im Spaltenformat.
+ */
+typedef struct
+{
+    char magic[8];          /**< #ULAM_COLUMN_MAGIC */
+    uint32_t version;       /**< #ULAM_COLUMN_VERSION */
+    uint32_t block_rows;    /**< #ULAM_COLUMN_BLOCK_ROWS */
+} ulam_column_file;
+
+
+/* ============================================================================
+ * Prototypen der privaten Funktionen
+ * ========================================================================= */
+
+/**
+ * Hauptfunktion des Hintergrund-Threads: kodiert und schreibt übergebene
+ * Puffer, bis der Schreiber geschlossen wird.
+ *
+ * @param arg       Schreiber (ulam_column_writer)
+ * @return          NULL
+ */
+static void *ulam_column_flush_main(void *arg);
+
+/**
+ * Übergibt den aktuellen Puffer an den Hintergrund-Thread und wartet dazu
+ * höchstens, bis der vorige Puffer geschrieben ist.
+ *
+ * @param writer    Schreiber
+ */
+static void ulam_column_submit(ulam_column_writer *writer);
+
+/**
+ * Kodiert die Zeilen eines Puffers.
+ *
+ * @param rows      Zeilen (rows->rows >= 1)
+ * @param block     Ziel für den Kopf des Blocks
+ * @param out       Ziel für die kodierten Spalten
+ */
+static void ulam_column_encode(const ulam_column_rows *rows, 
+                               ulam_column_block *block, unsigned char *out);
+
+/**
+ * Schreibt eine Zahl als Varint (7 Bit je Byte, niedrigwertige zuerst).
+ *
+ * @param out       Ziel
+ * @param value     Zahl
+ * @return          Anzahl der geschriebenen Bytes
+ */
+static size_t ulam_column_put_varint(unsigned char *out, uint64_t value);
+
+/**
+ * Liest einen Varint.
+ *
+ * @param in        kodierte Spalten
+ * @param size      Größe der kodierten Spalten
+ * @param pos       Leseposition, wird weitergesetzt
+ * @param value     gelesene Zahl
+ * @return          0 oder -1, wenn die Spalten zu kurz sind
+ */
+static int ulam_column_get_varint(const unsigned char *in, size_t size,
+                                  size_t *pos, uint64_t *value);
+
+/**
+ * Setzt eine FNV-1a-Prüfsumme über weitere Bytes fort.
+ */
+static uint64_t ulam_column_fnv(uint64_t hash, const void *data, size_t size);
+
+
+/* ============================================================================
+ * Funktionsdefinitionen
+ * ========================================================================= */
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_column_open
+ * ------------------------------------------------------------------------- */
+int ulam_column_open(ulam_column_writer *writer, const char *path)
+{
+    ulam_column_file header;
+    int ok;
+    int i;
+
+    memset(writer, 0, sizeof(*writer));
+    writer->pending = -1;
+
+    writer->file = (path != NULL) ? fopen(path, "wb") : NULL;
+    if (writer->file == NULL)
+    {
+        return -1;
+    }
+    setvbuf(writer->file, NULL, _IOFBF, ULAM_COLUMN_BUFFER);
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, ULAM_COLUMN_MAGIC, sizeof(ULAM_COLUMN_MAGIC));
+    header.version = ULAM_COLUMN_VERSION;
+    header.block_rows = ULAM_COLUMN_BLOCK_ROWS;
+    ok = fwrite(&header, sizeof(header), 1, writer->file) == 1;
+    writer->bytes = sizeof(header);
+
+    for (i = 0; i < 2; i++)
+    {
+        writer->buffers[i].seeds = (int *) malloc(ULAM_COLUMN_BLOCK_ROWS 
+                                                  * sizeof(int));
+        writer->buffers[i].peaks = (int *) malloc(ULAM_COLUMN_BLOCK_ROWS 
+                                                  * sizeof(int));
+        writer->buffers[i].steps = (int *) malloc(ULAM_COLUMN_BLOCK_ROWS 
+                                                  * sizeof(int));
+        ok = ok && writer->buffers[i].seeds != NULL 
+             && writer->buffers[i].peaks != NULL 
+             && writer->buffers[i].steps != NULL;
+    }
+    writer->encoded = (unsigned char *) malloc(ULAM_COLUMN_MAX_SIZE);
+    ok = ok && writer->encoded != NULL;
+
+    if (ok)
+    {
+        pthread_mutex_init(&writer->lock, NULL);
+        pthread_cond_init(&writer->cv, NULL);
+        if (pthread_create(&writer->thread, NULL, ulam_column_flush_main,
+                           writer) != 0)
+        {
+            pthread_mutex_destroy(&writer->lock);
+            pthread_cond_destroy(&writer->cv);
+            ok = 0;
+        }
+    }
+
+    if (!ok)
+    {
+        for (i = 0; i < 2; i++)
+        {
+            free(writer->buffers[i].seeds);
+            free(writer->buffers[i].peaks);
+            free(writer->buffers[i].steps);
+        }
+        free(writer->encoded);
+        fclose(writer->file);
+        remove(path);
+        memset(writer, 0, sizeof(*writer));
+        return -1;
+    }
+
+    return 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_column_append
+ * ------------------------------------------------------------------------- */
+int ulam_column_append(ulam_column_writer *writer, int seed, int peak,
+                       int steps)
+{
+    ulam_column_rows *rows = &writer->buffers[writer->current];
+
+    rows->seeds[rows->rows] = seed;
+    rows->peaks[rows->rows] = peak;
+    rows->steps[rows->rows] = steps;
+    rows->rows++;
+
+    if (rows->rows == ULAM_COLUMN_BLOCK_ROWS)
+    {
+        ulam_column_submit(writer);
+    }
+
+    return __atomic_load_n(&writer->failed, __ATOMIC_RELAXED) ? -1 : 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_column_close
+ * ------------------------------------------------------------------------- */
+int ulam_column_close(ulam_column_writer *writer)
+{
+    ulam_column_block end;
+    int ok;
+    int i;
+
+    if (writer->file == NULL)
+    {
+        return -1;
+    }
+
+    if (writer->buffers[writer->current].rows > 0)
+    {
+        ulam_column_submit(writer);
+    }
+
+    /* Thread beenden, nachdem der letzte Puffer geschrieben ist */
+    pthread_mutex_lock(&writer->lock);
+    while (writer->pending >= 0)
+    {
+        pthread_cond_wait(&writer->cv, &writer->lock);
+    }
+    writer->quit = 1;
+    pthread_cond_broadcast(&writer->cv);
+    pthread_mutex_unlock(&writer->lock);
+    pthread_join(writer->thread, NULL);
+
+    /* Block ohne Zeilen kennzeichnet das vollständige Dateiende */
+    memset(&end, 0, sizeof(end));
+    end.checksum = ULAM_COLUMN_FNV_OFFSET;
+    ok = !writer->failed && fwrite(&end, sizeof(end), 1, writer->file) == 1;
+    ok = (fclose(writer->file) == 0) && ok;
+
+    pthread_mutex_destroy(&writer->lock);
+    pthread_cond_destroy(&writer->cv);
+    for (i = 0; i < 2; i++)
+    {
+        free(writer->buffers[i].seeds);
+        free(writer->buffers[i].peaks);
+        free(writer->buffers[i].steps);
+    }
+    free(writer->encoded);
+    writer->file = NULL;
+
+    return ok ? 0 : -1;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_column_write_range
+ * ------------------------------------------------------------------------- */
+int ulam_column_write_range(const char *path, int lo, int hi)
+{
+    ulam_column_writer writer;
+    ulam_traj_stats *stats;
+    long long chunk_lo;
+    int chunk_hi;
+    int ok = 1;
+    int i;
+
+    if (lo < 1 || lo > hi)
+    {
+        return -1;
+    }
+
+    stats = (ulam_traj_stats *) malloc(ULAM_COLUMN_BLOCK_ROWS 
+                                       * sizeof(ulam_traj_stats));
+    if (stats == NULL || ulam_column_open(&writer, path) != 0)
+    {
+        free(stats);
+        return -1;
+    }
+
+    /* Während ein Abschnitt parallel berechnet wird, schreibt der
+     * Hintergrund-Thread den vorigen */
+    for (chunk_lo = lo; ok && chunk_lo <= hi; 
+         chunk_lo += ULAM_COLUMN_BLOCK_ROWS)
+    {
+        chunk_hi = (hi - chunk_lo >= ULAM_COLUMN_BLOCK_ROWS) 
+                   ? (int) chunk_lo + ULAM_COLUMN_BLOCK_ROWS - 1 : hi;
+        ulam_traj_range((int) chunk_lo, chunk_hi, 
+                        ULAM_TRAJ_PEAK | ULAM_TRAJ_STOPPING_TIME, stats);
+        for (i = 0; ok && i <= chunk_hi - chunk_lo; i++)
+        {
+            ok = ulam_column_append(&writer, (int) chunk_lo + i, 
+                                    stats[i].peak, 
+                                    stats[i].stopping_time) == 0;
+        }
+    }
+    free(stats);
+
+    ok = (ulam_column_close(&writer) == 0) && ok;
+
+    return ok ? 0 : -1;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_column_read_open
+ * ------------------------------------------------------------------------- */
+int ulam_column_read_open(ulam_column_reader *reader, const char *path)
+{
+    ulam_column_file header;
+
+    memset(reader, 0, sizeof(*reader));
+    reader->file = (path != NULL) ? fopen(path, "rb") : NULL;
+    if (reader->file == NULL)
+    {
+        return -1;
+    }
+
+    reader->encoded = (unsigned char *) malloc(ULAM_COLUMN_MAX_SIZE);
+    if (reader->encoded == NULL
+        || fread(&header, sizeof(header), 1, reader->file) != 1
+        || memcmp(header.magic, ULAM_COLUMN_MAGIC, 
+                  sizeof(ULAM_COLUMN_MAGIC)) != 0
+        || header.version != ULAM_COLUMN_VERSION
+        || header.block_rows != ULAM_COLUMN_BLOCK_ROWS)
+    {
+        ulam_column_read_close(reader);
+        return -1;
+    }
+
+    /* Vor dem ersten Block gibt es nichts zu überspringen */
+    reader->loaded = 1;
+
+    return 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_column_read_next
+ * ------------------------------------------------------------------------- */
+int ulam_column_read_next(ulam_column_reader *reader, 
+                          ulam_column_block *block)
+{
+    if (reader->file == NULL)
+    {
+        return -1;
+    }
+    if (reader->finished)
+    {
+        return 0;
+    }
+
+    /* Nicht benötigte Spalten überspringen, ohne sie zu lesen */
+    if (!reader->loaded 
+        && fseek(reader->file, (long) reader->block.size, SEEK_CUR) != 0)
+    {
+        return -1;
+    }
+
+    if (fread(&reader->block, sizeof(reader->block), 1, reader->file) != 1
+        || reader->block.rows > ULAM_COLUMN_BLOCK_ROWS
+        || reader->block.size > ULAM_COLUMN_MAX_SIZE
+        || reader->block.steps_bits > 32)
+    {
+        return -1;
+    }
+
+    if (reader->block.rows == 0)
+    {
+        reader->finished = 1;
+        return 0;
+    }
+
+    reader->loaded = 0;
+    *block = reader->block;
+
+    return 1;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_column_read_decode
+ * ------------------------------------------------------------------------- */
+int ulam_column_read_decode(ulam_column_reader *reader, int seeds[],
+                            int peaks[], int steps[])
+{
+    const ulam_column_block *block = &reader->block;
+    const unsigned char *in = reader->encoded;
+    uint64_t value;
+    uint64_t bits = 0;      /* noch nicht verbrauchte Bits */
+    int have = 0;           /* Anzahl der Bits in bits */
+    int64_t seed;
+    size_t pos = 0;
+    uint32_t i;
+
+    if (reader->file == NULL || reader->loaded || reader->finished)
+    {
+        return -1;
+    }
+    reader->loaded = 1;
+
+    if (fread(reader->encoded, 1, block->size, reader->file) != block->size
+        || ulam_column_fnv(ULAM_COLUMN_FNV_OFFSET, reader->encoded, 
+                           block->size) != block->checksum)
+    {
+        return -1;
+    }
+
+    /* Startzahlen: ZigZag-kodierte Differenzen */
+    seed = block->seed_min;
+    for (i = 0; i < block->rows; i++)
+    {
+        if (ulam_column_get_varint(in, block->size, &pos, &value) != 0)
+        {
+            return -1;
+        }
+        seed += (int64_t) (value >> 1) ^ -(int64_t) (value & 1);
+        seeds[i] = (int) seed;
+    }
+
+    /* Maxima: Abstand zu peak_min */
+    for (i = 0; i < block->rows; i++)
+    {
+        if (ulam_column_get_varint(in, block->size, &pos, &value) != 0)
+        {
+            return -1;
+        }
+        peaks[i] = (int) ((int64_t) block->peak_min + (int64_t) value);
+    }
+
+    /* Schritte: steps_bits Bit je Zeile, niedrigwertige zuerst */
+    for (i = 0; i < block->rows; i++)
+    {
+        while (have < (int) block->steps_bits)
+        {
+            if (pos >= block->size)
+            {
+                return -1;
+            }
+            bits |= (uint64_t) in[pos++] << have;
+            have += 8;
+        }
+        value = bits & ((1ULL << block->steps_bits) - 1);
+        bits >>= block->steps_bits;
+        have -= (int) block->steps_bits;
+        steps[i] = (int) ((int64_t) block->steps_min + (int64_t) value);
+    }
+
+    return (int) block->rows;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_column_read_close
+ * ------------------------------------------------------------------------- */
+void ulam_column_read_close(ulam_column_reader *reader)
+{
+    if (reader->file != NULL)
+    {
+        fclose(reader->file);
+    }
+    free(reader->encoded);
+    memset(reader, 0, sizeof(*reader));
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_column_flush_main
+ * ------------------------------------------------------------------------- */
+static void *ulam_column_flush_main(void *arg)
+{
+    ulam_column_writer *writer = (ulam_column_writer *) arg;
+    ulam_column_block block;
+    int pending;
+    int ok;
+
+    pthread_mutex_lock(&writer->lock);
+    for (;;)
+    {
+        while (!writer->quit && writer->pending < 0)
+        {
+            pthread_cond_wait(&writer->cv, &writer->lock);
+        }
+        if (writer->pending < 0)
+        {
+            break;
+        }
+        pending = writer->pending;
+        pthread_mutex_unlock(&writer->lock);
+
+        /* Kodieren und Schreiben ohne Sperre, der Aufrufer füllt
+         * währenddessen den anderen Puffer */
+        ulam_column_encode(&writer->buffers[pending], &block, 
+                           writer->encoded);
+        ok = fwrite(&block, sizeof(block), 1, writer->file) == 1
+             && fwrite(writer->encoded, 1, block.size, writer->file) 
+                == block.size;
+
+        pthread_mutex_lock(&writer->lock);
+        if (!ok)
+        {
+            __atomic_store_n(&writer->failed, 1, __ATOMIC_RELAXED);
+        }
+        writer->blocks++;
+        writer->bytes += sizeof(block) + block.size;
+        writer->pending = -1;
+        pthread_cond_broadcast(&writer->cv);
+    }
+    pthread_mutex_unlock(&writer->lock);
+
+    return NULL;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_column_submit
+ * ------------------------------------------------------------------------- */
+static void ulam_column_submit(ulam_column_writer *writer)
+{
+    pthread_mutex_lock(&writer->lock);
+    while (writer->pending >= 0)
+    {
+        pthread_cond_wait(&writer->cv, &writer->lock);
+    }
+    writer->pending = writer->current;
+    pthread_cond_broadcast(&writer->cv);
+    pthread_mutex_unlock(&writer->lock);
+
+    /* Der andere Puffer ist geschrieben und kann neu gefüllt werden */
+    writer->current ^= 1;
+    writer->buffers[writer->current].rows = 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_column_encode
+ * ------------------------------------------------------------------------- */
+static void ulam_column_encode(const ulam_column_rows *rows, 
+                               ulam_column_block *block, unsigned char *out)
+{
+    uint64_t bits = 0;      /* noch nicht geschriebene Bits */
+    int have = 0;           /* Anzahl der Bits in bits */
+    uint64_t range;
+    int64_t delta;
+    int64_t prev;
+    size_t pos = 0;
+    int i;
+
+    memset(block, 0, sizeof(*block));
+    block->rows = (uint32_t) rows->rows;
+    block->seed_min = block->seed_max = rows->seeds[0];
+    block->peak_min = block->peak_max = rows->peaks[0];
+    block->steps_min = block->steps_max = rows->steps[0];
+    for (i = 1; i < rows->rows; i++)
+    {
+        block->seed_min = (rows->seeds[i] < block->seed_min) 
+                          ? rows->seeds[i] : block->seed_min;
+        block->seed_max = (rows->seeds[i] > block->seed_max) 
+                          ? rows->seeds[i] : block->seed_max;
+        block->peak_min = (rows->peaks[i] < block->peak_min) 
+                          ? rows->peaks[i] : block->peak_min;
+        block->peak_max = (rows->peaks[i] > block->peak_max) 
+                          ? rows->peaks[i] : block->peak_max;
+        block->steps_min = (rows->steps[i] < block->steps_min) 
+                           ? rows->steps[i] : block->steps_min;
+        block->steps_max = (rows->steps[i] > block->steps_max) 
+                           ? rows->steps[i] : block->steps_max;
+    }
+
+    /* Startzahlen: ZigZag-kodierte Differenzen, die erste zu seed_min */
+    prev = block->seed_min;
+    for (i = 0; i < rows->rows; i++)
+    {
+        delta = (int64_t) rows->seeds[i] - prev;
+        pos += ulam_column_put_varint(out + pos, 
+                                      ((uint64_t) delta << 1) 
+                                      ^ (uint64_t) (delta >> 63));
+        prev = rows->seeds[i];
+    }
+
+    /* Maxima: Abstand zu peak_min */
+    for (i = 0; i < rows->rows; i++)
+    {
+        pos += ulam_column_put_varint(out + pos, 
+                                      (uint64_t) ((int64_t) rows->peaks[i] 
+                                                  - block->peak_min));
+    }
+
+    /* Schritte: so viele Bit, wie der größte Abstand zu steps_min braucht */
+    range = (uint64_t) ((int64_t) block->steps_max - block->steps_min);
+    while (range >> block->steps_bits)
+    {
+        block->steps_bits++;
+    }
+    for (i = 0; i < rows->rows; i++)
+    {
+        bits |= (uint64_t) ((int64_t) rows->steps[i] - block->steps_min) 
+                << have;
+        have += (int) block->steps_bits;
+        while (have >= 8)
+        {
+            out[pos++] = (unsigned char) bits;
+            bits >>= 8;
+            have -= 8;
+        }
+    }
+    if (have > 0)
+    {
+        out[pos++] = (unsigned char) bits;
+    }
+
+    block->size = (uint32_t) pos;
+    block->checksum = ulam_column_fnv(ULAM_COLUMN_FNV_OFFSET, out, pos);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_column_put_varint
+ * ------------------------------------------------------------------------- */
+static size_t ulam_column_put_varint(unsigned char *out, uint64_t value)
+{
+    size_t n = 0;
+
+    while (value >= 0x80)
+    {
+        out[n++] = (unsigned char) (value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = (unsigned char) value;
+
+    return n;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_column_get_varint
+ * ------------------------------------------------------------------------- */
+static int ulam_column_get_varint(const unsigned char *in, size_t size,
+                                  size_t *pos, uint64_t *value)
+{
+    int shift = 0;
+
+    *value = 0;
+    while (*pos < size && shift < 64)
+    {
+        *value |= (uint64_t) (in[*pos] & 0x7f) << shift;
+        if ((in[(*pos)++] & 0x80) == 0)
+        {
+            return 0;
+        }
+        shift += 7;
+    }
+
+    return -1;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_column_fnv
+ * ------------------------------------------------------------------------- */
+static uint64_t ulam_column_fnv(uint64_t hash, const void *data, size_t size)
+{
+    const unsigned char *bytes = (const unsigned char *) data;
+    size_t i;
+
+    for (i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= ULAM_COLUMN_FNV_PRIME;
+    }
+
+    return hash;
+}
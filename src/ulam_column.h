@@ -0,0 +1,215 @@
+/**
+ * @file
+ * Dieses Modul schreibt und liest Ergebnisse je Startzahl (Startzahl,
+ * Maximum, Schritte bis 1) in einem kompakten spaltenweisen Binärformat.
+ * Bei Läufen über 10^9 Startzahlen ist die Textausgabe mit printf() teurer
+ * als die Berechnung und belegt ein Vielfaches des Platzes.
+ *
+ * Die Zeilen werden in Blöcken zu höchstens #ULAM_COLUMN_BLOCK_ROWS
+ * gespeichert. Jeder Block beginnt mit einem Kopf (#ulam_column_block), der
+ * Minimum und Maximum jeder Spalte enthält, so dass ein Leser Blöcke ohne
+ * passende Werte überspringen kann, ohne sie zu dekodieren. Danach folgen
+ * die Spalten:
+ *
+ * <ul>
+ *   <li> Startzahlen als Differenz zur vorigen Startzahl (die erste zu
+ *        seed_min), ZigZag-kodiert als Varint, d.h. bei aufsteigenden
+ *        Startzahlen ein Byte je Zeile,
+ *   <li> Maxima als Varint des Abstands zu peak_min,
+ *   <li> Schritte als Abstand zu steps_min mit steps_bits Bit je Zeile.
+ * </ul>
+ *
+ * Ein Block mit 0 Zeilen kennzeichnet das Ende einer vollständig
+ * geschriebenen Datei.
+ *
+ * Der Schreiber sammelt die Zeilen abwechselnd in zwei Puffern. Ein voller
+ * Puffer wird von einem Hintergrund-Thread kodiert und geschrieben, während
+ * der Aufrufer den anderen Puffer füllt; gewartet wird nur, wenn der Thread
+ * mit dem vorigen Block noch nicht fertig ist.
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+#ifndef ULAM_COLUMN_H
+#define ULAM_COLUMN_H
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <pthread.h>
+
+
+/* ============================================================================
+ * Symbolische Konstanten
+ * ========================================================================= */
+
+/** Kennung am Anfang einer Datei im Spaltenformat */
+#define ULAM_COLUMN_MAGIC "ULAMCOL"
+
+/** Version des Dateiformats */
+#define ULAM_COLUMN_VERSION 1
+
+/** maximale Anzahl der Zeilen je Block */
+#define ULAM_COLUMN_BLOCK_ROWS 65536
+
+
+/* ============================================================================
+ * Typdefinitionen
+ * ========================================================================= */
+
+/**
+ * Kopf eines Blocks, wie er in der Datei steht.
+ */
+typedef struct
+{
+    uint32_t rows;          /**< Anzahl der Zeilen, 0 = Dateiende */
+    uint32_t size;          /**< Größe der kodierten Spalten in Byte */
+    int32_t seed_min;       /**< kleinste Startzahl */
+    int32_t seed_max;       /**< größte Startzahl */
+    int32_t peak_min;       /**< kleinstes Maximum */
+    int32_t peak_max;       /**< größtes Maximum */
+    int32_t steps_min;      /**< kleinste Anzahl der Schritte */
+    int32_t steps_max;      /**< größte Anzahl der Schritte */
+    uint32_t steps_bits;    /**< Bit je Eintrag der Spalte Schritte */
+    uint32_t reserved;      /**< 0 */
+    uint64_t checksum;      /**< FNV-1a über die kodierten Spalten */
+} ulam_column_block;
+
+/**
+ * Zeilen eines Blocks vor dem Kodieren bzw. nach dem Dekodieren.
+ */
+typedef struct
+{
+    int *seeds;             /**< Startzahlen */
+    int *peaks;             /**< Maxima */
+    int *steps;             /**< Schritte bis 1 */
+    int rows;               /**< belegte Zeilen */
+} ulam_column_rows;
+
+/**
+ * Schreiber für eine Datei im Spaltenformat.
+ */
+typedef struct
+{
+    FILE *file;                 /**< Ausgabedatei */
+    ulam_column_rows buffers[2];/**< abwechselnd gefüllte Puffer */
+    int current;                /**< Puffer, den der Aufrufer füllt */
+    unsigned char *encoded;     /**< kodierter Block (nur Hintergrund) */
+    pthread_t thread;           /**< Hintergrund-Thread */
+    pthread_mutex_t lock;       /**< schützt pending, quit und failed */
+    pthread_cond_t cv;          /**< signalisiert Änderungen von pending */
+    int pending;                /**< Puffer, der geschrieben wird, oder -1 */
+    int quit;                   /**< 1, wenn der Thread enden soll */
+    int failed;                 /**< 1 nach einem Schreibfehler */
+    uint64_t blocks;            /**< Anzahl der geschriebenen Blöcke */
+    uint64_t bytes;             /**< Anzahl der geschriebenen Bytes */
+} ulam_column_writer;
+
+/**
+ * Leser für eine Datei im Spaltenformat.
+ */
+typedef struct
+{
+    FILE *file;                 /**< Eingabedatei */
+    ulam_column_block block;    /**< Kopf des aktuellen Blocks */
+    unsigned char *encoded;     /**< kodierte Spalten des aktuellen Blocks */
+    int loaded;                 /**< 1, wenn die Spalten gelesen wurden */
+    int finished;               /**< 1, wenn das Dateiende erreicht ist */
+} ulam_column_reader;
+
+
+/* ============================================================================
+ * Funktions-Prototypen
+ * ========================================================================= */
+
+/**
+ * Legt eine Datei im Spaltenformat an und startet den Hintergrund-Thread.
+ *
+ * @param writer    zu initialisierender Schreiber
+ * @param path      Pfad der Datei
+ * @return          0 oder -1, wenn die Datei nicht angelegt werden kann
+ *                  oder nicht genügend Speicher vorhanden ist
+ */
+int ulam_column_open(ulam_column_writer *writer, const char *path);
+
+/**
+ * Hängt eine Zeile an. Ist der aktuelle Puffer voll, wird er an den
+ * Hintergrund-Thread übergeben.
+ *
+ * @param writer    Schreiber
+ * @param seed      Startzahl
+ * @param peak      Maximum
+ * @param steps     Schritte bis 1
+ * @return          0 oder -1 nach einem Schreibfehler
+ */
+int ulam_column_append(ulam_column_writer *writer, int seed, int peak,
+                       int steps);
+
+/**
+ * Schreibt die restlichen Zeilen und das Dateiende, beendet den
+ * Hintergrund-Thread und schließt die Datei.
+ *
+ * @param writer    Schreiber
+ * @return          0 oder -1, wenn ein Schreibfehler aufgetreten ist
+ */
+int ulam_column_close(ulam_column_writer *writer);
+
+/**
+ * Berechnet Maximum und Schritte bis 1 (ulam_traj_range()) für alle
+ * Startzahlen von lo bis hi und schreibt sie in eine Datei im
+ * Spaltenformat. Die Berechnung des nächsten Abschnitts überlappt mit dem
+ * Schreiben des vorigen.
+ *
+ * @param path      Pfad der Datei
+ * @param lo        kleinste Startzahl (>= 1)
+ * @param hi        größte Startzahl (>= lo)
+ * @return          0 oder -1 bei ungültigen Parametern oder Fehlern
+ */
+int ulam_column_write_range(const char *path, int lo, int hi);
+
+/**
+ * Öffnet eine Datei im Spaltenformat zum Lesen.
+ *
+ * @param reader    zu initialisierender Leser
+ * @param path      Pfad der Datei
+ * @return          0 oder -1, wenn die Datei fehlt oder ungültig ist
+ */
+int ulam_column_read_open(ulam_column_reader *reader, const char *path);
+
+/**
+ * Liest den Kopf des nächsten Blocks. Die Spalten des vorigen Blocks werden
+ * übersprungen, wenn sie nicht mit ulam_column_read_decode() gelesen
+ * wurden.
+ *
+ * @param reader    Leser
+ * @param block     Ziel für den Kopf des Blocks (Minima und Maxima)
+ * @return          1, wenn ein Block gelesen wurde, 0 am Dateiende oder -1,
+ *                  wenn die Datei ungültig oder unvollständig ist
+ */
+int ulam_column_read_next(ulam_column_reader *reader, 
+                          ulam_column_block *block);
+
+/**
+ * Dekodiert die Zeilen des aktuellen Blocks und prüft die Prüfsumme.
+ *
+ * @param reader    Leser
+ * @param seeds     Feld mit mindestens #ULAM_COLUMN_BLOCK_ROWS Einträgen
+ * @param peaks     ebenso
+ * @param steps     ebenso
+ * @return          Anzahl der Zeilen oder -1, wenn der Block ungültig ist
+ */
+int ulam_column_read_decode(ulam_column_reader *reader, int seeds[],
+                            int peaks[], int steps[]);
+
+/**
+ * Schließt einen Leser.
+ *
+ * @param reader    Leser
+ */
+void ulam_column_read_close(ulam_column_reader *reader);
+
+#endif /* ULAM_COLUMN_H */
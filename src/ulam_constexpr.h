@@ -0,0 +1,168 @@
+/**
+ * @file
+ * Dieses Modul stellt die ULAM-Funktionen als constexpr-Funktionen bereit.
+ * Für bekannte Startzahlen berechnet der Compiler die Werte beim Übersetzen,
+ * z.B. in static_assert() oder für Konstanten der Aufrufer. Die Vorlage
+ * #ulam_constexpr_table erzeugt außerdem beim Übersetzen eine Tabelle der
+ * maximalen ULAM-Werte aller Startzahlen unter 2^BITS, so dass ulam_max()
+ * für kleine Startzahlen nur einen Tabellenzugriff benötigt, ohne dass beim
+ * Programmstart etwas initialisiert werden muss (siehe auch die
+ * Sprungtabelle in ulam_jump.h).
+ *
+ * Die Funktionen haben keine Nebenwirkungen; ein Überlauf wird daher nicht
+ * in der Überlaufstatistik (ulam_overflow.h) vermerkt.
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+#ifndef ULAM_CONSTEXPR_H
+#define ULAM_CONSTEXPR_H
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <stdint.h>
+
+#include "ulam.h"
+
+
+/* ============================================================================
+ * Symbolische Konstanten
+ * ========================================================================= */
+
+#ifndef ULAM_CONSTEXPR_BITS
+/**
+ * ulam_max() schlägt die Maxima aller Startzahlen unter 2^BITS in einer beim
+ * Übersetzen erzeugten Tabelle nach. Die Tabelle belegt 2^BITS * 4 Byte; der
+ * Wert kann beim Übersetzen mit -DULAM_CONSTEXPR_BITS=... zwischen 1 und 16
+ * gewählt werden.
+ */
+#define ULAM_CONSTEXPR_BITS 16
+#endif
+
+
+/* ============================================================================
+ * Funktionsdefinitionen
+ * ========================================================================= */
+
+/**
+ * constexpr-Variante von ulam().
+ *
+ * @param an        positive ganze Zahl, zu der der nächste ULAM-Wert
+ *                  geliefert werden soll.
+ * @return          der nächste ULAM-Wert oder -1, wenn an <= 0 ist oder es
+ *                  zu einem Überlauf kommen würde
+ */
+constexpr int ulam_constexpr(int an)
+{
+    if (an < 1)
+    {
+        return -1;
+    }
+    if (an % 2 == 0)
+    {
+        return an / 2;
+    }
+    if (an >= ULAM_MAX)
+    {
+        return -1;
+    }
+
+    return 3 * an + 1;
+}
+
+/**
+ * constexpr-Variante von ulam_max(). Bei einem Überlauf endet die Folge wie
+ * bei ulam_max() mit dem bisherigen Maximum.
+ *
+ * @param a0        ganze Zahl, zu der der maximale ULAM-Wert geliefert
+ *                  werden soll.
+ * @return          der maximale ULAM-Wert zur übergebenen Zahl
+ *                  oder -1, wenn a0 < 1 ist
+ */
+constexpr int ulam_max_constexpr(int a0)
+{
+    int an = a0;
+    int max_value = a0;
+
+    if (a0 < 1)
+    {
+        return -1;
+    }
+
+    while (an > 1)
+    {
+        an = ulam_constexpr(an);
+        if (an < 0)
+        {
+            /* Überlauf */
+            break;
+        }
+        if (an > max_value)
+        {
+            max_value = an;
+        }
+    }
+
+    return max_value;
+}
+
+
+/* ============================================================================
+ * Typdefinitionen
+ * ========================================================================= */
+
+/**
+ * Tabelle der maximalen ULAM-Werte aller Startzahlen unter 2^BITS. Der
+ * Konstruktor ist constexpr, so dass die Tabelle beim Übersetzen erzeugt
+ * wird.
+ *
+ * Die Einträge werden aufsteigend berechnet: Jede Folge wird nur verfolgt,
+ * bis sie unter ihre Startzahl fällt, deren Maximum dann schon in der
+ * Tabelle steht. So bleibt der Aufwand beim Übersetzen klein. Für
+ * Startzahlen unter 2^16 liegen alle Folgenglieder unter #ULAM_MAX, es gibt
+ * also keinen Überlauf.
+ *
+ * @tparam BITS     Startzahlen a0 < 2^BITS sind enthalten
+ */
+template <int BITS>
+struct ulam_constexpr_table
+{
+    static_assert(BITS >= 1 && BITS <= 16,
+                  "ULAM_CONSTEXPR_BITS muss zwischen 1 und 16 liegen");
+
+    /** Anzahl der Einträge; peak[0] ist -1 wie ulam_max(0) */
+    static const int size = 1 << BITS;
+
+    int peak[1 << BITS];    /**< peak[a0] = ulam_max(a0) */
+
+    constexpr ulam_constexpr_table() : peak()
+    {
+        peak[0] = -1;
+        if (size > 1)
+        {
+            peak[1] = 1;
+        }
+
+        for (int a0 = 2; a0 < size; a0++)
+        {
+            int64_t an = a0;
+            int64_t max_value = a0;
+
+            while (an >= a0)
+            {
+                an = (an % 2 == 0) ? an / 2 : 3 * an + 1;
+                if (an > max_value)
+                {
+                    max_value = an;
+                }
+            }
+
+            peak[a0] = (peak[an] > max_value) ? peak[an] : (int) max_value;
+        }
+    }
+};
+
+#endif /* ULAM_CONSTEXPR_H */
@@ -0,0 +1,101 @@
+/**
+ * @file
+ * Dieses Modul implementiert die Aufzählung der Gruppen gleicher maximaler
+ * ULAM-Werte (siehe ulam_groups.h).
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <stddef.h>
+
+#include "ulam_range.h"
+#include "ulam_groups.h"
+
+
+/* ============================================================================
+ * Symbolische Konstanten
+ * ========================================================================= */
+
+/** Anzahl der Startzahlen, die je Block berechnet werden */
+#define ULAM_GROUPS_BLOCK 65536
+
+
+/* ============================================================================
+ * Funktionsdefinitionen
+ * ========================================================================= */
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_groups
+ * ------------------------------------------------------------------------- */
+long ulam_groups(int lo, int hi, int number, ulam_group_callback callback,
+                 void *arg)
+{
+    int block[ULAM_GROUPS_BLOCK];
+    long groups;        /* Anzahl der gemeldeten Gruppen */
+    int run_val;        /* maximaler ULAM-Wert des aktuellen Laufs */
+    int run_start;      /* erste Startzahl des aktuellen Laufs */
+    int block_lo;
+    int block_hi;
+    int i;
+
+    if (lo < 1 || hi < lo || number < 1 || callback == NULL)
+    {
+        return -1;
+    }
+
+    groups = 0;
+    run_val = 0;
+    run_start = lo;
+
+    for (block_lo = lo; ; block_lo = block_hi + 1)
+    {
+        block_hi = (hi - block_lo < ULAM_GROUPS_BLOCK - 1)
+                   ? hi : block_lo + ULAM_GROUPS_BLOCK - 1;
+        ulam_max_range(block_lo, block_hi, block);
+
+        if (block_lo == lo)
+        {
+            run_val = block[0];
+        }
+
+        for (i = 0; i <= block_hi - block_lo; i++)
+        {
+            if (block[i] == run_val)
+            {
+                continue;
+            }
+
+            /* Lauf endet vor block_lo + i */
+            if (block_lo + i - run_start >= number)
+            {
+                groups++;
+                if (callback(run_start, block_lo + i - run_start, run_val,
+                             arg) != 0)
+                {
+                    return groups;
+                }
+            }
+            run_val = block[i];
+            run_start = block_lo + i;
+        }
+
+        if (block_hi == hi)
+        {
+            break;
+        }
+    }
+
+    /* Letzter Lauf endet bei hi */
+    if (hi - run_start + 1 >= number)
+    {
+        groups++;
+        callback(run_start, hi - run_start + 1, run_val, arg);
+    }
+
+    return groups;
+}
@@ -0,0 +1,58 @@
+/**
+ * @file
+ * Dieses Modul zählt alle Gruppen benachbarter Startzahlen mit gleichem
+ * maximalen ULAM-Wert in einem beliebigen Intervall [lo, hi] auf. Statt wie
+ * ulam_twins() und ulam_multiples() nur die letzte Gruppe in [1, limit] zu
+ * liefern, wird für jede Gruppe mit mindestens number Gliedern eine
+ * Callback-Funktion aufgerufen. Das Intervall wird dazu in einem einzigen
+ * Durchlauf blockweise mit ulam_max_range() berechnet; pro Gruppe wird kein
+ * Speicher angelegt.
+ *
+ * Eine Gruppe ist ein maximaler Lauf gleicher Maxima innerhalb von [lo, hi],
+ * d.h. Läufe, die über die Intervallgrenzen hinausreichen, werden dort
+ * abgeschnitten.
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+#ifndef ULAM_GROUPS_H
+#define ULAM_GROUPS_H
+
+/* ============================================================================
+ * Typdefinitionen
+ * ========================================================================= */
+
+/**
+ * Callback-Funktion, die für jede gefundene Gruppe aufgerufen wird. Die
+ * Gruppen werden in aufsteigender Reihenfolge gemeldet.
+ *
+ * @param start     kleinste Startzahl der Gruppe
+ * @param len       Anzahl der Startzahlen in der Gruppe
+ * @param peak      gemeinsamer maximaler ULAM-Wert (wie ulam_max())
+ * @param arg       Argument, das an ulam_groups() übergeben wurde
+ * @return          0, um fortzufahren, sonst wird die Aufzählung beendet
+ */
+typedef int (*ulam_group_callback)(int start, int len, int peak, void *arg);
+
+
+/* ============================================================================
+ * Funktions-Prototypen
+ * ========================================================================= */
+
+/**
+ * Ruft für jede Gruppe gleicher Maxima in [lo, hi] mit mindestens number
+ * Gliedern die Funktion callback auf.
+ *
+ * @param lo        kleinste Startzahl des Intervalls (>= 1)
+ * @param hi        größte Startzahl des Intervalls (>= lo)
+ * @param number    Mindestgröße der gemeldeten Gruppen (>= 1)
+ * @param callback  Funktion, die für jede Gruppe aufgerufen wird
+ * @param arg       beliebiges Argument für callback
+ * @return          die Anzahl der gemeldeten Gruppen oder -1, wenn die
+ *                  Parameter ungültig sind
+ */
+long ulam_groups(int lo, int hi, int number, ulam_group_callback callback,
+                 void *arg);
+
+#endif /* ULAM_GROUPS_H */
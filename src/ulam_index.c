@@ -0,0 +1,297 @@
+/**
+ * @file
+ * Dieses Modul implementiert die vorberechnete Indexdatei für maximale
+ * ULAM-Werte (siehe ulam_index.h).
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "ulam_index.h"
+#include "ulam_range.h"
+#include "ulam_sieve.h"
+
+
+/* ============================================================================
+ * Symbolische Konstanten
+ * ========================================================================= */
+
+/** Anzahl der Startzahlen, die beim Erzeugen je Block berechnet werden */
+#define ULAM_INDEX_BLOCK 65536
+
+/** Startwert der FNV-1a-Prüfsumme */
+#define ULAM_INDEX_FNV_OFFSET 14695981039346656037ULL
+
+/** Multiplikator der FNV-1a-Prüfsumme */
+#define ULAM_INDEX_FNV_PRIME 1099511628211ULL
+
+
+/* ============================================================================
+ * Globale Variablen
+ * ========================================================================= */
+
+/** eingeblendete Datei oder NULL, wenn kein Index geöffnet ist */
+static void *ulam_index_map = NULL;
+
+/** Größe der eingeblendeten Datei in Byte */
+static size_t ulam_index_map_size = 0;
+
+/** Werte des Index (hinter dem Kopf) */
+static const int32_t *ulam_index_values32 = NULL;
+static const int64_t *ulam_index_values64 = NULL;
+
+/** Intervall des Index; leer, solange kein Index geöffnet ist */
+static int ulam_index_lo = 1;
+static int ulam_index_hi = 0;
+
+
+/* ============================================================================
+ * Prototypen der privaten Funktionen
+ * ========================================================================= */
+
+/**
+ * Setzt eine FNV-1a-Prüfsumme über weitere Bytes fort.
+ *
+ * @param hash      bisherige Prüfsumme
+ * @param data      Daten
+ * @param size      Anzahl der Bytes
+ * @return          die neue Prüfsumme
+ */
+static uint64_t ulam_index_fnv(uint64_t hash, const void *data, size_t size);
+
+
+/* ============================================================================
+ * Funktionsdefinitionen
+ * ========================================================================= */
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_index_build
+ * ------------------------------------------------------------------------- */
+int ulam_index_build(const char *path, int lo, int hi, int width)
+{
+    ulam_index_header header;
+    int32_t block32[ULAM_INDEX_BLOCK];
+    int64_t *peaks = NULL;
+    FILE *file;
+    int block_lo;
+    int block_hi;
+    int ok;
+
+    if (path == NULL || lo < 1 || hi < lo || (width != 32 && width != 64))
+    {
+        return -1;
+    }
+
+    /* 64-Bit-Werte kommen aus der Sieb-Tabelle aller Startzahlen bis hi */
+    if (width == 64)
+    {
+        peaks = (int64_t *) malloc(((size_t) hi + 1) * sizeof(int64_t));
+        if (peaks == NULL || ulam_peak_table(hi, peaks) != 0)
+        {
+            free(peaks);
+            return -1;
+        }
+    }
+
+    file = fopen(path, "wb");
+    if (file == NULL)
+    {
+        free(peaks);
+        return -1;
+    }
+
+    /* Der Kopf wird mit der Prüfsumme am Ende noch einmal geschrieben */
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, ULAM_INDEX_MAGIC, sizeof(ULAM_INDEX_MAGIC));
+    header.version = ULAM_INDEX_VERSION;
+    header.width = (uint32_t) width;
+    header.lo = lo;
+    header.hi = hi;
+    header.checksum = ULAM_INDEX_FNV_OFFSET;
+    ok = fwrite(&header, sizeof(header), 1, file) == 1;
+
+    if (width == 64)
+    {
+        header.checksum = ulam_index_fnv(header.checksum, peaks + lo,
+                                         ((size_t) hi - lo + 1) 
+                                         * sizeof(int64_t));
+        ok = ok && fwrite(peaks + lo, sizeof(int64_t), 
+                          (size_t) hi - lo + 1, file) 
+                   == (size_t) hi - lo + 1;
+    }
+    else
+    {
+        /* 32-Bit-Werte blockweise mit ulam_max_range() berechnen */
+        for (block_lo = lo; ok && block_lo <= hi; block_lo = block_hi + 1)
+        {
+            block_hi = (hi - block_lo < ULAM_INDEX_BLOCK - 1)
+                       ? hi : block_lo + ULAM_INDEX_BLOCK - 1;
+            ulam_max_range(block_lo, block_hi, block32);
+            header.checksum = ulam_index_fnv(header.checksum, block32,
+                                             ((size_t) block_hi - block_lo 
+                                              + 1) * sizeof(int32_t));
+            ok = fwrite(block32, sizeof(int32_t), 
+                        (size_t) block_hi - block_lo + 1, file) 
+                 == (size_t) block_hi - block_lo + 1;
+            if (block_hi == hi)
+            {
+                break;
+            }
+        }
+    }
+    free(peaks);
+
+    ok = ok && fseek(file, 0, SEEK_SET) == 0
+            && fwrite(&header, sizeof(header), 1, file) == 1;
+    if (fclose(file) != 0 || !ok)
+    {
+        remove(path);
+        return -1;
+    }
+
+    return 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_index_open
+ * ------------------------------------------------------------------------- */
+int ulam_index_open(const char *path, int verify)
+{
+    const ulam_index_header *header;
+    struct stat info;
+    void *map;
+    size_t count;
+    int fd;
+
+    ulam_index_close();
+
+    if (path == NULL)
+    {
+        return -1;
+    }
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return -1;
+    }
+    if (fstat(fd, &info) != 0 
+        || (size_t) info.st_size < sizeof(ulam_index_header))
+    {
+        close(fd);
+        return -1;
+    }
+
+    map = mmap(NULL, (size_t) info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        return -1;
+    }
+
+    /* Kopf und Größe prüfen */
+    header = (const ulam_index_header *) map;
+    count = (size_t) header->hi - header->lo + 1;
+    if (memcmp(header->magic, ULAM_INDEX_MAGIC, sizeof(ULAM_INDEX_MAGIC)) != 0
+        || header->version != ULAM_INDEX_VERSION
+        || (header->width != 32 && header->width != 64)
+        || header->lo < 1 || header->hi < header->lo
+        || (size_t) info.st_size 
+           != sizeof(ulam_index_header) + count * (header->width / 8)
+        || (verify && ulam_index_fnv(ULAM_INDEX_FNV_OFFSET, header + 1,
+                                     count * (header->width / 8)) 
+                      != header->checksum))
+    {
+        munmap(map, (size_t) info.st_size);
+        return -1;
+    }
+
+    /* Zugriffe erfolgen verstreut, ein Vorauslesen lohnt sich nicht */
+    madvise(map, (size_t) info.st_size, MADV_RANDOM);
+
+    ulam_index_map = map;
+    ulam_index_map_size = (size_t) info.st_size;
+    if (header->width == 32)
+    {
+        ulam_index_values32 = (const int32_t *) (header + 1);
+    }
+    else
+    {
+        ulam_index_values64 = (const int64_t *) (header + 1);
+    }
+    ulam_index_lo = header->lo;
+    ulam_index_hi = header->hi;
+
+    return 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_index_close
+ * ------------------------------------------------------------------------- */
+void ulam_index_close(void)
+{
+    if (ulam_index_map != NULL)
+    {
+        munmap(ulam_index_map, ulam_index_map_size);
+    }
+
+    ulam_index_map = NULL;
+    ulam_index_map_size = 0;
+    ulam_index_values32 = NULL;
+    ulam_index_values64 = NULL;
+    ulam_index_lo = 1;
+    ulam_index_hi = 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_index_lookup
+ * ------------------------------------------------------------------------- */
+int ulam_index_lookup(int a0)
+{
+    int64_t peak;
+
+    if (a0 < ulam_index_lo || a0 > ulam_index_hi)
+    {
+        return 0;
+    }
+
+    if (ulam_index_values32 != NULL)
+    {
+        return ulam_index_values32[a0 - ulam_index_lo];
+    }
+
+    /* 64-Bit-Maxima oberhalb von INT_MAX würden bei ulam_max() überlaufen */
+    peak = ulam_index_values64[a0 - ulam_index_lo];
+    return (peak <= INT_MAX) ? (int) peak : 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_index_fnv
+ * ------------------------------------------------------------------------- */
+static uint64_t ulam_index_fnv(uint64_t hash, const void *data, size_t size)
+{
+    const unsigned char *bytes = (const unsigned char *) data;
+    size_t i;
+
+    for (i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= ULAM_INDEX_FNV_PRIME;
+    }
+
+    return hash;
+}
@@ -0,0 +1,110 @@
+/**
+ * @file
+ * Dieses Modul verwaltet eine vorberechnete Indexdatei mit den maximalen
+ * ULAM-Werten eines Intervalls [lo, hi] von Startzahlen. Die Datei besteht
+ * aus einem Kopf (#ulam_index_header) und den dicht gepackten Maxima aller
+ * Startzahlen des Intervalls mit 32 oder 64 Bit je Wert. Sie wird mit
+ * ulam_index_build() bzw. dem Programm ulam_index_build erzeugt und mit
+ * ulam_index_open() per mmap eingeblendet, so dass ulam_max() für alle
+ * Startzahlen des Intervalls den Wert direkt aus dem Seitencache liest.
+ *
+ * Mit 32 Bit werden genau die Werte von ulam_max() einschließlich des
+ * Verhaltens bei Überlauf gespeichert. Mit 64 Bit werden die tatsächlichen
+ * Maxima gespeichert; ulam_max() nutzt diese nur, wenn sie im int-Bereich
+ * liegen, und rechnet sonst wie bisher.
+ *
+ * Die Datei wird in der Byte-Reihenfolge des erzeugenden Rechners
+ * geschrieben. Öffnen und Schließen des Index dürfen nicht gleichzeitig mit
+ * Aufrufen von ulam_max() erfolgen.
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+#ifndef ULAM_INDEX_H
+#define ULAM_INDEX_H
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <stdint.h>
+
+
+/* ============================================================================
+ * Symbolische Konstanten
+ * ========================================================================= */
+
+/** Kennung am Anfang jeder Indexdatei */
+#define ULAM_INDEX_MAGIC "ULAMIDX"
+
+/** Version des Dateiformats */
+#define ULAM_INDEX_VERSION 1
+
+
+/* ============================================================================
+ * Typdefinitionen
+ * ========================================================================= */
+
+/**
+ * Kopf einer Indexdatei. Er ist 64 Byte groß, die Werte folgen direkt
+ * danach.
+ */
+typedef struct
+{
+    char magic[8];          /**< #ULAM_INDEX_MAGIC mit abschließender 0 */
+    uint32_t version;       /**< #ULAM_INDEX_VERSION */
+    uint32_t width;         /**< Bits je Wert: 32 oder 64 */
+    int32_t lo;             /**< kleinste Startzahl im Index */
+    int32_t hi;             /**< größte Startzahl im Index */
+    uint64_t checksum;      /**< FNV-1a-Prüfsumme (64 Bit) über die Werte */
+    uint8_t reserved[32];   /**< reserviert, mit 0 gefüllt */
+} ulam_index_header;
+
+
+/* ============================================================================
+ * Funktions-Prototypen
+ * ========================================================================= */
+
+/**
+ * Berechnet die maximalen ULAM-Werte aller Startzahlen von lo bis hi und
+ * schreibt sie als Indexdatei. Für width = 64 wird eine Tabelle aller
+ * Maxima von 0 bis hi aufgebaut (siehe ulam_peak_table()).
+ *
+ * @param path      Name der zu schreibenden Datei
+ * @param lo        kleinste Startzahl (>= 1)
+ * @param hi        größte Startzahl (>= lo)
+ * @param width     Bits je Wert: 32 oder 64
+ * @return          0, wenn die Datei geschrieben wurde, sonst -1
+ */
+int ulam_index_build(const char *path, int lo, int hi, int width);
+
+/**
+ * Blendet eine Indexdatei ein. Ein bereits geöffneter Index wird vorher
+ * geschlossen. Kopf und Dateigröße werden immer geprüft, die Prüfsumme nur
+ * auf Wunsch, da sie alle Seiten der Datei liest.
+ *
+ * @param path      Name der Indexdatei
+ * @param verify    1, wenn die Prüfsumme geprüft werden soll, sonst 0
+ * @return          0, wenn der Index geöffnet wurde, oder -1, wenn die Datei
+ *                  nicht gelesen werden kann oder ungültig ist
+ */
+int ulam_index_open(const char *path, int verify);
+
+/**
+ * Schließt den geöffneten Index. ulam_max() rechnet danach wieder für alle
+ * Startzahlen.
+ */
+void ulam_index_close(void);
+
+/**
+ * Liefert ulam_max(a0) aus dem geöffneten Index.
+ *
+ * @param a0        Startzahl
+ * @return          der maximale ULAM-Wert oder 0, wenn kein Index geöffnet
+ *                  ist, a0 außerhalb des Index liegt oder der gespeicherte
+ *                  Wert nicht im int-Bereich liegt
+ */
+int ulam_index_lookup(int a0);
+
+#endif /* ULAM_INDEX_H */
@@ -0,0 +1,63 @@
+/**
+ * @file
+ * Programm zum Erzeugen einer Indexdatei mit vorberechneten maximalen
+ * ULAM-Werten (siehe ulam_index.h).
+ *
+ * Aufruf: ulam_index_build datei lo hi [32|64]
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ulam_index.h"
+
+
+/* ============================================================================
+ * Funktionsdefinitionen
+ * ========================================================================= */
+
+/* ----------------------------------------------------------------------------
+ * Funktion: main
+ * ------------------------------------------------------------------------- */
+int main(int argc, char **argv)
+{
+    int lo;
+    int hi;
+    int width;
+
+    if (argc < 4 || argc > 5)
+    {
+        fprintf(stderr, "Aufruf: %s datei lo hi [32|64]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    lo = atoi(argv[2]);
+    hi = atoi(argv[3]);
+    width = (argc == 5) ? atoi(argv[4]) : 32;
+
+    if (ulam_index_build(argv[1], lo, hi, width) != 0)
+    {
+        fprintf(stderr, "Index %s [%d, %d] mit %d Bit konnte nicht "
+                "erzeugt werden\n", argv[1], lo, hi, width);
+        return EXIT_FAILURE;
+    }
+
+    /* Geschriebene Datei einschließlich Prüfsumme kontrollieren */
+    if (ulam_index_open(argv[1], 1) != 0)
+    {
+        fprintf(stderr, "Index %s ist ungueltig\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+    ulam_index_close();
+
+    printf("Index %s [%d, %d] mit %d Bit erzeugt\n", argv[1], lo, hi, width);
+
+    return EXIT_SUCCESS;
+}
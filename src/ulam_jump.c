@@ -0,0 +1,93 @@
+/**
+ * @file
+ * Dieses Modul implementiert den blockweisen Kernel für ulam_max() (siehe
+ * ulam_jump.h).
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <stdint.h>
+
+#include "ulam.h"
+#include "ulam_jump.h"
+#include "ulam_overflow.h"
+
+
+/* ============================================================================
+ * Globale Variablen
+ * ========================================================================= */
+
+/** Sprungtabelle, vom Compiler erzeugt */
+static constexpr ulam_jump_table<ULAM_JUMP_K> ulam_jump;
+
+
+/* ============================================================================
+ * Funktionsdefinitionen
+ * ========================================================================= */
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_max_jump
+ * ------------------------------------------------------------------------- */
+int ulam_max_jump(int a0)
+{
+    const uint64_t mask = ((uint64_t) 1 << ULAM_JUMP_K) - 1;
+    uint64_t an;        /* aktuelles Folgenglied */
+    uint64_t max_value; /* max. ULAM-Wert in der Folge von a0 bis an */
+    uint64_t h;
+    uint64_t l;
+
+    if (a0 < 1)
+    {
+        return -1;
+    }
+
+    an = (uint64_t) a0;
+    max_value = an;
+
+    for (;;)
+    {
+        /* Alle geraden Schritte auf einmal, sie ändern das Maximum nicht */
+        an >>= __builtin_ctzll(an);
+        if (an == 1)
+        {
+            break;
+        }
+
+        /*
+         * Kann der nächste Block kein neues Maximum enthalten, wird er
+         * übersprungen. Da alle Blockwerte dann unter dem bisherigen Maximum
+         * liegen, kann in ihm auch kein Überlauf auftreten. Ab an >= 2^K
+         * erreicht die Folge innerhalb des Blocks nicht den Wert 1.
+         */
+        h = an >> ULAM_JUMP_K;
+        if (h > 0)
+        {
+            l = an & mask;
+            if (ulam_jump.peak_a[l] * h + ulam_jump.peak_b[l] <= max_value)
+            {
+                an = ulam_jump.mult[l] * h + ulam_jump.add[l];
+                continue;
+            }
+        }
+
+        /* Einzelner ungerader Schritt wie in ulam() */
+        if (an >= ULAM_MAX)
+        {
+            /* Überlauf: die Folge endet wie bei ulam_max() */
+            ulam_overflow_record(a0, (int) an);
+            break;
+        }
+        an = 3 * an + 1;
+        if (an > max_value)
+        {
+            max_value = an;
+        }
+    }
+
+    return (int) max_value;
+}
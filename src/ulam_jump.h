@@ -0,0 +1,125 @@
+/**
+ * @file
+ * Dieses Modul implementiert einen schnellen Kernel für ulam_max(), der die
+ * ULAM-Folge blockweise berechnet. Gerade Schritte werden mit einem
+ * Count-Trailing-Zeros auf einmal entfernt. Für eine ungerade Zahl
+ * n = 2^K * h + l legen die K niedrigsten Bits l die Paritäten der nächsten
+ * K Schritte der verkürzten Abbildung T(n) = n / 2 bzw. (3 * n + 1) / 2
+ * fest, so dass T^K(n) = mult[l] * h + add[l] gilt. Die Tabelle enthält
+ * zusätzlich eine obere Schranke peak_a[l] * h + peak_b[l] für alle Werte
+ * innerhalb des Blocks. Nur wenn diese Schranke ein neues Maximum zulässt,
+ * wird der Block Schritt für Schritt berechnet.
+ *
+ * Die Tabellenbreite K wird beim Übersetzen über #ULAM_JUMP_K festgelegt,
+ * die Tabelle selbst wird vom Compiler per constexpr erzeugt.
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+#ifndef ULAM_JUMP_H
+#define ULAM_JUMP_H
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <stdint.h>
+
+
+/* ============================================================================
+ * Symbolische Konstanten
+ * ========================================================================= */
+
+#ifndef ULAM_JUMP_K
+/**
+ * Anzahl der Bits bzw. Schritte, die ein Tabelleneintrag zusammenfasst. Die
+ * Tabelle hat 2^K Einträge zu je 32 Byte; der Wert kann beim Übersetzen mit
+ * -DULAM_JUMP_K=... zwischen 1 und 14 gewählt werden.
+ */
+#define ULAM_JUMP_K 10
+#endif
+
+
+/* ============================================================================
+ * Typdefinitionen
+ * ========================================================================= */
+
+/**
+ * Sprungtabelle für K Schritte der verkürzten ULAM-Abbildung. Der
+ * Konstruktor ist constexpr, so dass die Tabelle beim Übersetzen erzeugt
+ * wird.
+ *
+ * @tparam K        Anzahl der Bits bzw. Schritte je Block
+ */
+template <int K>
+struct ulam_jump_table
+{
+    static_assert(K >= 1 && K <= 14, "ULAM_JUMP_K muss zwischen 1 und 14 liegen");
+
+    /** Anzahl der Einträge */
+    static const int size = 1 << K;
+
+    uint64_t mult[1 << K];      /**< Faktor 3^c für h nach K Schritten */
+    uint64_t add[1 << K];       /**< Summand T^K(l) nach K Schritten */
+    uint64_t peak_a[1 << K];    /**< Faktor der Schranke für die Blockwerte */
+    uint64_t peak_b[1 << K];    /**< Summand der Schranke für die Blockwerte */
+
+    constexpr ulam_jump_table() : mult(), add(), peak_a(), peak_b()
+    {
+        for (int l = 0; l < size; l++)
+        {
+            /* x = T^j(l), coeff = Faktor von h in T^j(2^K * h + l) */
+            uint64_t x = (uint64_t) l;
+            uint64_t coeff = (uint64_t) 1 << K;
+            uint64_t a = 0;
+            uint64_t b = 0;
+
+            for (int j = 0; j < K; j++)
+            {
+                if (x % 2 == 1)
+                {
+                    /* Größter Wert eines ungeraden Schritts ist 3 * x + 1 */
+                    if (3 * coeff > a)
+                    {
+                        a = 3 * coeff;
+                    }
+                    if (3 * x + 1 > b)
+                    {
+                        b = 3 * x + 1;
+                    }
+                    x = (3 * x + 1) / 2;
+                    coeff = coeff / 2 * 3;
+                }
+                else
+                {
+                    x = x / 2;
+                    coeff = coeff / 2;
+                }
+            }
+
+            mult[l] = coeff;
+            add[l] = x;
+            peak_a[l] = a;
+            peak_b[l] = b;
+        }
+    }
+};
+
+
+/* ============================================================================
+ * Funktions-Prototypen
+ * ========================================================================= */
+
+/**
+ * Liefert denselben Wert wie ulam_max(a0), berechnet die Folge aber
+ * blockweise mit der Sprungtabelle.
+ *
+ * @param a0        ganze Zahl, zu der der maximale ULAM-Wert geliefert
+ *                  werden soll.
+ * @return          der maximale ULAM-Wert zur übergebenen Zahl
+ *                  oder -1, wenn a0 < 1 ist
+ */
+int ulam_max_jump(int a0);
+
+#endif /* ULAM_JUMP_H */
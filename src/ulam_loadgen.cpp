@@ -0,0 +1,438 @@
+/**
+ * @file
+ * Lastgenerator für den Server-Betrieb des Programms ulam (siehe
+ * ulam_server.h). Mehrere Clients verbinden sich mit dem Unix-Domain-Socket
+ * und senden zufällige Anfragen. Jeder Client schickt ein Fenster von
+ * Anfragen, ohne auf die Antworten zu warten, und liest dann alle Antworten
+ * des Fensters. Gemessen wird die Zeit vom Senden einer Anfrage bis zum
+ * Empfang ihrer Antwort. Am Ende werden Durchsatz, Perzentile der
+ * Antwortzeit und die Statistik des Servers ausgegeben.
+ *
+ * Aufruf: ulam_loadgen socket [-c clients] [-n anfragen] [-w fenster]
+ *                             [-m max_startzahl]
+ *
+ * <ul>
+ *   <li> -c   Anzahl der gleichzeitigen Clients (Threads)
+ *   <li> -n   Anzahl der Anfragen je Client
+ *   <li> -w   Anzahl der Anfragen, die ein Client auf einmal sendet
+ *   <li> -m   größte Startzahl; kleine Werte erhöhen die Trefferquote des
+ *             LRU-Caches
+ * </ul>
+ *
+ * Die Anfragen sind zu 90 % max-Anfragen und zu je 5 % twins- und
+ * multiples-Anfragen.
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+
+/* ============================================================================
+ * Symbolische Konstanten
+ * ========================================================================= */
+
+/** maximale Anzahl der Clients */
+#define ULAM_LOADGEN_MAX_CLIENTS 256
+
+/** maximale Anzahl der Anfragen je Fenster */
+#define ULAM_LOADGEN_MAX_WINDOW 4096
+
+/** Länge einer Anfrage- bzw. Antwortzeile höchstens */
+#define ULAM_LOADGEN_LINE 64
+
+
+/* ============================================================================
+ * Typdefinitionen
+ * ========================================================================= */
+
+/**
+ * Auftrag und Ergebnis eines Clients.
+ */
+typedef struct
+{
+    const char *path;       /**< Pfad des Sockets */
+    int requests;           /**< zu sendende Anfragen */
+    int window;             /**< Anfragen je Fenster */
+    int max_seed;           /**< größte Startzahl */
+    unsigned int seed;      /**< Startwert des Zufallsgenerators */
+    int64_t *latencies;     /**< Antwortzeiten in ns */
+    int answered;           /**< empfangene Antworten */
+    int errors;             /**< Antworten "error" */
+} ulam_loadgen_client;
+
+
+/* ============================================================================
+ * Prototypen der privaten Funktionen
+ * ========================================================================= */
+
+/**
+ * Thread-Funktion eines Clients.
+ *
+ * @param arg       Zeiger auf den ulam_loadgen_client
+ * @return          NULL
+ */
+static void *ulam_loadgen_run(void *arg);
+
+/**
+ * Verbindet sich mit dem Socket.
+ *
+ * @param path      Pfad des Sockets
+ * @return          Dateideskriptor oder -1
+ */
+static int ulam_loadgen_connect(const char *path);
+
+/**
+ * Schreibt eine Anfrage in buffer.
+ *
+ * @return          Länge der Anfrage
+ */
+static int ulam_loadgen_query(char *buffer, unsigned int *seed, int max_seed);
+
+/**
+ * Schreibt len Bytes vollständig.
+ *
+ * @return          0 oder -1 bei Fehler
+ */
+static int ulam_loadgen_write(int fd, const char *buffer, size_t len);
+
+/**
+ * Vergleichsfunktion für qsort() über Antwortzeiten.
+ */
+static int ulam_loadgen_compare(const void *a, const void *b);
+
+/**
+ * Liefert die aktuelle Zeit in ns (monoton).
+ */
+static int64_t ulam_loadgen_now(void);
+
+
+/* ============================================================================
+ * Funktionsdefinitionen
+ * ========================================================================= */
+
+/* ----------------------------------------------------------------------------
+ * Funktion: main
+ * ------------------------------------------------------------------------- */
+int main(int argc, char **argv)
+{
+    static ulam_loadgen_client clients[ULAM_LOADGEN_MAX_CLIENTS];
+    static pthread_t threads[ULAM_LOADGEN_MAX_CLIENTS];
+    const char *path = NULL;
+    char line[512];
+    int64_t *latencies;
+    int64_t start;
+    double seconds;
+    size_t count;
+    ssize_t n;
+    int client_count = 4;
+    int requests = 100000;
+    int window = 64;
+    int max_seed = 1000000;
+    int errors;
+    int fd;
+    int c;
+    int i;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+        {
+            client_count = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+        {
+            requests = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc)
+        {
+            window = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+        {
+            max_seed = atoi(argv[++i]);
+        }
+        else if (argv[i][0] != '-' && path == NULL)
+        {
+            path = argv[i];
+        }
+        else
+        {
+            path = NULL;
+            break;
+        }
+    }
+    if (path == NULL || client_count < 1 
+        || client_count > ULAM_LOADGEN_MAX_CLIENTS || requests < 1
+        || window < 1 || window > ULAM_LOADGEN_MAX_WINDOW || max_seed < 2)
+    {
+        fprintf(stderr, "Aufruf: %s socket [-c clients] [-n anfragen] "
+                "[-w fenster] [-m max_startzahl]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    latencies = (int64_t *) malloc((size_t) client_count * requests 
+                                   * sizeof(int64_t));
+    if (latencies == NULL)
+    {
+        fprintf(stderr, "Nicht genuegend Speicher\n");
+        return EXIT_FAILURE;
+    }
+
+    start = ulam_loadgen_now();
+    for (c = 0; c < client_count; c++)
+    {
+        clients[c].path = path;
+        clients[c].requests = requests;
+        clients[c].window = window;
+        clients[c].max_seed = max_seed;
+        clients[c].seed = 12345u + 7919u * (unsigned int) c;
+        clients[c].latencies = latencies + (size_t) c * requests;
+        clients[c].answered = 0;
+        clients[c].errors = 0;
+        pthread_create(&threads[c], NULL, ulam_loadgen_run, &clients[c]);
+    }
+
+    count = 0;
+    errors = 0;
+    for (c = 0; c < client_count; c++)
+    {
+        pthread_join(threads[c], NULL);
+        /* Antwortzeiten lückenlos zusammenfassen */
+        memmove(latencies + count, clients[c].latencies,
+                (size_t) clients[c].answered * sizeof(int64_t));
+        count += (size_t) clients[c].answered;
+        errors += clients[c].errors;
+    }
+    seconds = (ulam_loadgen_now() - start) * 1e-9;
+
+    if (count == 0)
+    {
+        fprintf(stderr, "Keine Antworten von %s\n", path);
+        free(latencies);
+        return EXIT_FAILURE;
+    }
+
+    qsort(latencies, count, sizeof(int64_t), ulam_loadgen_compare);
+    printf("%zu Antworten (%d Fehler) in %.3f s (%.0f Anfragen/s)\n",
+           count, errors, seconds, count / seconds);
+    printf("Antwortzeit [us]: p50 %.2f  p90 %.2f  p99 %.2f  max %.2f\n",
+           latencies[count * 50 / 100] / 1000.0,
+           latencies[count * 90 / 100] / 1000.0,
+           latencies[count * 99 / 100] / 1000.0,
+           latencies[count - 1] / 1000.0);
+
+    /* Statistik des Servers */
+    fd = ulam_loadgen_connect(path);
+    if (fd >= 0 && ulam_loadgen_write(fd, "stats\n", 6) == 0)
+    {
+        n = read(fd, line, sizeof(line) - 1);
+        if (n > 0)
+        {
+            line[n] = '\0';
+            printf("Server: %s", line);
+        }
+    }
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+
+    free(latencies);
+
+    return EXIT_SUCCESS;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_loadgen_run
+ * ------------------------------------------------------------------------- */
+static void *ulam_loadgen_run(void *arg)
+{
+    ulam_loadgen_client *client = (ulam_loadgen_client *) arg;
+    char out[ULAM_LOADGEN_MAX_WINDOW * ULAM_LOADGEN_LINE];
+    char in[ULAM_LOADGEN_MAX_WINDOW * ULAM_LOADGEN_LINE];
+    int64_t sent;
+    int64_t now;
+    size_t out_len;
+    size_t in_len;
+    size_t pos;
+    char *newline;
+    ssize_t n;
+    int pending;
+    int window;
+    int fd;
+    int i;
+
+    fd = ulam_loadgen_connect(client->path);
+    if (fd < 0)
+    {
+        return NULL;
+    }
+
+    while (client->answered < client->requests)
+    {
+        window = client->requests - client->answered;
+        if (window > client->window)
+        {
+            window = client->window;
+        }
+
+        /* Fenster von Anfragen auf einmal senden */
+        out_len = 0;
+        for (i = 0; i < window; i++)
+        {
+            out_len += (size_t) ulam_loadgen_query(out + out_len, 
+                                                   &client->seed,
+                                                   client->max_seed);
+        }
+        sent = ulam_loadgen_now();
+        if (ulam_loadgen_write(fd, out, out_len) != 0)
+        {
+            break;
+        }
+
+        /* Antworten des Fensters lesen */
+        pending = window;
+        in_len = 0;
+        while (pending > 0)
+        {
+            n = read(fd, in + in_len, sizeof(in) - in_len);
+            if (n <= 0)
+            {
+                close(fd);
+                return NULL;
+            }
+            in_len += (size_t) n;
+            now = ulam_loadgen_now();
+
+            pos = 0;
+            while (pending > 0
+                   && (newline = (char *) memchr(in + pos, '\n', 
+                                                 in_len - pos)) != NULL)
+            {
+                if (in[pos] == 'e')
+                {
+                    client->errors++;
+                }
+                client->latencies[client->answered++] = now - sent;
+                pending--;
+                pos = (size_t) (newline - in) + 1;
+            }
+            memmove(in, in + pos, in_len - pos);
+            in_len -= pos;
+        }
+    }
+
+    close(fd);
+
+    return NULL;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_loadgen_connect
+ * ------------------------------------------------------------------------- */
+static int ulam_loadgen_connect(const char *path)
+{
+    struct sockaddr_un addr;
+    int fd;
+
+    if (strlen(path) >= sizeof(addr.sun_path))
+    {
+        return -1;
+    }
+
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+    if (connect(fd, (struct sockaddr *) &addr, sizeof(addr)) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_loadgen_query
+ * ------------------------------------------------------------------------- */
+static int ulam_loadgen_query(char *buffer, unsigned int *seed, int max_seed)
+{
+    int kind = rand_r(seed) % 100;
+    int a0 = 1 + rand_r(seed) % max_seed;
+
+    if (kind < 90)
+    {
+        return snprintf(buffer, ULAM_LOADGEN_LINE, "max %d\n", a0);
+    }
+    if (kind < 95)
+    {
+        return snprintf(buffer, ULAM_LOADGEN_LINE, "twins %d\n", a0);
+    }
+
+    return snprintf(buffer, ULAM_LOADGEN_LINE, "multiples %d 3\n", 
+                    a0 < 3 ? 3 : a0);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_loadgen_write
+ * ------------------------------------------------------------------------- */
+static int ulam_loadgen_write(int fd, const char *buffer, size_t len)
+{
+    size_t written = 0;
+    ssize_t n;
+
+    while (written < len)
+    {
+        n = write(fd, buffer + written, len - written);
+        if (n <= 0)
+        {
+            return -1;
+        }
+        written += (size_t) n;
+    }
+
+    return 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_loadgen_compare
+ * ------------------------------------------------------------------------- */
+static int ulam_loadgen_compare(const void *a, const void *b)
+{
+    int64_t x = *(const int64_t *) a;
+    int64_t y = *(const int64_t *) b;
+
+    return (x > y) - (x < y);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_loadgen_now
+ * ------------------------------------------------------------------------- */
+static int64_t ulam_loadgen_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (int64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
@@ -0,0 +1,215 @@
+/**
+ * @file
+ * Dieses Modul implementiert den LRU-Cache für Antworten auf Anfragen
+ * (siehe ulam_lru.h).
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "ulam_lru.h"
+
+
+/* ============================================================================
+ * Prototypen der privaten Funktionen
+ * ========================================================================= */
+
+/**
+ * Liefert die Hash-Kette eines Schlüssels.
+ */
+static int ulam_lru_bucket(const ulam_lru *lru, uint64_t key);
+
+/**
+ * Entfernt einen Eintrag aus der Zugriffsliste.
+ */
+static void ulam_lru_unlink(ulam_lru *lru, int i);
+
+/**
+ * Hängt einen Eintrag als zuletzt benutzt vorn an die Zugriffsliste.
+ */
+static void ulam_lru_push_front(ulam_lru *lru, int i);
+
+
+/* ============================================================================
+ * Funktionsdefinitionen
+ * ========================================================================= */
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_lru_init
+ * ------------------------------------------------------------------------- */
+int ulam_lru_init(ulam_lru *lru, int capacity)
+{
+    int buckets = 1;
+
+    memset(lru, 0, sizeof(*lru));
+    if (capacity < 1)
+    {
+        return -1;
+    }
+
+    /* Mindestens doppelt so viele Ketten wie Einträge, als Zweierpotenz */
+    while (buckets < 2 * capacity)
+    {
+        buckets *= 2;
+    }
+
+    lru->entries = (ulam_lru_entry *) malloc((size_t) capacity 
+                                             * sizeof(ulam_lru_entry));
+    lru->buckets = (int *) malloc((size_t) buckets * sizeof(int));
+    if (lru->entries == NULL || lru->buckets == NULL)
+    {
+        ulam_lru_free(lru);
+        return -1;
+    }
+
+    memset(lru->buckets, 0xff, (size_t) buckets * sizeof(int));
+    lru->capacity = capacity;
+    lru->bucket_mask = buckets - 1;
+    lru->head = -1;
+    lru->tail = -1;
+
+    return 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_lru_free
+ * ------------------------------------------------------------------------- */
+void ulam_lru_free(ulam_lru *lru)
+{
+    free(lru->entries);
+    free(lru->buckets);
+    memset(lru, 0, sizeof(*lru));
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_lru_key
+ * ------------------------------------------------------------------------- */
+uint64_t ulam_lru_key(const ulam_query *query)
+{
+    /* 2 Bit Art, je 31 Bit für die Argumente */
+    return ((uint64_t) query->type << 62)
+           | (((uint64_t) (uint32_t) query->arg1 & 0x7fffffffu) << 31)
+           | ((uint64_t) (uint32_t) query->arg2 & 0x7fffffffu);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_lru_get
+ * ------------------------------------------------------------------------- */
+int ulam_lru_get(ulam_lru *lru, uint64_t key, int *value)
+{
+    int i;
+
+    for (i = lru->buckets[ulam_lru_bucket(lru, key)]; i >= 0;
+         i = lru->entries[i].chain)
+    {
+        if (lru->entries[i].key == key)
+        {
+            ulam_lru_unlink(lru, i);
+            ulam_lru_push_front(lru, i);
+            *value = lru->entries[i].value;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_lru_put
+ * ------------------------------------------------------------------------- */
+void ulam_lru_put(ulam_lru *lru, uint64_t key, int value)
+{
+    int *link;
+    int bucket;
+    int i;
+
+    if (ulam_lru_get(lru, key, &i))
+    {
+        lru->entries[lru->head].value = value;
+        return;
+    }
+
+    if (lru->count < lru->capacity)
+    {
+        i = lru->count++;
+    }
+    else
+    {
+        /* Am längsten nicht benutzten Eintrag aus Liste und Kette lösen */
+        i = lru->tail;
+        ulam_lru_unlink(lru, i);
+        link = &lru->buckets[ulam_lru_bucket(lru, lru->entries[i].key)];
+        while (*link != i)
+        {
+            link = &lru->entries[*link].chain;
+        }
+        *link = lru->entries[i].chain;
+    }
+
+    bucket = ulam_lru_bucket(lru, key);
+    lru->entries[i].key = key;
+    lru->entries[i].value = value;
+    lru->entries[i].chain = lru->buckets[bucket];
+    lru->buckets[bucket] = i;
+    ulam_lru_push_front(lru, i);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_lru_bucket
+ * ------------------------------------------------------------------------- */
+static int ulam_lru_bucket(const ulam_lru *lru, uint64_t key)
+{
+    /* Multiplikative Streuung (Fibonacci-Hashing) */
+    return (int) ((key * 0x9e3779b97f4a7c15ULL) >> 32) & lru->bucket_mask;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_lru_unlink
+ * ------------------------------------------------------------------------- */
+static void ulam_lru_unlink(ulam_lru *lru, int i)
+{
+    ulam_lru_entry *entry = &lru->entries[i];
+
+    if (entry->prev >= 0)
+    {
+        lru->entries[entry->prev].next = entry->next;
+    }
+    else
+    {
+        lru->head = entry->next;
+    }
+
+    if (entry->next >= 0)
+    {
+        lru->entries[entry->next].prev = entry->prev;
+    }
+    else
+    {
+        lru->tail = entry->prev;
+    }
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_lru_push_front
+ * ------------------------------------------------------------------------- */
+static void ulam_lru_push_front(ulam_lru *lru, int i)
+{
+    lru->entries[i].prev = -1;
+    lru->entries[i].next = lru->head;
+    if (lru->head >= 0)
+    {
+        lru->entries[lru->head].prev = i;
+    }
+    lru->head = i;
+    if (lru->tail < 0)
+    {
+        lru->tail = i;
+    }
+}
@@ -0,0 +1,109 @@
+/**
+ * @file
+ * Dieses Modul implementiert einen LRU-Cache für Antworten auf Anfragen
+ * (siehe ulam_query.h). Der Schlüssel fasst Art und Argumente einer Anfrage
+ * in 64 Bit zusammen. Die Einträge liegen in einem Feld fester Größe, sind
+ * über Hash-Ketten auffindbar und in einer doppelt verketteten Liste nach
+ * dem letzten Zugriff geordnet; ist der Cache voll, wird der am längsten
+ * nicht benutzte Eintrag ersetzt.
+ *
+ * Der Cache ist nicht threadsicher.
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+#ifndef ULAM_LRU_H
+#define ULAM_LRU_H
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <stdint.h>
+
+#include "ulam_query.h"
+
+
+/* ============================================================================
+ * Typdefinitionen
+ * ========================================================================= */
+
+/**
+ * Eintrag des LRU-Caches.
+ */
+typedef struct
+{
+    uint64_t key;       /**< Schlüssel der Anfrage */
+    int value;          /**< Ergebnis */
+    int prev;           /**< zuletzt vorher benutzter Eintrag oder -1 */
+    int next;           /**< danach benutzter Eintrag oder -1 */
+    int chain;          /**< nächster Eintrag derselben Hash-Kette oder -1 */
+} ulam_lru_entry;
+
+/**
+ * LRU-Cache.
+ */
+typedef struct
+{
+    ulam_lru_entry *entries;    /**< Einträge */
+    int *buckets;               /**< erster Eintrag je Hash-Kette oder -1 */
+    int capacity;               /**< maximale Anzahl der Einträge */
+    int count;                  /**< belegte Einträge */
+    int bucket_mask;            /**< Anzahl der Hash-Ketten - 1 */
+    int head;                   /**< zuletzt benutzter Eintrag oder -1 */
+    int tail;                   /**< am längsten nicht benutzter Eintrag */
+} ulam_lru;
+
+
+/* ============================================================================
+ * Funktions-Prototypen
+ * ========================================================================= */
+
+/**
+ * Legt einen LRU-Cache an.
+ *
+ * @param lru       zu initialisierender Cache
+ * @param capacity  maximale Anzahl der Einträge (>= 1)
+ * @return          0 oder -1, wenn nicht genügend Speicher vorhanden ist
+ */
+int ulam_lru_init(ulam_lru *lru, int capacity);
+
+/**
+ * Gibt den Speicher eines LRU-Caches frei.
+ *
+ * @param lru       Cache
+ */
+void ulam_lru_free(ulam_lru *lru);
+
+/**
+ * Liefert den Schlüssel einer gültigen Anfrage. Eindeutig ist er nur für
+ * nicht negative Argumente; Anfragen mit negativen Argumenten sollten nicht
+ * im Cache abgelegt werden.
+ *
+ * @param query     Anfrage
+ * @return          Schlüssel aus Art und Argumenten
+ */
+uint64_t ulam_lru_key(const ulam_query *query);
+
+/**
+ * Sucht einen Eintrag und markiert ihn als zuletzt benutzt.
+ *
+ * @param lru       Cache
+ * @param key       Schlüssel
+ * @param value     Ziel für das Ergebnis
+ * @return          1, wenn der Eintrag gefunden wurde, sonst 0
+ */
+int ulam_lru_get(ulam_lru *lru, uint64_t key, int *value);
+
+/**
+ * Trägt ein Ergebnis ein und verdrängt bei vollem Cache den am längsten
+ * nicht benutzten Eintrag.
+ *
+ * @param lru       Cache
+ * @param key       Schlüssel
+ * @param value     Ergebnis
+ */
+void ulam_lru_put(ulam_lru *lru, uint64_t key, int value);
+
+#endif /* ULAM_LRU_H */
@@ -0,0 +1,267 @@
+/**
+ * @file
+ * Dieses Modul verallgemeinert die ULAM-Funktion zu Abbildungen der Form
+ *
+ * <ul>
+ *   <li> an / D,       falls an durch D teilbar ist
+ *   <li> A * an + B,   sonst
+ * </ul>
+ *
+ * Die Parameter A, B und D sind Template-Argumente und werden beim
+ * Übersetzen eingesetzt; ulam_map<3, 1, 2> ist die ULAM-Funktion selbst.
+ * Varianten wie 5n+1 oder 3n-1 haben neben 1 weitere Zyklen. Damit
+ * ulam_map<A, B, D>::run() auch dann endet, erkennt die Funktion Zyklen mit
+ * dem Verfahren von Brent: Ein Zeiger bleibt auf dem Folgenglied der letzten
+ * Zweierpotenz stehen; trifft die Folge erneut auf ihn, ist die Länge des
+ * Zyklus die Anzahl der Schritte seitdem. Divergente Folgen enden mit einem
+ * Überlauf oder nach einer vorgegebenen Anzahl von Schritten.
+ *
+ * Für ulam_map<3, 1, 2> gibt es eine Spezialisierung ohne Zykluserkennung,
+ * die gerade Schritte wie ulam_max_jump() mit einem
+ * Count-Trailing-Zeros zusammenfasst. Im 64-Bit-Bereich sind keine Zyklen
+ * außer 1, 4, 2 bekannt.
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+#ifndef ULAM_MAP_H
+#define ULAM_MAP_H
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <stdint.h>
+
+
+/* ============================================================================
+ * Typdefinitionen
+ * ========================================================================= */
+
+/**
+ * Ende einer Folge bei ulam_map<A, B, D>::run().
+ */
+typedef enum
+{
+    ULAM_MAP_ONE = 0,       /**< die Folge erreicht 1 */
+    ULAM_MAP_CYCLE,         /**< die Folge läuft in einen Zyklus ohne 1 */
+    ULAM_MAP_OVERFLOW,      /**< ein Folgenglied ist nicht mit 64 Bit
+                                 darstellbar */
+    ULAM_MAP_LIMIT,         /**< die maximale Anzahl an Schritten wurde
+                                 erreicht */
+    ULAM_MAP_INVALID        /**< Startwert < 1 */
+} ulam_map_status;
+
+/**
+ * Ergebnis von ulam_map<A, B, D>::run().
+ */
+typedef struct
+{
+    ulam_map_status status; /**< Ende der Folge */
+    int64_t peak;           /**< größtes berechnetes Folgenglied */
+    int64_t steps;          /**< Anzahl der berechneten Schritte */
+    int64_t cycle_min;      /**< kleinstes Glied des Zyklus oder 0 */
+    int64_t cycle_len;      /**< Länge des Zyklus oder 0 */
+} ulam_map_result;
+
+/**
+ * Abbildung an / D bzw. A * an + B mit Zykluserkennung.
+ *
+ * @tparam A        Faktor für nicht durch D teilbare Folgenglieder
+ * @tparam B        Summand für nicht durch D teilbare Folgenglieder
+ * @tparam D        Teiler
+ */
+template <int A, int B, int D>
+struct ulam_map
+{
+    static_assert(D >= 2, "Der Teiler D muss mindestens 2 sein");
+    static_assert(A >= 1 && A + B >= 1,
+                  "A * an + B muss für an >= 1 positiv sein");
+
+    /**
+     * Berechnet einen Schritt der Abbildung.
+     *
+     * @param an        Folgenglied >= 1
+     * @param next      Ziel für das nächste Folgenglied
+     * @return          0 oder -1 bei Überlauf
+     */
+    static inline int step(int64_t an, int64_t *next)
+    {
+        int64_t value;
+
+        if (an % D == 0)
+        {
+            *next = an / D;
+            return 0;
+        }
+        if (__builtin_mul_overflow(an, (int64_t) A, &value)
+            || __builtin_add_overflow(value, (int64_t) B, &value))
+        {
+            return -1;
+        }
+        *next = value;
+
+        return 0;
+    }
+
+    /**
+     * Berechnet die Folge zu a0, bis sie 1 erreicht, in einen Zyklus läuft,
+     * überläuft oder max_steps Schritte berechnet sind.
+     *
+     * @param a0        Startwert
+     * @param max_steps maximale Anzahl der Schritte, < 0 für unbegrenzt
+     * @return          Ende der Folge, Maximum, Schritte und ggf. Zyklus
+     */
+    static ulam_map_result run(int64_t a0, int64_t max_steps)
+    {
+        ulam_map_result result = { ULAM_MAP_INVALID, 0, 0, 0, 0 };
+        int64_t an;         /* aktuelles Folgenglied */
+        int64_t saved;      /* Folgenglied bei der letzten Zweierpotenz */
+        int64_t power = 1;  /* Länge des aktuellen Suchfensters */
+        int64_t len = 0;    /* Schritte seit saved */
+        int64_t i;
+
+        if (a0 < 1)
+        {
+            return result;
+        }
+
+        an = a0;
+        saved = a0;
+        result.peak = a0;
+
+        for (;;)
+        {
+            if (an == 1)
+            {
+                result.status = ULAM_MAP_ONE;
+                return result;
+            }
+            if (result.steps == max_steps)
+            {
+                result.status = ULAM_MAP_LIMIT;
+                return result;
+            }
+            if (step(an, &an) != 0)
+            {
+                result.status = ULAM_MAP_OVERFLOW;
+                return result;
+            }
+            result.steps++;
+            if (an > result.peak)
+            {
+                result.peak = an;
+            }
+
+            /* Zykluserkennung nach Brent */
+            len++;
+            if (an == saved)
+            {
+                break;
+            }
+            if (len == power)
+            {
+                saved = an;
+                power *= 2;
+                len = 0;
+            }
+        }
+
+        /* Zyklus der Länge len durchlaufen, um sein kleinstes Glied zu
+         * bestimmen; das Maximum enthält ihn bereits vollständig */
+        result.status = ULAM_MAP_CYCLE;
+        result.cycle_len = len;
+        result.cycle_min = an;
+        for (i = 0; i < len; i++)
+        {
+            step(an, &an);
+            if (an < result.cycle_min)
+            {
+                result.cycle_min = an;
+            }
+        }
+
+        return result;
+    }
+};
+
+/**
+ * Spezialisierung für die ULAM-Funktion 3 * an + 1 ohne Zykluserkennung.
+ * Gerade Schritte werden mit einem Count-Trailing-Zeros zusammengefasst.
+ */
+template <>
+struct ulam_map<3, 1, 2>
+{
+    static inline int step(int64_t an, int64_t *next)
+    {
+        if (an % 2 == 0)
+        {
+            *next = an / 2;
+            return 0;
+        }
+        if (an > (INT64_MAX - 1) / 3)
+        {
+            return -1;
+        }
+        *next = 3 * an + 1;
+
+        return 0;
+    }
+
+    static ulam_map_result run(int64_t a0, int64_t max_steps)
+    {
+        ulam_map_result result = { ULAM_MAP_INVALID, 0, 0, 0, 0 };
+        int64_t an;
+        int zeros;
+
+        if (a0 < 1)
+        {
+            return result;
+        }
+        if (max_steps < 0)
+        {
+            /* Unbegrenzt wie in der allgemeinen Regel */
+            max_steps = INT64_MAX;
+        }
+
+        an = a0;
+        result.peak = a0;
+
+        for (;;)
+        {
+            /* Alle geraden Schritte auf einmal, höchstens bis max_steps */
+            zeros = __builtin_ctzll((uint64_t) an);
+            if (zeros > max_steps - result.steps)
+            {
+                zeros = (int) (max_steps - result.steps);
+            }
+            an >>= zeros;
+            result.steps += zeros;
+            if (an == 1)
+            {
+                result.status = ULAM_MAP_ONE;
+                return result;
+            }
+            if (result.steps == max_steps)
+            {
+                result.status = ULAM_MAP_LIMIT;
+                return result;
+            }
+
+            if (an > (INT64_MAX - 1) / 3)
+            {
+                result.status = ULAM_MAP_OVERFLOW;
+                return result;
+            }
+            an = 3 * an + 1;
+            result.steps++;
+            if (an > result.peak)
+            {
+                result.peak = an;
+            }
+        }
+    }
+};
+
+#endif /* ULAM_MAP_H */
@@ -0,0 +1,208 @@
+/**
+ * @file
+ * Dieses Modul implementiert die Überlaufstatistik der ULAM-Berechnungen
+ * (siehe ulam_overflow.h).
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "ulam_overflow.h"
+#include "ulam_registry.h"
+
+
+/* ============================================================================
+ * Typdefinitionen
+ * ========================================================================= */
+
+/**
+ * Statistikblock eines Threads. Die Felder werden nur vom eigenen Thread
+ * geschrieben und von allen Threads atomar gelesen.
+ */
+typedef struct
+{
+    long count;         /**< Anzahl der Überläufe */
+    long first_order;   /**< laufende Nummer des ersten */
+    long last_order;    /**< laufende Nummer des letzten */
+    int first_seed;     /**< Startzahl des ersten */
+    int last_seed;      /**< Startzahl des letzten */
+    int last_value;     /**< Folgenglied des letzten */
+} ulam_overflow_block;
+
+
+/* ============================================================================
+ * Prototypen der privaten Funktionen
+ * ========================================================================= */
+
+/**
+ * Fasst einen Statistikblock mit einer Summe zusammen: Anzahlen werden
+ * addiert, erster und letzter Überlauf nach laufender Nummer bestimmt (für
+ * ulam_registry_visit()).
+ *
+ * @param block     Statistikblock eines Threads
+ * @param arg       Summe (ulam_overflow_block)
+ */
+static void ulam_overflow_merge(void *block, void *arg);
+
+/**
+ * Setzt einen Statistikblock zurück (für ulam_registry_visit()).
+ *
+ * @param block     Statistikblock eines Threads
+ * @param arg       nicht verwendet
+ */
+static void ulam_overflow_clear(void *block, void *arg);
+
+
+/* ============================================================================
+ * Globale Variablen
+ * ========================================================================= */
+
+/** Statistikblock für den Fall, dass kein Speicher angelegt werden kann */
+static ulam_overflow_block ulam_overflow_fallback;
+
+/** Zusammenfassung der Statistik beendeter Threads */
+static ulam_overflow_block ulam_overflow_retired;
+
+/** Statistikblöcke aller Threads */
+static ulam_registry ulam_overflow_registry =
+    ULAM_REGISTRY_INIT(sizeof(ulam_overflow_block), &ulam_overflow_fallback,
+                       &ulam_overflow_retired, ulam_overflow_merge);
+
+/** laufende Nummer der Überläufe über alle Threads */
+static long ulam_overflow_order = 0;
+
+/** Log-Funktion oder NULL */
+static ulam_overflow_logger ulam_overflow_log = NULL;
+
+/** Abstand der protokollierten Überläufe */
+static long ulam_overflow_log_every = 1;
+
+/** Argument der Log-Funktion */
+static void *ulam_overflow_log_arg = NULL;
+
+
+/* ============================================================================
+ * Funktionsdefinitionen
+ * ========================================================================= */
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_overflow_record
+ * ------------------------------------------------------------------------- */
+void ulam_overflow_record(int seed, int an)
+{
+    ulam_overflow_block *block = (ulam_overflow_block *) 
+                                 ulam_registry_local(&ulam_overflow_registry);
+    long count = __atomic_load_n(&block->count, __ATOMIC_RELAXED) + 1;
+    long order = __atomic_add_fetch(&ulam_overflow_order, 1, 
+                                    __ATOMIC_RELAXED);
+
+    __atomic_store_n(&block->count, count, __ATOMIC_RELAXED);
+    if (count == 1)
+    {
+        __atomic_store_n(&block->first_seed, seed, __ATOMIC_RELAXED);
+        __atomic_store_n(&block->first_order, order, __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&block->last_seed, seed, __ATOMIC_RELAXED);
+    __atomic_store_n(&block->last_value, an, __ATOMIC_RELAXED);
+    __atomic_store_n(&block->last_order, order, __ATOMIC_RELAXED);
+
+    /* Stichprobe: erster und jeder every-te Überlauf des Threads */
+    if (ulam_overflow_log != NULL 
+        && (count == 1 || count % ulam_overflow_log_every == 0))
+    {
+        ulam_overflow_log(seed, an, count, ulam_overflow_log_arg);
+    }
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_overflow_get_stats
+ * ------------------------------------------------------------------------- */
+void ulam_overflow_get_stats(ulam_overflow_stats *stats)
+{
+    ulam_overflow_block total;
+
+    if (stats == NULL)
+    {
+        return;
+    }
+
+    memset(&total, 0, sizeof(total));
+    ulam_registry_visit(&ulam_overflow_registry, ulam_overflow_merge, &total);
+    stats->count = total.count;
+    stats->first_seed = total.first_seed;
+    stats->last_seed = total.last_seed;
+    stats->last_value = total.last_value;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_overflow_reset_stats
+ * ------------------------------------------------------------------------- */
+void ulam_overflow_reset_stats(void)
+{
+    ulam_registry_visit(&ulam_overflow_registry, ulam_overflow_clear, NULL);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_overflow_set_logger
+ * ------------------------------------------------------------------------- */
+void ulam_overflow_set_logger(ulam_overflow_logger logger, long every,
+                              void *arg)
+{
+    ulam_overflow_log = logger;
+    ulam_overflow_log_every = (every >= 1) ? every : 1;
+    ulam_overflow_log_arg = arg;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_overflow_merge
+ * ------------------------------------------------------------------------- */
+static void ulam_overflow_merge(void *block, void *arg)
+{
+    ulam_overflow_block *src = (ulam_overflow_block *) block;
+    ulam_overflow_block *sum = (ulam_overflow_block *) arg;
+    long count = __atomic_load_n(&src->count, __ATOMIC_RELAXED);
+    long order;
+
+    if (count == 0)
+    {
+        return;
+    }
+    sum->count += count;
+
+    order = __atomic_load_n(&src->first_order, __ATOMIC_RELAXED);
+    if (sum->first_order == 0 || order < sum->first_order)
+    {
+        sum->first_order = order;
+        sum->first_seed = __atomic_load_n(&src->first_seed, __ATOMIC_RELAXED);
+    }
+    order = __atomic_load_n(&src->last_order, __ATOMIC_RELAXED);
+    if (order > sum->last_order)
+    {
+        sum->last_order = order;
+        sum->last_seed = __atomic_load_n(&src->last_seed, __ATOMIC_RELAXED);
+        sum->last_value = __atomic_load_n(&src->last_value, __ATOMIC_RELAXED);
+    }
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_overflow_clear
+ * ------------------------------------------------------------------------- */
+static void ulam_overflow_clear(void *block, void *arg)
+{
+    ulam_overflow_block *stats = (ulam_overflow_block *) block;
+
+    (void) arg;
+    __atomic_store_n(&stats->count, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&stats->first_order, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&stats->last_order, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&stats->first_seed, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&stats->last_seed, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&stats->last_value, 0, __ATOMIC_RELAXED);
+}
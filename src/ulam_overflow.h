@@ -0,0 +1,93 @@
+/**
+ * @file
+ * Dieses Modul sammelt Statistiken über Überläufe bei der Berechnung von
+ * ULAM-Folgen mit int. Jeder Thread führt eigene Zähler, so dass die
+ * Kernel ohne Sperren und ohne Ein-/Ausgabe auskommen. Die Zählerblöcke
+ * aller Threads stehen in einer globalen Liste und werden beim Auslesen
+ * zusammengefasst, so dass auch Überläufe in den Hilfsthreads paralleler
+ * Berechnungen mitzählen. Die Statistik enthält die Anzahl der Überläufe
+ * sowie die erste und letzte Startzahl, bei der ein Überlauf aufgetreten
+ * ist.
+ *
+ * Optional kann eine Log-Funktion gesetzt werden, die beim ersten und danach
+ * bei jedem n-ten Überlauf eines Threads aufgerufen wird. Was gemeldet wird
+ * und wohin, entscheidet der Aufrufer.
+ *
+ * Gezählt werden nur tatsächlich berechnete Überläufe; Werte, die aus dem
+ * Cache oder dem Index gelesen werden, zählen nicht.
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+#ifndef ULAM_OVERFLOW_H
+#define ULAM_OVERFLOW_H
+
+/* ============================================================================
+ * Typdefinitionen
+ * ========================================================================= */
+
+/**
+ * Überlaufstatistik über alle Threads.
+ */
+typedef struct
+{
+    long count;         /**< Anzahl der Überläufe */
+    int first_seed;     /**< Startzahl des ersten Überlaufs oder 0 */
+    int last_seed;      /**< Startzahl des letzten Überlaufs oder 0 */
+    int last_value;     /**< Folgenglied, das beim letzten Mal überlief */
+} ulam_overflow_stats;
+
+/**
+ * Log-Funktion für Überläufe.
+ *
+ * @param seed      Startzahl der Folge, in der der Überlauf auftrat
+ * @param an        ungerades Folgenglied, für das 3 * an + 1 überläuft
+ * @param count     Anzahl der Überläufe des Threads einschließlich dieses
+ * @param arg       Argument, das an ulam_overflow_set_logger() übergeben wurde
+ */
+typedef void (*ulam_overflow_logger)(int seed, int an, long count, void *arg);
+
+
+/* ============================================================================
+ * Funktions-Prototypen
+ * ========================================================================= */
+
+/**
+ * Vermerkt einen Überlauf in der Statistik des aufrufenden Threads und ruft
+ * gegebenenfalls die Log-Funktion auf. Wird von den Kerneln aufgerufen.
+ *
+ * @param seed      Startzahl der Folge
+ * @param an        ungerades Folgenglied, für das 3 * an + 1 überläuft
+ */
+void ulam_overflow_record(int seed, int an);
+
+/**
+ * Liefert die Überlaufstatistik, summiert über alle Threads. Erster und
+ * letzter Überlauf beziehen sich auf die zeitliche Reihenfolge über alle
+ * Threads hinweg.
+ *
+ * @param stats     Ziel für die Statistik
+ */
+void ulam_overflow_get_stats(ulam_overflow_stats *stats);
+
+/**
+ * Setzt die Überlaufstatistik aller Threads zurück. Sollte nicht während
+ * laufender Berechnungen aufgerufen werden.
+ */
+void ulam_overflow_reset_stats(void);
+
+/**
+ * Setzt die Log-Funktion für Überläufe. Sie wird beim ersten Überlauf eines
+ * Threads und danach bei jedem every-ten Überlauf aufgerufen, ggf. aus
+ * mehreren Threads gleichzeitig. Die Log-Funktion sollte gesetzt werden,
+ * bevor Berechnungen gestartet werden.
+ *
+ * @param logger    Log-Funktion oder NULL, um das Protokoll abzuschalten
+ * @param every     Abstand der protokollierten Überläufe (>= 1)
+ * @param arg       beliebiges Argument für logger
+ */
+void ulam_overflow_set_logger(ulam_overflow_logger logger, long every,
+                              void *arg);
+
+#endif /* ULAM_OVERFLOW_H */
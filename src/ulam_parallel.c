@@ -0,0 +1,433 @@
+/**
+ * @file
+ * Dieses Modul berechnet ULAM-Zwillinge und ULAM-Mehrlinge mit mehreren
+ * Threads (siehe ulam_parallel.h).
+ *
+ * Das Intervall wird fensterweise von limit abwärts bearbeitet. Jedes
+ * Fenster besteht aus mehreren Abschnitten, die der Scheduler (siehe
+ * ulam_sched.h) auf die Threads verteilt. Zu jedem Abschnitt wird eine Zusammenfassung gebildet:
+ * der größte Mehrling, der vollständig im Abschnitt liegt, sowie die Läufe
+ * gleicher Maxima am unteren und oberen Rand. Beim Zusammenfügen der
+ * Abschnitte von oben nach unten wird der Lauf am unteren Rand des bereits
+ * bearbeiteten Bereichs mitgeführt, so dass auch Mehrlinge über
+ * Abschnittsgrenzen hinweg gefunden werden.
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "ulam.h"
+#include "ulam_range.h"
+#include "ulam_sched.h"
+#include "ulam_parallel.h"
+
+
+/* ============================================================================
+ * Symbolische Konstanten
+ * ========================================================================= */
+
+/** Größe der Abschnitte im ersten Fenster */
+#define ULAM_PARALLEL_MIN_CHUNK 256
+
+/** Größe, bis zu der sich die Abschnitte von Fenster zu Fenster verdoppeln */
+#define ULAM_PARALLEL_MAX_CHUNK 16384
+
+/** Anzahl der Abschnitte je Thread in einem Fenster */
+#define ULAM_PARALLEL_CHUNKS_PER_THREAD 8
+
+
+/* ============================================================================
+ * Typdefinitionen
+ * ========================================================================= */
+
+/**
+ * Zusammenfassung eines Abschnitts lo bis hi.
+ */
+typedef struct
+{
+    int lo;         /* kleinste Startzahl des Abschnitts */
+    int hi;         /* größte Startzahl des Abschnitts */
+    int best;       /* kleinster Index des letzten Mehrlings im Abschnitt */
+    int head_val;   /* Maximum des Laufs, der bei lo beginnt */
+    int head_len;   /* Länge des Laufs, der bei lo beginnt */
+    int tail_val;   /* Maximum des Laufs, der bei hi endet */
+    int tail_len;   /* Länge des Laufs, der bei hi endet */
+    int done;       /* 1, wenn der Abschnitt berechnet wurde */
+} ulam_parallel_chunk;
+
+/**
+ * Aktuelles Fenster einer parallelen Suche.
+ */
+typedef struct
+{
+    int number;                 /* Anzahl der gesuchten Mehrlinge */
+    int window_lo;              /* kleinste Startzahl des Fensters */
+    int window_hi;              /* größte Startzahl des Fensters */
+    int chunk_size;             /* Größe der Abschnitte im Fenster */
+    int cancel_below;           /* Abschnitte mit größerem Index entfallen */
+    const ulam_parallel_control *control; /* Abbruch und Frist oder NULL */
+    ulam_parallel_chunk *summary; /* Zusammenfassungen der Abschnitte */
+} ulam_parallel_window;
+
+
+/* ============================================================================
+ * Prototypen der privaten Funktionen
+ * ========================================================================= */
+
+/**
+ * Berechnet die maximalen ULAM-Werte eines Abschnitts und bildet dessen
+ * Zusammenfassung.
+ *
+ * @param chunk     Zusammenfassung, die gefüllt wird
+ * @param lo        kleinste Startzahl des Abschnitts
+ * @param hi        größte Startzahl des Abschnitts
+ * @param number    Anzahl der gesuchten Mehrlinge
+ * @param peaks     Puffer für mindestens hi - lo + 1 maximale ULAM-Werte
+ */
+static void ulam_parallel_summarize(ulam_parallel_chunk *chunk, int lo, int hi,
+                                    int number, int peaks[]);
+
+/**
+ * Aufgabe für den Scheduler: bearbeitet die Abschnitte first bis last des
+ * aktuellen Fensters.
+ *
+ * @param first     Index des ersten Abschnitts
+ * @param last      Index des letzten Abschnitts
+ * @param arg       Zeiger auf das aktuelle ulam_parallel_window
+ */
+static void ulam_parallel_task(int first, int last, void *arg);
+
+/**
+ * Prüft, ob eine Suche abgebrochen wurde oder ihre Frist abgelaufen ist.
+ *
+ * @param control   Steuerung der Suche oder NULL
+ * @return          1, wenn die Suche enden soll, sonst 0
+ */
+static int ulam_parallel_stopped(const ulam_parallel_control *control);
+
+
+/* ============================================================================
+ * Globale Variablen
+ * ========================================================================= */
+
+/** eingestellte Anzahl der Threads, 0 für die Anzahl der Prozessoren */
+static int ulam_parallel_threads = 0;
+
+
+/* ============================================================================
+ * Funktionsdefinitionen
+ * ========================================================================= */
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_parallel_set_threads
+ * ------------------------------------------------------------------------- */
+int ulam_parallel_set_threads(int threads)
+{
+    if (threads < 0)
+    {
+        return -1;
+    }
+
+    ulam_parallel_threads = threads;
+
+    return ulam_parallel_get_threads();
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_parallel_get_threads
+ * ------------------------------------------------------------------------- */
+int ulam_parallel_get_threads(void)
+{
+    long cpus;
+
+    if (ulam_parallel_threads > 0)
+    {
+        return ulam_parallel_threads;
+    }
+
+    cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return (cpus > 0) ? (int) cpus : 1;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_twins_parallel
+ * ------------------------------------------------------------------------- */
+int ulam_twins_parallel(int limit)
+{
+    /* Zwillinge sind Mehrlinge mit der Anzahl 2; für limit = 1 liefern
+     * beide Funktionen -1. */
+    if (limit < 1)
+    {
+        return -1;
+    }
+
+    return ulam_multiples_parallel(limit, 2);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_multiples_parallel
+ * ------------------------------------------------------------------------- */
+int ulam_multiples_parallel(int limit, int number)
+{
+    int verified_lo;
+
+    return ulam_multiples_partial(limit, number, NULL, &verified_lo);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_multiples_partial
+ * ------------------------------------------------------------------------- */
+int ulam_multiples_partial(int limit, int number,
+                           const ulam_parallel_control *control,
+                           int *verified_lo)
+{
+    ulam_parallel_window window;
+    ulam_parallel_chunk *chunk;
+    int max_chunks;
+    int chunk_size;
+    int top;            /* größte noch nicht bearbeitete Startzahl */
+    int carry_val;      /* Maximum des Laufs am unteren Rand des bearbeiteten
+                         * Bereichs */
+    int carry_len;      /* Länge dieses Laufs, 0 zu Beginn */
+    int multiples_index;
+    long long chunks;
+    int stopped;
+    int i;
+
+    *verified_lo = 0;
+    if (number < 2 || limit < number)
+    {
+        return -1;
+    }
+
+    max_chunks = ulam_parallel_get_threads() * ULAM_PARALLEL_CHUNKS_PER_THREAD;
+
+    /* Auswahl des SIMD-Kernels vor dem Start der Threads */
+    ulam_range_get_isa();
+
+    window.summary = (ulam_parallel_chunk *)
+        malloc((size_t) max_chunks * sizeof(ulam_parallel_chunk));
+    if (window.summary == NULL)
+    {
+        return ulam_multiples(limit, number);
+    }
+    window.number = number;
+    window.control = control;
+
+    /*
+     * Fensterweise von limit abwärts suchen. Die Abschnitte werden von Fenster
+     * zu Fenster größer, damit früh gefundene Mehrlinge wenig Arbeit kosten.
+     */
+    multiples_index = -1;
+    carry_val = 0;
+    carry_len = 0;
+    top = limit;
+    chunk_size = ULAM_PARALLEL_MIN_CHUNK;
+    stopped = 0;
+
+    while (multiples_index == -1 && top >= 0 && !stopped)
+    {
+        chunks = ((long long) top + chunk_size) / chunk_size;
+        if (chunks > max_chunks)
+        {
+            chunks = max_chunks;
+        }
+
+        window.window_hi = top;
+        window.window_lo = (int) ((long long) top + 1 - chunks * chunk_size);
+        if (window.window_lo < 0)
+        {
+            window.window_lo = 0;
+        }
+        window.chunk_size = chunk_size;
+        window.cancel_below = (int) chunks;
+        for (i = 0; i < chunks; i++)
+        {
+            window.summary[i].done = 0;
+        }
+
+        ulam_sched_parallel_for(0, (int) chunks - 1, 1,
+                                ulam_parallel_task, &window);
+
+        /* Abschnitte von oben nach unten zusammenfügen */
+        for (i = 0; i < chunks && multiples_index == -1; i++)
+        {
+            chunk = &window.summary[i];
+
+            /* Nach einem Abbruch endet der geprüfte Bereich vor dem ersten
+             * nicht berechneten Abschnitt */
+            if (!chunk->done)
+            {
+                stopped = 1;
+                break;
+            }
+            top = chunk->lo - 1;
+
+            if (carry_len > 0 && chunk->tail_val == carry_val
+                && chunk->tail_len + carry_len >= number)
+            {
+                /* Mehrling über die obere Abschnittsgrenze hinweg */
+                multiples_index = chunk->hi + carry_len - number + 1;
+            }
+            else if (chunk->best >= 0)
+            {
+                multiples_index = chunk->best;
+            }
+            else if (carry_len > 0 && chunk->head_val == carry_val
+                     && chunk->head_len == chunk->hi - chunk->lo + 1)
+            {
+                /* Der Abschnitt verlängert den mitgeführten Lauf */
+                carry_len += chunk->head_len;
+            }
+            else
+            {
+                carry_val = chunk->head_val;
+                carry_len = chunk->head_len;
+            }
+        }
+
+        if (chunk_size < ULAM_PARALLEL_MAX_CHUNK)
+        {
+            chunk_size *= 2;
+        }
+
+        if (multiples_index == -1 && control != NULL)
+        {
+            if (control->progress != NULL)
+            {
+                control->progress(limit, top + 1, control->arg);
+            }
+            stopped = stopped || (top >= 0 && ulam_parallel_stopped(control));
+        }
+    }
+
+    free(window.summary);
+
+    *verified_lo = (multiples_index >= 0) ? multiples_index : top + 1;
+
+    return multiples_index;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_parallel_summarize
+ * ------------------------------------------------------------------------- */
+static void ulam_parallel_summarize(ulam_parallel_chunk *chunk, int lo, int hi,
+                                    int number, int peaks[])
+{
+    int size = hi - lo + 1;
+    int count;
+    int i;
+
+    ulam_max_range(lo, hi, peaks);
+
+    chunk->lo = lo;
+    chunk->hi = hi;
+
+    /* Letzter Mehrling innerhalb des Abschnitts, Suche wie ulam_multiples */
+    chunk->best = -1;
+    count = 1;
+    for (i = size - 2; i >= 0 && chunk->best == -1; i--)
+    {
+        count = (peaks[i] == peaks[i + 1]) ? count + 1 : 1;
+        if (count == number)
+        {
+            chunk->best = lo + i;
+        }
+    }
+
+    /* Läufe gleicher Maxima am oberen und unteren Rand */
+    chunk->tail_val = peaks[size - 1];
+    chunk->tail_len = 1;
+    while (chunk->tail_len < size
+           && peaks[size - 1 - chunk->tail_len] == chunk->tail_val)
+    {
+        chunk->tail_len++;
+    }
+
+    chunk->head_val = peaks[0];
+    chunk->head_len = 1;
+    while (chunk->head_len < size && peaks[chunk->head_len] == chunk->head_val)
+    {
+        chunk->head_len++;
+    }
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_parallel_task
+ * ------------------------------------------------------------------------- */
+static void ulam_parallel_task(int first, int last, void *arg)
+{
+    ulam_parallel_window *window = (ulam_parallel_window *) arg;
+    ulam_parallel_chunk *chunk;
+    int peaks[ULAM_PARALLEL_MAX_CHUNK];
+    int cancel_below;
+    int index;
+    int lo;
+    int hi;
+
+    for (index = first; index <= last; index++)
+    {
+        /* Enthält ein höherer Abschnitt bereits einen Mehrling, entfallen 
+         * alle darunter liegenden Abschnitte */
+        cancel_below = __atomic_load_n(&window->cancel_below, __ATOMIC_RELAXED);
+        if (index > cancel_below || ulam_parallel_stopped(window->control))
+        {
+            break;
+        }
+
+        hi = window->window_hi - index * window->chunk_size;
+        lo = hi - window->chunk_size + 1;
+        if (lo < window->window_lo)
+        {
+            lo = window->window_lo;
+        }
+
+        chunk = &window->summary[index];
+        ulam_parallel_summarize(chunk, lo, hi, window->number, peaks);
+        chunk->done = 1;
+
+        /* Grenze für den Abbruch auf diesen Abschnitt herabsetzen */
+        while (chunk->best >= 0 && index < cancel_below
+               && !__atomic_compare_exchange_n(&window->cancel_below,
+                                               &cancel_below, index, 0,
+                                               __ATOMIC_RELAXED,
+                                               __ATOMIC_RELAXED))
+        {
+        }
+    }
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_parallel_stopped
+ * ------------------------------------------------------------------------- */
+static int ulam_parallel_stopped(const ulam_parallel_control *control)
+{
+    struct timespec now;
+
+    if (control == NULL)
+    {
+        return 0;
+    }
+    if (control->cancel != NULL 
+        && __atomic_load_n(control->cancel, __ATOMIC_RELAXED) != 0)
+    {
+        return 1;
+    }
+    if (control->deadline_ns > 0)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return (long long) now.tv_sec * 1000000000LL + now.tv_nsec 
+               >= control->deadline_ns;
+    }
+
+    return 0;
+}
@@ -0,0 +1,111 @@
+/**
+ * @file
+ * Dieses Modul berechnet ULAM-Zwillinge und ULAM-Mehrlinge mit mehreren
+ * Threads. Das Intervall wird von oben nach unten in Abschnitte zerlegt,
+ * deren maximale ULAM-Werte parallel berechnet werden. Gruppen gleicher
+ * Maxima, die über eine Abschnittsgrenze reichen, werden beim Zusammenfügen
+ * der Abschnitte erkannt, so dass die Ergebnisse mit denen von ulam_twins()
+ * und ulam_multiples() übereinstimmen.
+ *
+ * Mit ulam_multiples_partial() lässt sich eine Suche zwischen zwei
+ * Abschnitten abbrechen oder nach Ablauf einer Frist beenden. Sie liefert
+ * dann den bis dahin lückenlos geprüften oberen Teil des Intervalls.
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+#ifndef ULAM_PARALLEL_H
+#define ULAM_PARALLEL_H
+
+/* ============================================================================
+ * Typdefinitionen
+ * ========================================================================= */
+
+/**
+ * Callback-Funktion, die nach jedem Fenster einer Suche aufgerufen wird.
+ *
+ * @param limit         obere Grenze der Suche
+ * @param verified_lo   [verified_lo, limit] ist vollständig geprüft
+ * @param arg           Argument aus #ulam_parallel_control
+ */
+typedef void (*ulam_parallel_progress)(int limit, int verified_lo, void *arg);
+
+/**
+ * Steuerung einer Suche mit ulam_multiples_partial().
+ */
+typedef struct
+{
+    const int *cancel;      /**< Abbruch, sobald *cancel != 0, oder NULL */
+    long long deadline_ns;  /**< Frist in ns (CLOCK_MONOTONIC), 0 = keine */
+    ulam_parallel_progress progress; /**< Fortschritt oder NULL */
+    void *arg;              /**< Argument für progress */
+} ulam_parallel_control;
+
+
+/* ============================================================================
+ * Funktions-Prototypen
+ * ========================================================================= */
+
+/**
+ * Legt die Anzahl der Threads für die parallelen Berechnungen fest.
+ *
+ * @param threads   Anzahl der Threads; 0 wählt die Anzahl der Prozessoren
+ * @return          die eingestellte Anzahl der Threads oder -1, wenn
+ *                  threads < 0 ist
+ */
+int ulam_parallel_set_threads(int threads);
+
+/**
+ * Liefert die Anzahl der Threads für die parallelen Berechnungen.
+ *
+ * @return          die Anzahl der Threads
+ */
+int ulam_parallel_get_threads(void);
+
+/**
+ * Parallele Variante von ulam_twins() mit identischem Ergebnis.
+ *
+ * @param limit     ganze Zahl, bis zu der nach ULAM-Zwillingen
+ *                  gesucht werden soll.
+ * @return          die kleinere Zahl des letzten ULAM-Zwillingspaars
+ *                  oder -1, wenn es kein solches Paar gibt oder limit < 1 ist
+ */
+int ulam_twins_parallel(int limit);
+
+/**
+ * Parallele Variante von ulam_multiples() mit identischem Ergebnis. Die
+ * Abschnitte werden von limit abwärts vergeben; sobald die letzte Gruppe
+ * feststeht, werden die darunter liegenden Abschnitte nicht mehr berechnet.
+ *
+ * @param limit     positive ganze Zahl, bis zu der nach ULAM-Mehrlingen
+ *                  gesucht werden soll.
+ * @param number    positive Zahl, die die Anzahl der gesuchten Mehrlinge angibt
+ * @return          die kleinste Zahl des letzten "ULAM-Mehrlings" oder -1, wenn
+ *                  keine Mehrlinge gefunden wurden, limit < number oder
+ *                  number < 2.
+ */
+int ulam_multiples_parallel(int limit, int number);
+
+/**
+ * Variante von ulam_multiples_parallel(), die vor jedem Abschnitt prüft, ob
+ * die Suche abgebrochen wurde oder die Frist abgelaufen ist. In diesem Fall
+ * werden die restlichen Abschnitte nicht mehr berechnet.
+ *
+ * @param limit         positive ganze Zahl, bis zu der nach ULAM-Mehrlingen
+ *                      gesucht werden soll.
+ * @param number        Anzahl der gesuchten Mehrlinge
+ * @param control       Abbruch, Frist und Fortschritt oder NULL
+ * @param verified_lo   Ziel für die kleinste Zahl, ab der das Intervall bis
+ *                      limit vollständig geprüft ist: 0 nach einer
+ *                      vollständigen Suche, der gefundene Mehrling oder beim
+ *                      vorzeitigen Ende die Grenze, oberhalb der kein
+ *                      Mehrling beginnt
+ * @return              wie ulam_multiples(); nach einem vorzeitigen Ende
+ *                      ohne Fund -1 mit verified_lo > 0
+ */
+int ulam_multiples_partial(int limit, int number,
+                           const ulam_parallel_control *control,
+                           int *verified_lo);
+
+#endif /* ULAM_PARALLEL_H */
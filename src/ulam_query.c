@@ -0,0 +1,348 @@
+/**
+ * @file
+ * Dieses Modul implementiert das Lesen und Beantworten von Anfragen in
+ * Textform (siehe ulam_query.h).
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+
+#include "ulam.h"
+#include "ulam_cache.h"
+#include "ulam_index.h"
+#include "ulam_jump.h"
+#include "ulam_query.h"
+#include "ulam_runs.h"
+#include "ulam_sched.h"
+
+
+/* ============================================================================
+ * Symbolische Konstanten
+ * ========================================================================= */
+
+/** Anzahl der Anfragen, die eine Aufgabe des Schedulers höchstens umfasst */
+#define ULAM_QUERY_GRAIN 64
+
+
+/* ============================================================================
+ * Prototypen der privaten Funktionen
+ * ========================================================================= */
+
+/**
+ * Liest eine nicht negative oder negative Dezimalzahl und überspringt
+ * vorangehende Leerzeichen.
+ *
+ * @param pos       aktuelle Leseposition, wird hinter die Zahl gesetzt
+ * @param end       Ende der Zeile
+ * @param value     Ziel für die Zahl
+ * @return          0 bei Erfolg, -1 wenn keine Zahl im int-Bereich folgt
+ */
+static int ulam_query_parse_int(const char **pos, const char *end, 
+                                int *value);
+
+/**
+ * Prüft, ob eine Anfrage ohne den globalen persistenten Cache beantwortet
+ * werden kann und damit parallel ausgewertet werden darf.
+ *
+ * @param query     Anfrage
+ * @return          1, wenn die Anfrage threadsicher ist, sonst 0
+ */
+static int ulam_query_is_parallel(const ulam_query *query);
+
+/**
+ * Beantwortet eine Anfrage und misst die Bearbeitungszeit.
+ *
+ * @param query     Anfrage
+ */
+static void ulam_query_eval(ulam_query *query);
+
+/**
+ * Aufgabe des Schedulers: beantwortet die threadsicheren Anfragen lo bis hi.
+ *
+ * @param lo        erste Anfrage
+ * @param hi        letzte Anfrage
+ * @param arg       Feld der Anfragen
+ */
+static void ulam_query_task(int lo, int hi, void *arg);
+
+
+/* ============================================================================
+ * Funktionsdefinitionen
+ * ========================================================================= */
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_query_parse
+ * ------------------------------------------------------------------------- */
+int ulam_query_parse(const char *line, size_t len, ulam_query *query)
+{
+    const char *pos = line;
+    const char *end = line + len;
+    const char *word;
+    size_t word_len;
+
+    memset(query, 0, sizeof(*query));
+
+    /* Schlüsselwort */
+    while (pos < end && (*pos == ' ' || *pos == '\t'))
+    {
+        pos++;
+    }
+    word = pos;
+    while (pos < end && *pos != ' ' && *pos != '\t' && *pos != '\r')
+    {
+        pos++;
+    }
+    word_len = (size_t) (pos - word);
+
+    if (word_len == 3 && memcmp(word, "max", 3) == 0)
+    {
+        query->type = ULAM_QUERY_MAX;
+    }
+    else if (word_len == 5 && memcmp(word, "twins", 5) == 0)
+    {
+        query->type = ULAM_QUERY_TWINS;
+    }
+    else if (word_len == 9 && memcmp(word, "multiples", 9) == 0)
+    {
+        query->type = ULAM_QUERY_MULTIPLES;
+    }
+    else
+    {
+        return -1;
+    }
+
+    /* Argumente */
+    if (ulam_query_parse_int(&pos, end, &query->arg1) != 0
+        || (query->type == ULAM_QUERY_MULTIPLES
+            && ulam_query_parse_int(&pos, end, &query->arg2) != 0))
+    {
+        query->type = ULAM_QUERY_INVALID;
+        return -1;
+    }
+
+    /* Danach dürfen nur noch Leerzeichen folgen */
+    while (pos < end && (*pos == ' ' || *pos == '\t' || *pos == '\r'))
+    {
+        pos++;
+    }
+    if (pos != end)
+    {
+        query->type = ULAM_QUERY_INVALID;
+        return -1;
+    }
+
+    return 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_query_eval_batch
+ * ------------------------------------------------------------------------- */
+void ulam_query_eval_batch(ulam_query queries[], int count)
+{
+    int i;
+
+    if (count < 1)
+    {
+        return;
+    }
+
+    /* Zuerst alle threadsicheren Anfragen parallel ... */
+    ulam_sched_parallel_for(0, count - 1, ULAM_QUERY_GRAIN, ulam_query_task,
+                            queries);
+
+    /* ... dann die übrigen im aufrufenden Thread */
+    for (i = 0; i < count; i++)
+    {
+        if (!ulam_query_is_parallel(&queries[i]))
+        {
+            ulam_query_eval(&queries[i]);
+        }
+    }
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_query_format
+ * ------------------------------------------------------------------------- */
+int ulam_query_format(const ulam_query *query, char *buffer, size_t size)
+{
+    char digits[16];
+    unsigned int value;
+    int negative;
+    int n = 0;
+    int i;
+
+    if (query->type == ULAM_QUERY_INVALID)
+    {
+        return snprintf(buffer, size, "error\n");
+    }
+
+    /* Ganzzahl ohne printf umwandeln, die Ausgabe ist der Engpass */
+    negative = query->result < 0;
+    value = negative ? 0u - (unsigned int) query->result 
+                     : (unsigned int) query->result;
+    do
+    {
+        digits[n++] = (char) ('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+
+    if ((size_t) n + 2 > size)
+    {
+        return 0;
+    }
+
+    i = 0;
+    if (negative)
+    {
+        buffer[i++] = '-';
+    }
+    while (n > 0)
+    {
+        buffer[i++] = digits[--n];
+    }
+    buffer[i++] = '\n';
+
+    return i;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_query_parse_int
+ * ------------------------------------------------------------------------- */
+static int ulam_query_parse_int(const char **pos, const char *end, 
+                                int *value)
+{
+    const char *p = *pos;
+    long long number = 0;
+    int negative = 0;
+    int digits = 0;
+
+    while (p < end && (*p == ' ' || *p == '\t'))
+    {
+        p++;
+    }
+    if (p < end && *p == '-')
+    {
+        negative = 1;
+        p++;
+    }
+
+    while (p < end && *p >= '0' && *p <= '9')
+    {
+        number = number * 10 + (*p - '0');
+        if (number > (long long) INT_MAX + 1)
+        {
+            return -1;
+        }
+        digits++;
+        p++;
+    }
+
+    if (digits == 0)
+    {
+        return -1;
+    }
+    if (negative)
+    {
+        number = -number;
+    }
+    if (number > INT_MAX || number < INT_MIN)
+    {
+        return -1;
+    }
+
+    *value = (int) number;
+    *pos = p;
+
+    return 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_query_is_parallel
+ * ------------------------------------------------------------------------- */
+static int ulam_query_is_parallel(const ulam_query *query)
+{
+    switch (query->type)
+    {
+        case ULAM_QUERY_MAX:
+            return 1;
+
+        case ULAM_QUERY_TWINS:
+        case ULAM_QUERY_MULTIPLES:
+            return query->arg1 <= ulam_runs_get_hi()
+                   || !ulam_cache_get_persistent();
+
+        default:
+            /* Ungültige Anfragen erfordern keine Berechnung */
+            return 1;
+    }
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_query_eval
+ * ------------------------------------------------------------------------- */
+static void ulam_query_eval(ulam_query *query)
+{
+    struct timespec start;
+    struct timespec stop;
+    int inside_runs = query->arg1 <= ulam_runs_get_hi();
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    switch (query->type)
+    {
+        case ULAM_QUERY_MAX:
+            /* Index bzw. Sprungtabelle statt ulam_max(), die den Cache
+             * benutzen könnte */
+            query->result = ulam_index_lookup(query->arg1);
+            if (query->result <= 0)
+            {
+                query->result = ulam_max_jump(query->arg1);
+            }
+            break;
+
+        case ULAM_QUERY_TWINS:
+            query->result = inside_runs ? ulam_runs_twins(query->arg1)
+                                        : ulam_twins(query->arg1);
+            break;
+
+        case ULAM_QUERY_MULTIPLES:
+            query->result = inside_runs 
+                            ? ulam_runs_multiples(query->arg1, query->arg2)
+                            : ulam_multiples(query->arg1, query->arg2);
+            break;
+
+        default:
+            query->result = -1;
+            break;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    query->latency_ns = (int64_t) (stop.tv_sec - start.tv_sec) * 1000000000
+                        + (stop.tv_nsec - start.tv_nsec);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_query_task
+ * ------------------------------------------------------------------------- */
+static void ulam_query_task(int lo, int hi, void *arg)
+{
+    ulam_query *queries = (ulam_query *) arg;
+    int i;
+
+    for (i = lo; i <= hi; i++)
+    {
+        if (ulam_query_is_parallel(&queries[i]))
+        {
+            ulam_query_eval(&queries[i]);
+        }
+    }
+}
@@ -0,0 +1,99 @@
+/**
+ * @file
+ * Dieses Modul liest und beantwortet Anfragen an die ULAM-Funktionen in
+ * Textform, wie sie das Programm ulam stapelweise verarbeitet. Eine Anfrage
+ * steht in einer Zeile und hat eine der Formen
+ *
+ * <ul>
+ *   <li> max N           für ulam_max(N)
+ *   <li> twins L         für ulam_twins(L)
+ *   <li> multiples L K   für ulam_multiples(L, K)
+ * </ul>
+ *
+ * Ein Stapel von Anfragen wird parallel mit dem Scheduler (siehe
+ * ulam_sched.h) ausgewertet. Liegt limit im Lauf-Index (siehe
+ * ulam_runs.h), werden twins und multiples dort nachgeschlagen. Im
+ * persistenten Modus des Caches (siehe ulam_cache.h) teilen sich
+ * ulam_twins() und ulam_multiples() den globalen Cache; Anfragen außerhalb
+ * des Lauf-Index werden dann anschließend im aufrufenden Thread berechnet.
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+#ifndef ULAM_QUERY_H
+#define ULAM_QUERY_H
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+/* ============================================================================
+ * Typdefinitionen
+ * ========================================================================= */
+
+/**
+ * Art einer Anfrage.
+ */
+typedef enum
+{
+    ULAM_QUERY_INVALID = 0,     /**< Zeile konnte nicht gelesen werden */
+    ULAM_QUERY_MAX,             /**< max N */
+    ULAM_QUERY_TWINS,           /**< twins L */
+    ULAM_QUERY_MULTIPLES        /**< multiples L K */
+} ulam_query_type;
+
+/**
+ * Eine Anfrage mit Ergebnis und Bearbeitungszeit.
+ */
+typedef struct
+{
+    ulam_query_type type;       /**< Art der Anfrage */
+    int arg1;                   /**< N bzw. L */
+    int arg2;                   /**< K bei multiples, sonst 0 */
+    int result;                 /**< Ergebnis nach der Auswertung */
+    int64_t latency_ns;         /**< Bearbeitungszeit in ns */
+} ulam_query;
+
+
+/* ============================================================================
+ * Funktions-Prototypen
+ * ========================================================================= */
+
+/**
+ * Liest eine Anfrage aus einer Zeile, ohne sie zu kopieren. Die Zeile muss
+ * nicht mit 0 abgeschlossen sein.
+ *
+ * @param line      Beginn der Zeile (ohne Zeilenende)
+ * @param len       Länge der Zeile
+ * @param query     Ziel für die Anfrage; bei einer ungültigen Zeile wird
+ *                  type auf #ULAM_QUERY_INVALID gesetzt
+ * @return          0, wenn die Zeile eine gültige Anfrage enthält, sonst -1
+ */
+int ulam_query_parse(const char *line, size_t len, ulam_query *query);
+
+/**
+ * Beantwortet einen Stapel von Anfragen. Die Ergebnisse stehen danach in
+ * queries[i].result, die Reihenfolge der Anfragen bleibt unverändert.
+ *
+ * @param queries   Anfragen
+ * @param count     Anzahl der Anfragen
+ */
+void ulam_query_eval_batch(ulam_query queries[], int count);
+
+/**
+ * Schreibt das Ergebnis einer Anfrage als Zeile in einen Puffer. Für
+ * ungültige Anfragen wird "error" geschrieben.
+ *
+ * @param query     ausgewertete Anfrage
+ * @param buffer    Ziel
+ * @param size      Größe des Ziels (mindestens 16 Byte)
+ * @return          Anzahl der geschriebenen Zeichen einschließlich '\n'
+ */
+int ulam_query_format(const ulam_query *query, char *buffer, size_t size);
+
+#endif /* ULAM_QUERY_H */
@@ -0,0 +1,641 @@
+/**
+ * @file
+ * Dieses Modul berechnet die maximalen ULAM-Werte für ganze Intervalle von
+ * Startzahlen (siehe ulam_range.h).
+ *
+ * Jede Spur eines SIMD-Registers verfolgt die ULAM-Folge einer Startzahl.
+ * Gerade und ungerade Schritte werden für alle Spuren berechnet und ohne
+ * Verzweigung per Blend zusammengeführt, das laufende Maximum wird je Spur
+ * mitgeführt. Erreicht eine Spur den Wert 1 oder einen Überlauf, wird ihr
+ * Ergebnis abgelegt und die Spur mit der nächsten Startzahl neu belegt.
+ * Große Intervalle werden zusätzlich über den Scheduler (siehe ulam_sched.h)
+ * auf mehrere Threads verteilt.
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <pthread.h>
+#include <stdlib.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define ULAM_RANGE_X86 1
+#endif
+
+#include "ulam.h"
+#include "ulam_jump.h"
+#include "ulam_overflow.h"
+#include "ulam_parallel.h"
+#include "ulam_sched.h"
+#include "ulam_range.h"
+
+
+/* ============================================================================
+ * Symbolische Konstanten
+ * ========================================================================= */
+
+/** Höchste Anzahl von Spuren eines Kernels (AVX-512: 16 x 32 Bit) */
+#define ULAM_RANGE_MAX_LANES 16
+
+/** Maske, die alle 16 Spuren eines AVX-512-Registers auswählt */
+#define ULAM_RANGE_ALL_LANES ((__mmask16) 0xFFFF)
+
+/** Anzahl der Startzahlen, ab der ein Intervall auf Threads verteilt wird */
+#define ULAM_RANGE_PARALLEL_MIN 65536
+
+/** Körnung, bis zu der der Scheduler ein Intervall zerlegt */
+#define ULAM_RANGE_PARALLEL_GRAIN 4096
+
+
+/* ============================================================================
+ * Typdefinitionen
+ * ========================================================================= */
+
+/**
+ * Auftrag an einen Kernel: die Startzahlen lo bis lo + count - 1 sind zu
+ * berechnen, next ist der Index der nächsten noch nicht vergebenen Zahl.
+ */
+typedef struct
+{
+    int lo;         /* kleinste Startzahl */
+    int count;      /* Anzahl der Startzahlen */
+    int next;       /* Index der nächsten zu vergebenden Startzahl */
+    int *out;       /* Ergebnisfeld, out[i] gehört zur Startzahl lo + i */
+} ulam_range_job;
+
+/** Kernel, der einen Auftrag vollständig bearbeitet */
+typedef void (*ulam_range_kernel)(ulam_range_job *job);
+
+
+/* ============================================================================
+ * Prototypen der privaten Funktionen
+ * ========================================================================= */
+
+/**
+ * Setzt eine ULAM-Folge ab dem Folgenglied an fort und liefert ihr Maximum.
+ * Das Verhalten entspricht ulam_max(), d.h. bei einem Überlauf endet die
+ * Folge mit dem bis dahin erreichten Maximum.
+ *
+ * @param a0        Startzahl der Folge (für die Überlaufstatistik)
+ * @param an        aktuelles Folgenglied (>= 1)
+ * @param max_value bisheriges Maximum der Folge
+ * @return          das Maximum der gesamten Folge
+ */
+static int ulam_range_finish(int a0, int an, int max_value);
+
+/**
+ * Legt die Ergebnisse aller fertigen Spuren ab und belegt diese Spuren mit
+ * den nächsten Startzahlen. Sind keine Startzahlen mehr übrig, werden die
+ * noch laufenden Spuren skalar zu Ende berechnet.
+ *
+ * @param job       der bearbeitete Auftrag
+ * @param lanes     Anzahl der Spuren des Kernels
+ * @param done      Bitmaske der fertigen Spuren
+ * @param an        aktuelle Folgenglieder der Spuren
+ * @param mx        bisherige Maxima der Spuren
+ * @param idx       Ergebnisindex der Spuren oder -1 für unbelegte Spuren
+ * @return          1, wenn der Kernel weiterrechnen soll, 0 wenn der
+ *                  Auftrag vollständig bearbeitet ist
+ */
+static int ulam_range_retire(ulam_range_job *job, int lanes, unsigned done,
+                             int an[], int mx[], int idx[]);
+
+/**
+ * Belegt alle Spuren eines Kernels mit den ersten Startzahlen des Auftrags.
+ *
+ * @param job       der bearbeitete Auftrag
+ * @param lanes     Anzahl der Spuren des Kernels
+ * @param an        aktuelle Folgenglieder der Spuren
+ * @param mx        bisherige Maxima der Spuren
+ * @param idx       Ergebnisindex der Spuren
+ * @return          1, wenn der Kernel rechnen soll, 0 wenn der Auftrag
+ *                  bereits vollständig bearbeitet ist
+ */
+static int ulam_range_start(ulam_range_job *job, int lanes,
+                            int an[], int mx[], int idx[]);
+
+/**
+ * Kernel ohne SIMD: berechnet die Startzahlen nacheinander mit der
+ * Sprungtabelle (siehe ulam_jump.h).
+ *
+ * @param job       der zu bearbeitende Auftrag
+ */
+static void ulam_range_scalar(ulam_range_job *job);
+
+#ifdef ULAM_RANGE_X86
+/**
+ * Kernel für SSE4.1 mit 4 Spuren.
+ *
+ * @param job       der zu bearbeitende Auftrag
+ */
+static void ulam_range_sse4(ulam_range_job *job);
+
+/**
+ * Kernel für AVX2 mit 8 Spuren.
+ *
+ * @param job       der zu bearbeitende Auftrag
+ */
+static void ulam_range_avx2(ulam_range_job *job);
+
+/**
+ * Kernel für AVX-512F mit 16 Spuren.
+ *
+ * @param job       der zu bearbeitende Auftrag
+ */
+static void ulam_range_avx512(ulam_range_job *job);
+#endif
+
+/**
+ * Aufgabe für den Scheduler: bearbeitet die Startzahlen mit den Indizes
+ * first bis last eines Auftrags mit dem ausgewählten Kernel.
+ *
+ * @param first     Index der ersten Startzahl
+ * @param last      Index der letzten Startzahl
+ * @param arg       Zeiger auf den gesamten ulam_range_job
+ */
+static void ulam_range_task(int first, int last, void *arg);
+
+/**
+ * Prüft, ob die CPU die übergebene Befehlssatzerweiterung unterstützt.
+ *
+ * @param isa       zu prüfende Befehlssatzerweiterung
+ * @return          1, wenn die Erweiterung unterstützt wird, 0 sonst
+ */
+static int ulam_range_supported(ulam_isa isa);
+
+/**
+ * Wählt beim ersten Aufruf (über pthread_once) die leistungsfähigste
+ * unterstützte Befehlssatzerweiterung aus.
+ */
+static void ulam_range_select(void);
+
+/**
+ * Aktiviert den Kernel zur übergebenen, unterstützten Erweiterung.
+ *
+ * @param isa       zu aktivierende Befehlssatzerweiterung
+ */
+static void ulam_range_install(ulam_isa isa);
+
+
+/* ============================================================================
+ * Globale Variablen
+ * ========================================================================= */
+
+/** sorgt dafür, dass die automatische Auswahl genau einmal erfolgt */
+static pthread_once_t ulam_range_once = PTHREAD_ONCE_INIT;
+
+/** ausgewählte Befehlssatzerweiterung (nur atomar zugreifen) */
+static int ulam_range_isa = ULAM_ISA_SCALAR;
+
+/** Kernel zur ausgewählten Befehlssatzerweiterung (nur atomar zugreifen) */
+static ulam_range_kernel ulam_range_active_kernel = ulam_range_scalar;
+
+
+/* ============================================================================
+ * Funktionsdefinitionen
+ * ========================================================================= */
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_max_range
+ * ------------------------------------------------------------------------- */
+int ulam_max_range(int lo, int hi, int out[])
+{
+    ulam_range_job job;
+    ulam_range_kernel kernel;
+
+    if (lo > hi || out == NULL)
+    {
+        return -1;
+    }
+
+    /* Für negative Zahlen und 0 gibt es keinen maximalen ULAM-Wert */
+    while (lo < 1 && lo <= hi)
+    {
+        *out++ = -1;
+        lo++;
+    }
+    if (lo > hi)
+    {
+        return 0;
+    }
+
+    pthread_once(&ulam_range_once, ulam_range_select);
+
+    job.lo = lo;
+    job.count = hi - lo + 1;
+    job.next = 0;
+    job.out = out;
+
+    if (job.count >= ULAM_RANGE_PARALLEL_MIN && ulam_parallel_get_threads() > 1)
+    {
+        ulam_sched_parallel_for(0, job.count - 1, ULAM_RANGE_PARALLEL_GRAIN,
+                                ulam_range_task, &job);
+    }
+    else
+    {
+        kernel = __atomic_load_n(&ulam_range_active_kernel, __ATOMIC_ACQUIRE);
+        kernel(&job);
+    }
+
+    return 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_range_task
+ * ------------------------------------------------------------------------- */
+static void ulam_range_task(int first, int last, void *arg)
+{
+    ulam_range_job *job = (ulam_range_job *) arg;
+    ulam_range_job part;
+    ulam_range_kernel kernel;
+
+    part.lo = job->lo + first;
+    part.count = last - first + 1;
+    part.next = 0;
+    part.out = job->out + first;
+    kernel = __atomic_load_n(&ulam_range_active_kernel, __ATOMIC_ACQUIRE);
+    kernel(&part);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_range_get_isa
+ * ------------------------------------------------------------------------- */
+ulam_isa ulam_range_get_isa(void)
+{
+    pthread_once(&ulam_range_once, ulam_range_select);
+
+    return (ulam_isa) __atomic_load_n(&ulam_range_isa, __ATOMIC_ACQUIRE);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_range_set_isa
+ * ------------------------------------------------------------------------- */
+int ulam_range_set_isa(ulam_isa isa)
+{
+    if (!ulam_range_supported(isa))
+    {
+        return -1;
+    }
+
+    /* Die automatische Auswahl darf eine explizite nicht überschreiben */
+    pthread_once(&ulam_range_once, ulam_range_select);
+    ulam_range_install(isa);
+
+    return 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_range_select
+ * ------------------------------------------------------------------------- */
+static void ulam_range_select(void)
+{
+    static const ulam_isa order[] = {
+        ULAM_ISA_AVX512, ULAM_ISA_AVX2, ULAM_ISA_SSE4
+    };
+    int i;
+
+    /* Auswahl der leistungsfähigsten unterstützten Erweiterung */
+    for (i = 0; i < (int) (sizeof(order) / sizeof(order[0])); i++)
+    {
+        if (ulam_range_supported(order[i]))
+        {
+            ulam_range_install(order[i]);
+            return;
+        }
+    }
+    ulam_range_install(ULAM_ISA_SCALAR);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_range_install
+ * ------------------------------------------------------------------------- */
+static void ulam_range_install(ulam_isa isa)
+{
+    ulam_range_kernel kernel;
+
+    switch (isa)
+    {
+#ifdef ULAM_RANGE_X86
+        case ULAM_ISA_SSE4:
+            kernel = ulam_range_sse4;
+            break;
+        case ULAM_ISA_AVX2:
+            kernel = ulam_range_avx2;
+            break;
+        case ULAM_ISA_AVX512:
+            kernel = ulam_range_avx512;
+            break;
+#endif
+        default:
+            kernel = ulam_range_scalar;
+            break;
+    }
+    __atomic_store_n(&ulam_range_active_kernel, kernel, __ATOMIC_RELEASE);
+    __atomic_store_n(&ulam_range_isa, (int) isa, __ATOMIC_RELEASE);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_range_supported
+ * ------------------------------------------------------------------------- */
+static int ulam_range_supported(ulam_isa isa)
+{
+    switch (isa)
+    {
+        case ULAM_ISA_SCALAR:
+            return 1;
+#ifdef ULAM_RANGE_X86
+        case ULAM_ISA_SSE4:
+            return __builtin_cpu_supports("sse4.1") ? 1 : 0;
+        case ULAM_ISA_AVX2:
+            return __builtin_cpu_supports("avx2") ? 1 : 0;
+        case ULAM_ISA_AVX512:
+            return __builtin_cpu_supports("avx512f") ? 1 : 0;
+#endif
+        default:
+            return 0;
+    }
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_range_finish
+ * ------------------------------------------------------------------------- */
+static int ulam_range_finish(int a0, int an, int max_value)
+{
+    while (an > 1)
+    {
+        if (an % 2 == 0)
+        {
+            an = an / 2;
+        }
+        else if (an < ULAM_MAX)
+        {
+            an = 3 * an + 1;
+        }
+        else
+        {
+            /* Überlauf: die Folge endet wie bei ulam_max() */
+            ulam_overflow_record(a0, an);
+            break;
+        }
+
+        if (an > max_value)
+        {
+            max_value = an;
+        }
+    }
+
+    return max_value;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_range_start
+ * ------------------------------------------------------------------------- */
+static int ulam_range_start(ulam_range_job *job, int lanes,
+                            int an[], int mx[], int idx[])
+{
+    int lane;
+
+    for (lane = 0; lane < lanes; lane++)
+    {
+        idx[lane] = -1;
+    }
+
+    return ulam_range_retire(job, lanes, (1u << lanes) - 1u, an, mx, idx);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_range_retire
+ * ------------------------------------------------------------------------- */
+static int ulam_range_retire(ulam_range_job *job, int lanes, unsigned done,
+                             int an[], int mx[], int idx[])
+{
+    int lane;
+
+    for (lane = 0; lane < lanes; lane++)
+    {
+        if ((done & (1u << lane)) == 0)
+        {
+            continue;
+        }
+
+        if (idx[lane] >= 0)
+        {
+            job->out[idx[lane]] = mx[lane];
+
+            /* Fertig, aber nicht bei 1: die Spur ist übergelaufen */
+            if (an[lane] > 1)
+            {
+                ulam_overflow_record(job->lo + idx[lane], an[lane]);
+            }
+        }
+
+        if (job->next < job->count)
+        {
+            /* Spur mit der nächsten Startzahl neu belegen */
+            idx[lane] = job->next;
+            an[lane] = job->lo + job->next;
+            mx[lane] = an[lane];
+            job->next++;
+        }
+        else
+        {
+            idx[lane] = -1;
+            an[lane] = 1;
+            mx[lane] = 1;
+        }
+    }
+
+    if (job->next < job->count)
+    {
+        return 1;
+    }
+
+    /* Keine Startzahlen mehr: die restlichen Spuren lohnen den SIMD-Kernel
+     * nicht mehr und werden skalar beendet */
+    for (lane = 0; lane < lanes; lane++)
+    {
+        if (idx[lane] >= 0)
+        {
+            job->out[idx[lane]] = ulam_range_finish(job->lo + idx[lane],
+                                                    an[lane], mx[lane]);
+            idx[lane] = -1;
+        }
+    }
+
+    return 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_range_scalar
+ * ------------------------------------------------------------------------- */
+static void ulam_range_scalar(ulam_range_job *job)
+{
+    int i;
+
+    for (i = 0; i < job->count; i++)
+    {
+        job->out[i] = ulam_max_jump(job->lo + i);
+    }
+    job->next = job->count;
+}
+
+#ifdef ULAM_RANGE_X86
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_range_sse4
+ * ------------------------------------------------------------------------- */
+__attribute__((target("sse4.1")))
+static void ulam_range_sse4(ulam_range_job *job)
+{
+    int an[ULAM_RANGE_MAX_LANES];   /* Folgenglieder der Spuren */
+    int mx[ULAM_RANGE_MAX_LANES];   /* Maxima der Spuren */
+    int idx[ULAM_RANGE_MAX_LANES];  /* Ergebnisindizes der Spuren */
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i limit = _mm_set1_epi32(ULAM_MAX - 1);
+    __m128i va, vm, odd, done, half, triple;
+    unsigned mask;
+
+    if (!ulam_range_start(job, 4, an, mx, idx))
+    {
+        return;
+    }
+    va = _mm_loadu_si128((const __m128i *) an);
+    vm = _mm_loadu_si128((const __m128i *) mx);
+
+    for (;;)
+    {
+        /* Spuren, die 1 erreicht haben oder überlaufen würden, sind fertig */
+        odd = _mm_cmpeq_epi32(_mm_and_si128(va, one), one);
+        done = _mm_or_si128(_mm_cmpeq_epi32(va, one),
+                            _mm_and_si128(odd, _mm_cmpgt_epi32(va, limit)));
+        mask = (unsigned) _mm_movemask_ps(_mm_castsi128_ps(done));
+        if (mask != 0)
+        {
+            _mm_storeu_si128((__m128i *) an, va);
+            _mm_storeu_si128((__m128i *) mx, vm);
+            if (!ulam_range_retire(job, 4, mask, an, mx, idx))
+            {
+                return;
+            }
+            va = _mm_loadu_si128((const __m128i *) an);
+            vm = _mm_loadu_si128((const __m128i *) mx);
+            continue;
+        }
+
+        /* an / 2 bzw. 3 * an + 1, je nach Parität der Spur */
+        half = _mm_srli_epi32(va, 1);
+        triple = _mm_add_epi32(_mm_add_epi32(va, va), _mm_add_epi32(va, one));
+        va = _mm_blendv_epi8(half, triple, odd);
+        vm = _mm_max_epi32(vm, va);
+    }
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_range_avx2
+ * ------------------------------------------------------------------------- */
+__attribute__((target("avx2")))
+static void ulam_range_avx2(ulam_range_job *job)
+{
+    int an[ULAM_RANGE_MAX_LANES];   /* Folgenglieder der Spuren */
+    int mx[ULAM_RANGE_MAX_LANES];   /* Maxima der Spuren */
+    int idx[ULAM_RANGE_MAX_LANES];  /* Ergebnisindizes der Spuren */
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i limit = _mm256_set1_epi32(ULAM_MAX - 1);
+    __m256i va, vm, odd, done, half, triple;
+    unsigned mask;
+
+    if (!ulam_range_start(job, 8, an, mx, idx))
+    {
+        return;
+    }
+    va = _mm256_loadu_si256((const __m256i *) an);
+    vm = _mm256_loadu_si256((const __m256i *) mx);
+
+    for (;;)
+    {
+        /* Spuren, die 1 erreicht haben oder überlaufen würden, sind fertig */
+        odd = _mm256_cmpeq_epi32(_mm256_and_si256(va, one), one);
+        done = _mm256_or_si256(_mm256_cmpeq_epi32(va, one),
+                               _mm256_and_si256(odd,
+                                                _mm256_cmpgt_epi32(va, limit)));
+        mask = (unsigned) _mm256_movemask_ps(_mm256_castsi256_ps(done));
+        if (mask != 0)
+        {
+            _mm256_storeu_si256((__m256i *) an, va);
+            _mm256_storeu_si256((__m256i *) mx, vm);
+            if (!ulam_range_retire(job, 8, mask, an, mx, idx))
+            {
+                return;
+            }
+            va = _mm256_loadu_si256((const __m256i *) an);
+            vm = _mm256_loadu_si256((const __m256i *) mx);
+            continue;
+        }
+
+        /* an / 2 bzw. 3 * an + 1, je nach Parität der Spur */
+        half = _mm256_srli_epi32(va, 1);
+        triple = _mm256_add_epi32(_mm256_add_epi32(va, va),
+                                  _mm256_add_epi32(va, one));
+        va = _mm256_blendv_epi8(half, triple, odd);
+        vm = _mm256_max_epi32(vm, va);
+    }
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_range_avx512
+ * ------------------------------------------------------------------------- */
+__attribute__((target("avx512f")))
+static void ulam_range_avx512(ulam_range_job *job)
+{
+    int an[ULAM_RANGE_MAX_LANES];   /* Folgenglieder der Spuren */
+    int mx[ULAM_RANGE_MAX_LANES];   /* Maxima der Spuren */
+    int idx[ULAM_RANGE_MAX_LANES];  /* Ergebnisindizes der Spuren */
+    const __m512i one = _mm512_set1_epi32(1);
+    const __m512i limit = _mm512_set1_epi32(ULAM_MAX - 1);
+    __m512i va, vm, half, triple;
+    __mmask16 odd, done;
+
+    if (!ulam_range_start(job, 16, an, mx, idx))
+    {
+        return;
+    }
+    va = _mm512_loadu_si512(an);
+    vm = _mm512_loadu_si512(mx);
+
+    for (;;)
+    {
+        /* Spuren, die 1 erreicht haben oder überlaufen würden, sind fertig */
+        odd = _mm512_test_epi32_mask(va, one);
+        done = _mm512_cmpeq_epi32_mask(va, one)
+               | (odd & _mm512_cmpgt_epi32_mask(va, limit));
+        if (done != 0)
+        {
+            _mm512_storeu_si512(an, va);
+            _mm512_storeu_si512(mx, vm);
+            if (!ulam_range_retire(job, 16, (unsigned) done, an, mx, idx))
+            {
+                return;
+            }
+            va = _mm512_loadu_si512(an);
+            vm = _mm512_loadu_si512(mx);
+            continue;
+        }
+
+        /* an / 2 bzw. 3 * an + 1, je nach Parität der Spur. Die
+         * maskierten Varianten mit voller Maske vermeiden das
+         * _mm512_undefined_epi32() der unmaskierten Intrinsics, für das
+         * GCC bei -O2 fälschlich -Wmaybe-uninitialized meldet */
+        half = _mm512_mask_srli_epi32(va, ULAM_RANGE_ALL_LANES, va, 1);
+        triple = _mm512_add_epi32(_mm512_add_epi32(va, va),
+                                  _mm512_add_epi32(va, one));
+        va = _mm512_mask_blend_epi32(odd, half, triple);
+        vm = _mm512_mask_max_epi32(vm, ULAM_RANGE_ALL_LANES, vm, va);
+    }
+}
+
+#endif /* ULAM_RANGE_X86 */
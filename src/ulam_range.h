@@ -0,0 +1,68 @@
+/**
+ * @file
+ * Dieses Modul berechnet die maximalen ULAM-Werte für ganze Intervalle von
+ * Startzahlen. Mehrere Startzahlen werden gleichzeitig in den Spuren eines
+ * SIMD-Registers berechnet; die passende Befehlssatzerweiterung (SSE4.1,
+ * AVX2, AVX-512) wird zur Laufzeit anhand der CPU ausgewählt.
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+#ifndef ULAM_RANGE_H
+#define ULAM_RANGE_H
+
+/* ============================================================================
+ * Typdefinitionen
+ * ========================================================================= */
+
+/**
+ * Befehlssatzerweiterungen, für die ein Kernel zur Berechnung der maximalen
+ * ULAM-Werte vorhanden ist.
+ */
+typedef enum
+{
+    ULAM_ISA_SCALAR = 0,    /**< ohne SIMD, eine Startzahl nach der anderen */
+    ULAM_ISA_SSE4   = 1,    /**< SSE4.1, 4 Startzahlen gleichzeitig */
+    ULAM_ISA_AVX2   = 2,    /**< AVX2, 8 Startzahlen gleichzeitig */
+    ULAM_ISA_AVX512 = 3     /**< AVX-512F, 16 Startzahlen gleichzeitig */
+} ulam_isa;
+
+
+/* ============================================================================
+ * Funktions-Prototypen
+ * ========================================================================= */
+
+/**
+ * Berechnet für alle ganzen Zahlen a0 von lo bis einschließlich hi den Wert
+ * ulam_max(a0) und legt ihn in out[a0 - lo] ab. Die Ergebnisse stimmen mit
+ * denen von ulam_max() überein, auch bei Überlauf und für Zahlen < 1.
+ *
+ * @param lo        kleinste Startzahl des Intervalls
+ * @param hi        größte Startzahl des Intervalls
+ * @param out       Feld mit mindestens hi - lo + 1 Einträgen für die
+ *                  maximalen ULAM-Werte
+ * @return          0 bei Erfolg, -1 wenn lo > hi oder out NULL ist
+ */
+int ulam_max_range(int lo, int hi, int out[]);
+
+/**
+ * Liefert die Befehlssatzerweiterung, die ulam_max_range() verwendet. Beim
+ * ersten Aufruf wird die leistungsfähigste von der CPU unterstützte
+ * Erweiterung ausgewählt.
+ *
+ * @return          die verwendete Befehlssatzerweiterung
+ */
+ulam_isa ulam_range_get_isa(void);
+
+/**
+ * Legt fest, welche Befehlssatzerweiterung ulam_max_range() verwenden soll,
+ * z.B. um die Kernel miteinander zu vergleichen.
+ *
+ * @param isa       gewünschte Befehlssatzerweiterung
+ * @return          0 bei Erfolg, -1 wenn die CPU die Erweiterung nicht
+ *                  unterstützt
+ */
+int ulam_range_set_isa(ulam_isa isa);
+
+#endif /* ULAM_RANGE_H */
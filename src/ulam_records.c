@@ -0,0 +1,453 @@
+/**
+ * @file
+ * Dieses Modul implementiert die Suche nach Pfadrekorden (siehe
+ * ulam_records.h).
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "ulam_records.h"
+#include "ulam_wide.h"
+
+
+/* ============================================================================
+ * Symbolische Konstanten
+ * ========================================================================= */
+
+#if ULAM_RECORDS_K < 1 || ULAM_RECORDS_K > 24
+#error "ULAM_RECORDS_K muss zwischen 1 und 24 liegen"
+#endif
+
+/** Anzahl der Restklassen */
+#define ULAM_RECORDS_SIZE ((uint64_t) 1 << ULAM_RECORDS_K)
+
+/** Startwert der FNV-1a-Prüfsumme */
+#define ULAM_RECORDS_FNV_OFFSET 14695981039346656037ULL
+
+/** Multiplikator der FNV-1a-Prüfsumme */
+#define ULAM_RECORDS_FNV_PRIME 1099511628211ULL
+
+
+/* ============================================================================
+ * Typdefinitionen
+ * ========================================================================= */
+
+/**
+ * Inhalt einer Checkpoint-Datei.
+ */
+typedef struct
+{
+    char magic[8];              /**< #ULAM_RECORDS_MAGIC */
+    uint32_t version;           /**< #ULAM_RECORDS_VERSION */
+    uint32_t k;                 /**< #ULAM_RECORDS_K beim Speichern */
+    uint64_t next;              /**< siehe #ulam_records_state */
+    uint64_t record_seed;
+    uint64_t record_peak_lo;    /**< niedrige 64 Bit von record_peak */
+    uint64_t record_peak_hi;    /**< hohe 64 Bit von record_peak */
+    uint64_t records;
+    uint64_t traced;
+    uint64_t checksum;          /**< FNV-1a über alle Felder davor */
+} ulam_records_file;
+
+
+/* ============================================================================
+ * Globale Variablen
+ * ========================================================================= */
+
+/**
+ * Schranke a * h + b für die Folgenglieder bis zum Fallen unter n je
+ * Restklasse oder a = 0, wenn die Klasse nicht sicher fällt.
+ */
+static uint64_t *ulam_records_a = NULL;
+static uint64_t *ulam_records_b = NULL;
+
+/** Restklassen, die verfolgt werden müssen, aufsteigend */
+static uint32_t *ulam_records_survivors = NULL;
+
+/** Anzahl der Einträge in ulam_records_survivors */
+static uint32_t ulam_records_survivor_count = 0;
+
+/** größtes a und b aller fallenden Klassen */
+static uint64_t ulam_records_max_a = 0;
+static uint64_t ulam_records_max_b = 0;
+
+/** sorgt für einen einmaligen Aufbau der Tabelle */
+static pthread_once_t ulam_records_once = PTHREAD_ONCE_INIT;
+
+
+/* ============================================================================
+ * Prototypen der privaten Funktionen
+ * ========================================================================= */
+
+/**
+ * Baut die Tabelle der Restklassen auf.
+ */
+static void ulam_records_prepare(void);
+
+/**
+ * Prüft eine Startzahl. Ist sie ein Rekord, werden state und der Rekord
+ * aktualisiert.
+ *
+ * @param state     Stand der Suche
+ * @param n         Startzahl
+ * @return          1 für einen Rekord, 0 sonst, -1 bei Überlauf
+ */
+static int ulam_records_trace(ulam_records_state *state, uint64_t n);
+
+/**
+ * Setzt eine FNV-1a-Prüfsumme über weitere Bytes fort.
+ */
+static uint64_t ulam_records_fnv(uint64_t hash, const void *data, 
+                                 size_t size);
+
+
+/* ============================================================================
+ * Funktionsdefinitionen
+ * ========================================================================= */
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_records_init
+ * ------------------------------------------------------------------------- */
+void ulam_records_init(ulam_records_state *state)
+{
+    memset(state, 0, sizeof(*state));
+    state->next = 1;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_records_scan
+ * ------------------------------------------------------------------------- */
+long ulam_records_scan(ulam_records_state *state, uint64_t hi,
+                       ulam_records_callback callback, void *arg)
+{
+    const uint64_t mask = ULAM_RECORDS_SIZE - 1;
+    long found = 0;
+    uint64_t n;
+    uint64_t h;
+    uint64_t r;
+    uint32_t i;
+    int record;
+
+    if (hi >= ((uint64_t) 1 << 62))
+    {
+        return -1;
+    }
+
+    pthread_once(&ulam_records_once, ulam_records_prepare);
+    if (ulam_records_survivors == NULL)
+    {
+        return -1;
+    }
+
+    n = state->next;
+    while (n <= hi)
+    {
+        h = n >> ULAM_RECORDS_K;
+        r = n & mask;
+
+        /* Ganzer Block: fallen alle Klassen sicher, nur die übrigen
+         * verfolgen */
+        if (h > 0 && r == 0 && hi - n >= mask
+            && (ulam_u128) ulam_records_max_a * h + ulam_records_max_b
+               <= state->record_peak)
+        {
+            for (i = 0; i < ulam_records_survivor_count; i++)
+            {
+                record = ulam_records_trace(state, n 
+                                            + ulam_records_survivors[i]);
+                if (record < 0)
+                {
+                    state->next = n + ulam_records_survivors[i];
+                    return -1;
+                }
+                if (record > 0)
+                {
+                    found++;
+                    if (callback != NULL
+                        && callback(state->record_seed, state->record_peak,
+                                    arg) != 0)
+                    {
+                        state->next = n + ulam_records_survivors[i] + 1;
+                        return found;
+                    }
+                }
+            }
+            n += ULAM_RECORDS_SIZE;
+            continue;
+        }
+
+        /* Einzelne Startzahl, z.B. am Anfang oder am Rand des Bereichs */
+        if (h == 0 || ulam_records_a[r] == 0
+            || (ulam_u128) ulam_records_a[r] * h + ulam_records_b[r]
+               > state->record_peak)
+        {
+            record = ulam_records_trace(state, n);
+            if (record < 0)
+            {
+                state->next = n;
+                return -1;
+            }
+            if (record > 0)
+            {
+                found++;
+                if (callback != NULL
+                    && callback(state->record_seed, state->record_peak, 
+                                arg) != 0)
+                {
+                    state->next = n + 1;
+                    return found;
+                }
+            }
+        }
+        n++;
+    }
+
+    state->next = n;
+
+    return found;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_records_save
+ * ------------------------------------------------------------------------- */
+int ulam_records_save(const char *path, const ulam_records_state *state)
+{
+    ulam_records_file content;
+    char tmp_path[4096];
+    FILE *file;
+    int ok;
+
+    if (path == NULL || (size_t) snprintf(tmp_path, sizeof(tmp_path), 
+                                          "%s.tmp", path) 
+                        >= sizeof(tmp_path))
+    {
+        return -1;
+    }
+
+    memset(&content, 0, sizeof(content));
+    memcpy(content.magic, ULAM_RECORDS_MAGIC, sizeof(ULAM_RECORDS_MAGIC));
+    content.version = ULAM_RECORDS_VERSION;
+    content.k = ULAM_RECORDS_K;
+    content.next = state->next;
+    content.record_seed = state->record_seed;
+    content.record_peak_lo = (uint64_t) state->record_peak;
+    content.record_peak_hi = (uint64_t) (state->record_peak >> 64);
+    content.records = state->records;
+    content.traced = state->traced;
+    content.checksum = ulam_records_fnv(ULAM_RECORDS_FNV_OFFSET, &content,
+                                        offsetof(ulam_records_file, 
+                                                 checksum));
+
+    file = fopen(tmp_path, "wb");
+    if (file == NULL)
+    {
+        return -1;
+    }
+    ok = fwrite(&content, sizeof(content), 1, file) == 1;
+    ok = (fclose(file) == 0) && ok;
+    ok = ok && rename(tmp_path, path) == 0;
+    if (!ok)
+    {
+        remove(tmp_path);
+        return -1;
+    }
+
+    return 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_records_load
+ * ------------------------------------------------------------------------- */
+int ulam_records_load(const char *path, ulam_records_state *state)
+{
+    ulam_records_file content;
+    FILE *file;
+    int ok;
+
+    file = (path != NULL) ? fopen(path, "rb") : NULL;
+    if (file == NULL)
+    {
+        return -1;
+    }
+    ok = fread(&content, sizeof(content), 1, file) == 1;
+    fclose(file);
+
+    if (!ok
+        || memcmp(content.magic, ULAM_RECORDS_MAGIC, 
+                  sizeof(ULAM_RECORDS_MAGIC)) != 0
+        || content.version != ULAM_RECORDS_VERSION
+        || content.next < 1
+        || content.checksum 
+           != ulam_records_fnv(ULAM_RECORDS_FNV_OFFSET, &content,
+                               offsetof(ulam_records_file, checksum)))
+    {
+        return -1;
+    }
+
+    /* K darf sich zwischen zwei Läufen ändern, der Stand hängt nicht davon
+     * ab */
+    state->next = content.next;
+    state->record_seed = content.record_seed;
+    state->record_peak = ((ulam_u128) content.record_peak_hi << 64)
+                         | content.record_peak_lo;
+    state->records = content.records;
+    state->traced = content.traced;
+
+    return 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_records_prepare
+ * ------------------------------------------------------------------------- */
+static void ulam_records_prepare(void)
+{
+    uint64_t r;
+    uint64_t x;         /* T^j(r) */
+    uint64_t coeff;     /* Faktor von h in T^j(2^K * h + r) */
+    uint64_t a;
+    uint64_t b;
+    uint32_t count = 0;
+    int j;
+
+    ulam_records_a = (uint64_t *) malloc(ULAM_RECORDS_SIZE 
+                                         * sizeof(uint64_t));
+    ulam_records_b = (uint64_t *) malloc(ULAM_RECORDS_SIZE 
+                                         * sizeof(uint64_t));
+    ulam_records_survivors = (uint32_t *) malloc(ULAM_RECORDS_SIZE 
+                                                 * sizeof(uint32_t));
+    if (ulam_records_a == NULL || ulam_records_b == NULL 
+        || ulam_records_survivors == NULL)
+    {
+        free(ulam_records_a);
+        free(ulam_records_b);
+        free(ulam_records_survivors);
+        ulam_records_survivors = NULL;
+        return;
+    }
+
+    for (r = 0; r < ULAM_RECORDS_SIZE; r++)
+    {
+        /* Schranke beginnt mit n selbst */
+        x = r;
+        coeff = ULAM_RECORDS_SIZE;
+        a = coeff;
+        b = r;
+        ulam_records_a[r] = 0;
+        ulam_records_b[r] = 0;
+
+        for (j = 0; j < ULAM_RECORDS_K; j++)
+        {
+            if (x % 2 == 1)
+            {
+                /* Größter Wert eines ungeraden Schritts ist 3 * x + 1 */
+                a = (3 * coeff > a) ? 3 * coeff : a;
+                b = (3 * x + 1 > b) ? 3 * x + 1 : b;
+                x = (3 * x + 1) / 2;
+                coeff = coeff / 2 * 3;
+            }
+            else
+            {
+                x = x / 2;
+                coeff = coeff / 2;
+            }
+
+            /* coeff * h + x < 2^K * h + r für alle h >= 1 */
+            if (coeff < ULAM_RECORDS_SIZE 
+                && x < r + (ULAM_RECORDS_SIZE - coeff))
+            {
+                ulam_records_a[r] = a;
+                ulam_records_b[r] = b;
+                break;
+            }
+        }
+
+        if (ulam_records_a[r] == 0)
+        {
+            ulam_records_survivors[count++] = (uint32_t) r;
+        }
+        else
+        {
+            if (a > ulam_records_max_a)
+            {
+                ulam_records_max_a = a;
+            }
+            if (b > ulam_records_max_b)
+            {
+                ulam_records_max_b = b;
+            }
+        }
+    }
+
+    ulam_records_survivor_count = count;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_records_trace
+ * ------------------------------------------------------------------------- */
+static int ulam_records_trace(ulam_records_state *state, uint64_t n)
+{
+    ulam_u128 x = n;
+    ulam_u128 peak;
+
+    state->traced++;
+
+    /* Nur bis unter n oder über den bisherigen Rekord verfolgen; n selbst
+     * kann nur am Anfang der Suche (1, 2) über dem Rekord liegen */
+    while (x <= state->record_peak)
+    {
+        if (x < n || x == 1)
+        {
+            return 0;
+        }
+        if ((x & 1) == 0)
+        {
+            x >>= __builtin_ctzll((uint64_t) x | ((uint64_t) 1 << 63));
+        }
+        else
+        {
+            x = 3 * x + 1;
+        }
+    }
+
+    /* Neuer Rekord: vollständiges Maximum bestimmen */
+    peak = ulam_max128(n);
+    if (peak == 0)
+    {
+        return -1;
+    }
+    state->record_seed = n;
+    state->record_peak = peak;
+    state->records++;
+
+    return 1;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_records_fnv
+ * ------------------------------------------------------------------------- */
+static uint64_t ulam_records_fnv(uint64_t hash, const void *data, 
+                                 size_t size)
+{
+    const unsigned char *bytes = (const unsigned char *) data;
+    size_t i;
+
+    for (i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= ULAM_RECORDS_FNV_PRIME;
+    }
+
+    return hash;
+}
@@ -0,0 +1,134 @@
+/**
+ * @file
+ * Dieses Modul sucht Pfadrekorde, d.h. Startzahlen, deren maximaler
+ * ULAM-Wert größer ist als der aller kleineren Startzahlen (z.B. 27 mit
+ * 9232 oder 77671 mit 1570824736). Die Suche rechnet mit 64-Bit-Startzahlen
+ * und 128-Bit-Folgengliedern und ist für Startzahlen bis 2^48 ausgelegt.
+ *
+ * Fällt die Folge einer Startzahl n unter n, bevor sie den bisherigen
+ * Rekord R übersteigt, ist n kein Rekord: das Maximum des restlichen Teils
+ * ist das einer kleineren Startzahl und damit höchstens R. Für
+ * n = 2^K * h + r legen die K niedrigsten Bits r die Paritäten der ersten
+ * K Schritte fest. Eine Tabelle enthält für jede Restklasse r, ob die Folge
+ * innerhalb dieser Schritte sicher unter n fällt (z.B. alle geraden n und
+ * n = 1 mod 4), und eine Schranke a * h + b für die Folgenglieder bis
+ * dahin. Solche Klassen werden übersprungen, solange die Schranke R nicht
+ * übersteigt; nur die übrigen Klassen (für K = 16 etwa 2,6 %) werden
+ * verfolgt, und zwar nur bis unter n oder über R.
+ *
+ * Der Fortschritt steht in einem #ulam_records_state, der als
+ * Checkpoint-Datei gespeichert und wieder geladen werden kann, so dass
+ * lange Suchen fortgesetzt werden können.
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+#ifndef ULAM_RECORDS_H
+#define ULAM_RECORDS_H
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <stdint.h>
+
+#include "ulam_wide.h"
+
+
+/* ============================================================================
+ * Symbolische Konstanten
+ * ========================================================================= */
+
+#ifndef ULAM_RECORDS_K
+/**
+ * Anzahl der Bits der Restklassen. Die Tabelle hat 2^K Einträge zu je
+ * 16 Byte; der Wert kann beim Übersetzen mit -DULAM_RECORDS_K=... zwischen
+ * 1 und 24 gewählt werden.
+ */
+#define ULAM_RECORDS_K 16
+#endif
+
+/** Kennung am Anfang einer Checkpoint-Datei */
+#define ULAM_RECORDS_MAGIC "ULAMREC"
+
+/** Version des Formats der Checkpoint-Datei */
+#define ULAM_RECORDS_VERSION 1
+
+
+/* ============================================================================
+ * Typdefinitionen
+ * ========================================================================= */
+
+/**
+ * Stand einer Suche.
+ */
+typedef struct
+{
+    uint64_t next;              /**< nächste zu prüfende Startzahl */
+    uint64_t record_seed;       /**< letzter gefundener Rekord */
+    ulam_u128 record_peak;      /**< dessen Maximum R */
+    uint64_t records;           /**< Anzahl der gefundenen Rekorde */
+    uint64_t traced;            /**< Anzahl der verfolgten Startzahlen */
+} ulam_records_state;
+
+/**
+ * Wird für jeden gefundenen Rekord in aufsteigender Reihenfolge aufgerufen.
+ *
+ * @param seed      Startzahl des Rekords
+ * @param peak      ihr maximaler ULAM-Wert
+ * @param arg       Argument, das an ulam_records_scan() übergeben wurde
+ * @return          0, um die Suche fortzusetzen, sonst wird sie nach
+ *                  diesem Rekord beendet
+ */
+typedef int (*ulam_records_callback)(uint64_t seed, ulam_u128 peak, void *arg);
+
+
+/* ============================================================================
+ * Funktions-Prototypen
+ * ========================================================================= */
+
+/**
+ * Setzt den Stand auf den Anfang der Suche (Startzahl 1).
+ *
+ * @param state     Stand
+ */
+void ulam_records_init(ulam_records_state *state);
+
+/**
+ * Setzt die Suche ab state->next bis einschließlich hi fort und ruft
+ * callback für jeden Rekord auf. Danach ist state->next die erste nicht
+ * geprüfte Startzahl.
+ *
+ * @param state     Stand der Suche
+ * @param hi        größte zu prüfende Startzahl (< 2^62)
+ * @param callback  Funktion für die Rekorde oder NULL
+ * @param arg       Argument für callback
+ * @return          Anzahl der gefundenen Rekorde oder -1, wenn hi zu groß
+ *                  ist oder ein Folgenglied nicht mit 128 Bit darstellbar
+ *                  ist
+ */
+long ulam_records_scan(ulam_records_state *state, uint64_t hi,
+                       ulam_records_callback callback, void *arg);
+
+/**
+ * Speichert den Stand in einer Checkpoint-Datei. Die Datei wird zunächst
+ * unter path.tmp geschrieben und dann umbenannt, so dass ein Abbruch den
+ * vorigen Checkpoint nicht zerstört.
+ *
+ * @param path      Pfad der Datei
+ * @param state     Stand
+ * @return          0 oder -1 bei einem Fehler
+ */
+int ulam_records_save(const char *path, const ulam_records_state *state);
+
+/**
+ * Lädt den Stand aus einer Checkpoint-Datei und prüft deren Prüfsumme.
+ *
+ * @param path      Pfad der Datei
+ * @param state     Ziel für den Stand
+ * @return          0 oder -1, wenn die Datei fehlt oder ungültig ist
+ */
+int ulam_records_load(const char *path, ulam_records_state *state);
+
+#endif /* ULAM_RECORDS_H */
@@ -0,0 +1,158 @@
+/**
+ * @file
+ * Programm zur Suche nach Pfadrekorden (siehe ulam_records.h). Jeder
+ * gefundene Rekord wird sofort als Zeile "startzahl maximum" ausgegeben.
+ *
+ * Aufruf: ulam_records [-c checkpoint] [-e intervall] hi
+ *
+ * <ul>
+ *   <li> -c   Checkpoint-Datei; ist sie vorhanden, wird die Suche dort
+ *             fortgesetzt, sonst bei 1 begonnen
+ *   <li> -e   Anzahl der Startzahlen zwischen zwei Checkpoints
+ * </ul>
+ *
+ * Nach einem Abbruch werden die Rekorde seit dem letzten Checkpoint beim
+ * Fortsetzen erneut ausgegeben.
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "ulam_records.h"
+
+
+/* ============================================================================
+ * Symbolische Konstanten
+ * ========================================================================= */
+
+/** Voreingestellte Anzahl der Startzahlen zwischen zwei Checkpoints */
+#define ULAM_RECORDS_FIND_EVERY (1ULL << 32)
+
+
+/* ============================================================================
+ * Prototypen der privaten Funktionen
+ * ========================================================================= */
+
+/**
+ * Gibt einen Rekord aus.
+ */
+static int ulam_records_find_print(uint64_t seed, ulam_u128 peak, void *arg);
+
+
+/* ============================================================================
+ * Funktionsdefinitionen
+ * ========================================================================= */
+
+/* ----------------------------------------------------------------------------
+ * Funktion: main
+ * ------------------------------------------------------------------------- */
+int main(int argc, char **argv)
+{
+    ulam_records_state state;
+    const char *checkpoint = NULL;
+    uint64_t every = ULAM_RECORDS_FIND_EVERY;
+    uint64_t hi = 0;
+    uint64_t chunk_hi;
+    int i;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+        {
+            checkpoint = argv[++i];
+        }
+        else if (strcmp(argv[i], "-e") == 0 && i + 1 < argc)
+        {
+            every = strtoull(argv[++i], NULL, 0);
+        }
+        else if (argv[i][0] != '-' && hi == 0)
+        {
+            hi = strtoull(argv[i], NULL, 0);
+        }
+        else
+        {
+            hi = 0;
+            break;
+        }
+    }
+    if (hi == 0 || every == 0)
+    {
+        fprintf(stderr, "Aufruf: %s [-c checkpoint] [-e intervall] hi\n",
+                argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (checkpoint == NULL || ulam_records_load(checkpoint, &state) != 0)
+    {
+        ulam_records_init(&state);
+    }
+    else
+    {
+        fprintf(stderr, "Fortsetzung bei %llu nach %llu Rekorden\n",
+                (unsigned long long) state.next, 
+                (unsigned long long) state.records);
+    }
+
+    /* Abschnittsweise suchen und nach jedem Abschnitt sichern */
+    while (state.next <= hi)
+    {
+        chunk_hi = (hi - state.next >= every) ? state.next + every - 1 : hi;
+        if (ulam_records_scan(&state, chunk_hi, ulam_records_find_print,
+                              NULL) < 0)
+        {
+            fprintf(stderr, "Ueberlauf bei %llu\n", 
+                    (unsigned long long) state.next);
+            return EXIT_FAILURE;
+        }
+        fflush(stdout);
+
+        if (checkpoint != NULL && ulam_records_save(checkpoint, &state) != 0)
+        {
+            fprintf(stderr, "Checkpoint %s kann nicht geschrieben werden\n",
+                    checkpoint);
+            return EXIT_FAILURE;
+        }
+    }
+
+    fprintf(stderr, "%llu Rekorde bis %llu, %llu Startzahlen verfolgt\n",
+            (unsigned long long) state.records, (unsigned long long) hi,
+            (unsigned long long) state.traced);
+
+    return EXIT_SUCCESS;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_records_find_print
+ * ------------------------------------------------------------------------- */
+static int ulam_records_find_print(uint64_t seed, ulam_u128 peak, void *arg)
+{
+    char digits[40];
+    int n = 0;
+
+    (void) arg;
+
+    /* 128-Bit-Zahl rückwärts in Ziffern zerlegen */
+    do
+    {
+        digits[n++] = (char) ('0' + (int) (peak % 10));
+        peak /= 10;
+    } while (peak > 0);
+
+    printf("%llu ", (unsigned long long) seed);
+    while (n > 0)
+    {
+        putchar(digits[--n]);
+    }
+    putchar('\n');
+
+    return 0;
+}
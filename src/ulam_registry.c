@@ -0,0 +1,134 @@
+/**
+ * @file
+ * Dieses Modul implementiert die Registratur der Datenblöcke einzelner
+ * Threads (siehe ulam_registry.h).
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <stdlib.h>
+
+#include "ulam_registry.h"
+
+
+/* ============================================================================
+ * Prototypen der privaten Funktionen
+ * ========================================================================= */
+
+/**
+ * Rechnet beim Ende eines Threads seinen Block in den Sammelblock ein,
+ * entfernt ihn aus der Liste und gibt ihn frei (Destruktor des
+ * Thread-Schlüssels).
+ *
+ * @param block     Nutzdaten des Blocks
+ */
+static void ulam_registry_retire(void *block);
+
+
+/* ============================================================================
+ * Funktionsdefinitionen
+ * ========================================================================= */
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_registry_local
+ * ------------------------------------------------------------------------- */
+void *ulam_registry_local(ulam_registry *registry)
+{
+    ulam_registry_node *node;
+    void *block;
+
+    if (__atomic_load_n(&registry->key_created, __ATOMIC_ACQUIRE))
+    {
+        block = pthread_getspecific(registry->key);
+        if (block != NULL)
+        {
+            return block;
+        }
+    }
+
+    node = (ulam_registry_node *)
+           calloc(1, sizeof(ulam_registry_node) + registry->size);
+    pthread_mutex_lock(&registry->lock);
+    if (!registry->key_created)
+    {
+        if (pthread_key_create(&registry->key, ulam_registry_retire) == 0)
+        {
+            __atomic_store_n(&registry->key_created, 1, __ATOMIC_RELEASE);
+        }
+    }
+    if (node == NULL || !registry->key_created)
+    {
+        /* Ohne Speicher zählt der Thread im gemeinsamen Ersatzblock mit;
+         * er wird nicht am Schlüssel vermerkt, da er keinem Thread gehört */
+        free(node);
+        registry->fallback_listed = 1;
+        pthread_mutex_unlock(&registry->lock);
+        return registry->fallback;
+    }
+    node->registry = registry;
+    node->next = registry->blocks;
+    if (registry->blocks != NULL)
+    {
+        registry->blocks->prev = node;
+    }
+    registry->blocks = node;
+    block = node + 1;
+    pthread_mutex_unlock(&registry->lock);
+
+    pthread_setspecific(registry->key, block);
+
+    return block;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_registry_visit
+ * ------------------------------------------------------------------------- */
+void ulam_registry_visit(ulam_registry *registry,
+                         ulam_registry_visitor visit, void *arg)
+{
+    ulam_registry_node *node;
+
+    pthread_mutex_lock(&registry->lock);
+    visit(registry->retired, arg);
+    if (registry->fallback_listed)
+    {
+        visit(registry->fallback, arg);
+    }
+    for (node = registry->blocks; node != NULL; node = node->next)
+    {
+        visit(node + 1, arg);
+    }
+    pthread_mutex_unlock(&registry->lock);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_registry_retire
+ * ------------------------------------------------------------------------- */
+static void ulam_registry_retire(void *block)
+{
+    ulam_registry_node *node = (ulam_registry_node *) block - 1;
+    ulam_registry *registry = node->registry;
+
+    pthread_mutex_lock(&registry->lock);
+    registry->merge(block, registry->retired);
+    if (node->prev != NULL)
+    {
+        node->prev->next = node->next;
+    }
+    else
+    {
+        registry->blocks = node->next;
+    }
+    if (node->next != NULL)
+    {
+        node->next->prev = node->prev;
+    }
+    pthread_mutex_unlock(&registry->lock);
+
+    free(node);
+}
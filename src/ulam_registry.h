@@ -0,0 +1,119 @@
+/**
+ * @file
+ * Dieses Modul verwaltet Datenblöcke, die jeder Thread für sich beschreibt
+ * und die beim Auslesen über alle Threads zusammengefasst werden, bspw. die
+ * Zähler von ulam_stats.h und ulam_overflow.h.
+ *
+ * Jeder Thread erhält beim ersten Zugriff einen mit 0 gefüllten Block, der
+ * in die Liste der Registratur eingetragen wird. Der Zugriff auf den
+ * eigenen Block kommt danach ohne Sperre aus. Kann kein Speicher angelegt
+ * werden, teilen sich die betroffenen Threads einen Ersatzblock, den der
+ * Aufrufer bereitstellt.
+ *
+ * Endet ein Thread, wird sein Block in einen Sammelblock für beendete
+ * Threads eingerechnet, aus der Liste entfernt und freigegeben. Die Liste
+ * enthält so nur die Blöcke laufender Threads, auch wenn ein Prozess sehr
+ * viele kurzlebige Threads startet.
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+#ifndef ULAM_REGISTRY_H
+#define ULAM_REGISTRY_H
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <stddef.h>
+#include <pthread.h>
+
+
+/* ============================================================================
+ * Typdefinitionen
+ * ========================================================================= */
+
+/**
+ * Funktion, die für jeden Block der Registratur aufgerufen wird.
+ *
+ * @param block     Nutzdaten des Blocks
+ * @param arg       Argument, das an ulam_registry_visit() übergeben wurde
+ */
+typedef void (*ulam_registry_visitor)(void *block, void *arg);
+
+struct ulam_registry;
+
+/**
+ * Kopf eines Blocks in der Liste; die Nutzdaten folgen direkt dahinter.
+ */
+typedef struct ulam_registry_node
+{
+    struct ulam_registry *registry;     /**< Registratur des Blocks */
+    struct ulam_registry_node *prev;    /**< vorheriger Block der Liste */
+    struct ulam_registry_node *next;    /**< nächster Block der Liste */
+} ulam_registry_node;
+
+/**
+ * Registratur der Blöcke aller Threads. Wird statisch mit
+ * #ULAM_REGISTRY_INIT angelegt.
+ */
+typedef struct ulam_registry
+{
+    size_t size;                /**< Größe der Nutzdaten eines Blocks */
+    void *fallback;             /**< Ersatzblock bei fehlendem Speicher */
+    void *retired;              /**< Sammelblock der beendeten Threads */
+    ulam_registry_visitor merge; /**< rechnet einen Block (1. Argument) in
+                                      den Sammelblock (2. Argument) ein */
+    pthread_mutex_t lock;       /**< schützt die folgenden Felder */
+    pthread_key_t key;          /**< Block des jeweiligen Threads */
+    int key_created;            /**< 1, wenn key angelegt ist */
+    int fallback_listed;        /**< 1, wenn der Ersatzblock benutzt wird */
+    ulam_registry_node *blocks; /**< Liste der Blöcke laufender Threads */
+} ulam_registry;
+
+
+/* ============================================================================
+ * Makros
+ * ========================================================================= */
+
+/**
+ * Initialisierung einer statischen Registratur.
+ *
+ * @param size      Größe der Nutzdaten eines Blocks
+ * @param fallback  Zeiger auf den Ersatzblock (mit 0 gefüllt)
+ * @param retired   Zeiger auf den Sammelblock (mit 0 gefüllt)
+ * @param merge     Funktion, die einen Block in den Sammelblock einrechnet
+ */
+#define ULAM_REGISTRY_INIT(size, fallback, retired, merge) \
+    { (size), (fallback), (retired), (merge), PTHREAD_MUTEX_INITIALIZER, \
+      0, 0, 0, NULL }
+
+
+/* ============================================================================
+ * Funktions-Prototypen
+ * ========================================================================= */
+
+/**
+ * Liefert den Block des aufrufenden Threads und legt ihn beim ersten
+ * Aufruf an.
+ *
+ * @param registry  Registratur
+ * @return          Nutzdaten des Blocks, nie NULL
+ */
+void *ulam_registry_local(ulam_registry *registry);
+
+/**
+ * Ruft visit unter der Sperre der Registratur für jeden Block auf,
+ * einschließlich des Sammelblocks der beendeten Threads. Die
+ * Blöcke anderer Threads können dabei gleichzeitig beschrieben werden und
+ * sind daher atomar zu lesen bzw. zu schreiben.
+ *
+ * @param registry  Registratur
+ * @param visit     Funktion, die jeden Block erhält
+ * @param arg       beliebiges Argument für visit
+ */
+void ulam_registry_visit(ulam_registry *registry,
+                         ulam_registry_visitor visit, void *arg);
+
+#endif /* ULAM_REGISTRY_H */
@@ -0,0 +1,310 @@
+/**
+ * @file
+ * Dieses Modul implementiert den Index für Bereichsmaxima der Werte
+ * ulam_max() (siehe ulam_rmq.h).
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <limits.h>
+
+#include "ulam_range.h"
+#include "ulam_rmq.h"
+#include "ulam_sched.h"
+
+
+/* ============================================================================
+ * Symbolische Konstanten
+ * ========================================================================= */
+
+/** Zweierlogarithmus der Blockgröße, ein Block entspricht den Bits einer
+ *  32-Bit-Maske */
+#define ULAM_RMQ_BLOCK_BITS 5
+
+/** Anzahl der Startzahlen je Block */
+#define ULAM_RMQ_BLOCK (1 << ULAM_RMQ_BLOCK_BITS)
+
+/** Körnung des parallelen Aufbaus in Blöcken */
+#define ULAM_RMQ_GRAIN 256
+
+/** maximale Anzahl der Ebenen der Sparse Table */
+#define ULAM_RMQ_LEVELS 32
+
+
+/* ============================================================================
+ * Globale Variablen
+ * ========================================================================= */
+
+/** ulam_max() je Startzahl, Index 0 ist -1 */
+static int *ulam_rmq_peaks = NULL;
+
+/** Maske der absteigenden Maxima im Block je Startzahl */
+static uint32_t *ulam_rmq_masks = NULL;
+
+/** Ebene k: Startzahl des Maximums der Blöcke b bis b + 2^k - 1 */
+static int *ulam_rmq_table[ULAM_RMQ_LEVELS];
+
+/** Anzahl der Ebenen der Sparse Table */
+static int ulam_rmq_levels = 0;
+
+/** Anzahl der Blöcke */
+static int ulam_rmq_blocks = 0;
+
+/** größte Startzahl im Index */
+static int ulam_rmq_hi = 0;
+
+
+/* ============================================================================
+ * Prototypen der privaten Funktionen
+ * ========================================================================= */
+
+/**
+ * Aufgabe für ulam_sched_parallel_for(): berechnet die Masken der Blöcke lo
+ * bis hi und Ebene 0 der Sparse Table.
+ */
+static void ulam_rmq_mask_task(int lo, int hi, void *arg);
+
+/**
+ * Aufgabe für ulam_sched_parallel_for(): berechnet die Einträge lo bis hi
+ * einer Ebene der Sparse Table aus der vorigen Ebene.
+ */
+static void ulam_rmq_level_task(int lo, int hi, void *arg);
+
+/**
+ * Liefert die Startzahl des Maximums von i bis j innerhalb eines Blocks.
+ */
+static inline int ulam_rmq_in_block(int i, int j);
+
+/**
+ * Liefert von zwei Startzahlen die mit dem größeren Maximum, bei Gleichheit
+ * die linke a.
+ */
+static inline int ulam_rmq_better(int a, int b);
+
+
+/* ============================================================================
+ * Funktionsdefinitionen
+ * ========================================================================= */
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_rmq_build
+ * ------------------------------------------------------------------------- */
+int ulam_rmq_build(int hi)
+{
+    size_t count;
+    int blocks;
+    int levels;
+    int ok;
+    int k;
+
+    if (hi < 1 || hi == INT_MAX)
+    {
+        return -1;
+    }
+
+    ulam_rmq_release();
+
+    count = (size_t) hi + 1;
+    blocks = (int) ((count + ULAM_RMQ_BLOCK - 1) >> ULAM_RMQ_BLOCK_BITS);
+    levels = 1;
+    while ((1 << levels) <= blocks)
+    {
+        levels++;
+    }
+
+    ulam_rmq_peaks = (int *) malloc(count * sizeof(int));
+    ulam_rmq_masks = (uint32_t *) malloc(count * sizeof(uint32_t));
+    ok = ulam_rmq_peaks != NULL && ulam_rmq_masks != NULL;
+    for (k = 0; k < levels; k++)
+    {
+        ulam_rmq_table[k] = (int *) malloc((size_t) blocks * sizeof(int));
+        ok = ok && ulam_rmq_table[k] != NULL;
+    }
+    ulam_rmq_levels = levels;
+    ulam_rmq_blocks = blocks;
+
+    /* Maxima (selbst parallel), dann Masken und Blockmaxima je Block */
+    ok = ok && ulam_max_range(1, hi, ulam_rmq_peaks + 1) == 0;
+    if (!ok)
+    {
+        ulam_rmq_release();
+        return -1;
+    }
+    ulam_rmq_peaks[0] = -1;
+    ulam_rmq_hi = hi;
+
+    ulam_sched_parallel_for(0, blocks - 1, ULAM_RMQ_GRAIN, ulam_rmq_mask_task,
+                            NULL);
+
+    /* Ebene k fasst je zwei Einträge der Ebene k - 1 zusammen */
+    for (k = 1; k < levels; k++)
+    {
+        ulam_sched_parallel_for(0, blocks - (1 << k), ULAM_RMQ_GRAIN,
+                                ulam_rmq_level_task, &k);
+    }
+
+    return 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_rmq_release
+ * ------------------------------------------------------------------------- */
+void ulam_rmq_release(void)
+{
+    int k;
+
+    free(ulam_rmq_peaks);
+    free(ulam_rmq_masks);
+    for (k = 0; k < ulam_rmq_levels; k++)
+    {
+        free(ulam_rmq_table[k]);
+        ulam_rmq_table[k] = NULL;
+    }
+
+    ulam_rmq_peaks = NULL;
+    ulam_rmq_masks = NULL;
+    ulam_rmq_levels = 0;
+    ulam_rmq_blocks = 0;
+    ulam_rmq_hi = 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_rmq_get_hi
+ * ------------------------------------------------------------------------- */
+int ulam_rmq_get_hi(void)
+{
+    return ulam_rmq_hi;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_rmq_query
+ * ------------------------------------------------------------------------- */
+int ulam_rmq_query(int lo, int hi, int *peak)
+{
+    int first;          /* erster und letzter Block des Bereichs */
+    int last;
+    int best;
+    int k;
+
+    if (lo < 1 || lo > hi || hi > ulam_rmq_hi)
+    {
+        return -1;
+    }
+
+    first = lo >> ULAM_RMQ_BLOCK_BITS;
+    last = hi >> ULAM_RMQ_BLOCK_BITS;
+
+    if (first == last)
+    {
+        best = ulam_rmq_in_block(lo, hi);
+    }
+    else
+    {
+        /* Teilblöcke am Rand und vollständige Blöcke dazwischen, von links
+         * nach rechts, damit bei Gleichheit die kleinste Startzahl gewinnt */
+        best = ulam_rmq_in_block(lo, (first << ULAM_RMQ_BLOCK_BITS)
+                                     + ULAM_RMQ_BLOCK - 1);
+        if (first + 1 < last)
+        {
+            k = 31 - __builtin_clz((unsigned int) (last - first - 1));
+            best = ulam_rmq_better(best, ulam_rmq_table[k][first + 1]);
+            best = ulam_rmq_better(best, 
+                                   ulam_rmq_table[k][last - (1 << k)]);
+        }
+        best = ulam_rmq_better(best, ulam_rmq_in_block(
+                                         last << ULAM_RMQ_BLOCK_BITS, hi));
+    }
+
+    if (peak != NULL)
+    {
+        *peak = ulam_rmq_peaks[best];
+    }
+
+    return best;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_rmq_mask_task
+ * ------------------------------------------------------------------------- */
+static void ulam_rmq_mask_task(int lo, int hi, void *arg)
+{
+    int stack[ULAM_RMQ_BLOCK];  /* Positionen absteigender Maxima */
+    uint32_t mask;
+    int top;
+    int start;
+    int end;
+    int block;
+    int j;
+
+    (void) arg;
+
+    for (block = lo; block <= hi; block++)
+    {
+        start = block << ULAM_RMQ_BLOCK_BITS;
+        end = (block == ulam_rmq_blocks - 1) ? ulam_rmq_hi 
+                                              : start + ULAM_RMQ_BLOCK - 1;
+        mask = 0;
+        top = 0;
+
+        for (j = start; j <= end; j++)
+        {
+            /* Kleinere Werte verdecken; gleiche bleiben für die linkeste
+             * Startzahl erhalten */
+            while (top > 0 && ulam_rmq_peaks[stack[top - 1]] 
+                              < ulam_rmq_peaks[j])
+            {
+                top--;
+                mask &= ~((uint32_t) 1 << (stack[top] - start));
+            }
+            stack[top++] = j;
+            mask |= (uint32_t) 1 << (j - start);
+            ulam_rmq_masks[j] = mask;
+        }
+
+        ulam_rmq_table[0][block] = start + __builtin_ctz(mask);
+    }
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_rmq_level_task
+ * ------------------------------------------------------------------------- */
+static void ulam_rmq_level_task(int lo, int hi, void *arg)
+{
+    int k = *(int *) arg;
+    int *prev = ulam_rmq_table[k - 1];
+    int *level = ulam_rmq_table[k];
+    int half = 1 << (k - 1);
+    int block;
+
+    for (block = lo; block <= hi; block++)
+    {
+        level[block] = ulam_rmq_better(prev[block], prev[block + half]);
+    }
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_rmq_in_block
+ * ------------------------------------------------------------------------- */
+static inline int ulam_rmq_in_block(int i, int j)
+{
+    uint32_t mask = ulam_rmq_masks[j] 
+                    >> (i & (ULAM_RMQ_BLOCK - 1)) 
+                    << (i & (ULAM_RMQ_BLOCK - 1));
+
+    return (j & ~(ULAM_RMQ_BLOCK - 1)) + __builtin_ctz(mask);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_rmq_better
+ * ------------------------------------------------------------------------- */
+static inline int ulam_rmq_better(int a, int b)
+{
+    return (ulam_rmq_peaks[b] > ulam_rmq_peaks[a]) ? b : a;
+}
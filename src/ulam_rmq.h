@@ -0,0 +1,67 @@
+/**
+ * @file
+ * Dieses Modul beantwortet Bereichsanfragen der Form "welche Startzahl in
+ * [lo, hi] hat den größten Wert ulam_max() und wie groß ist er" in
+ * konstanter Zeit.
+ *
+ * Der Index wird einmal für die Startzahlen 1 bis hi aufgebaut und teilt sie
+ * in Blöcke zu 32 Startzahlen. Für jede Startzahl j speichert eine
+ * 32-Bit-Maske, welche Startzahlen des Blocks bis j auf dem Stapel der
+ * absteigenden Maxima liegen; das Maximum eines Teilblocks [i, j] ist dann
+ * das niedrigste gesetzte Bit der Maske von j ab Position i. Über die
+ * Blockmaxima wird eine Sparse Table gelegt, deren Ebene k die Maxima von
+ * 2^k aufeinanderfolgenden Blöcken enthält. Eine Anfrage kombiniert
+ * höchstens zwei Teilblöcke und zwei Einträge der Sparse Table.
+ *
+ * Der Speicherbedarf beträgt 8 Byte je Startzahl (Maximum und Maske) und
+ * 4 * log2(hi / 32) Byte je Block für die Sparse Table, bei hi = 10^8 also
+ * insgesamt rund 11 Byte je Startzahl. Aufbau und Freigabe
+ * dürfen nicht gleichzeitig mit Anfragen erfolgen; Anfragen untereinander
+ * können parallel laufen.
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+#ifndef ULAM_RMQ_H
+#define ULAM_RMQ_H
+
+/* ============================================================================
+ * Funktions-Prototypen
+ * ========================================================================= */
+
+/**
+ * Baut den Index für die Startzahlen 1 bis hi parallel auf (siehe
+ * ulam_sched.h). Ein bereits vorhandener Index wird ersetzt.
+ *
+ * @param hi        größte Startzahl im Index (1 <= hi < INT_MAX)
+ * @return          0, wenn der Index aufgebaut wurde, oder -1, wenn hi
+ *                  ungültig ist oder nicht genügend Speicher vorhanden ist
+ */
+int ulam_rmq_build(int hi);
+
+/**
+ * Gibt den Index frei.
+ */
+void ulam_rmq_release(void);
+
+/**
+ * Liefert die größte Startzahl im Index.
+ *
+ * @return          die größte Startzahl oder 0, wenn kein Index aufgebaut ist
+ */
+int ulam_rmq_get_hi(void);
+
+/**
+ * Liefert die kleinste Startzahl a0 in [lo, hi] mit dem größten Wert
+ * ulam_max(a0).
+ *
+ * @param lo        kleinste Startzahl des Bereichs (>= 1)
+ * @param hi        größte Startzahl des Bereichs (<= ulam_rmq_get_hi())
+ * @param peak      Ziel für ulam_max() der gefundenen Startzahl oder NULL
+ * @return          die gefundene Startzahl oder -1, wenn der Bereich leer
+ *                  ist oder nicht im Index liegt
+ */
+int ulam_rmq_query(int lo, int hi, int *peak);
+
+#endif /* ULAM_RMQ_H */
@@ -0,0 +1,331 @@
+/**
+ * @file
+ * Dieses Modul implementiert den Index der Läufe gleicher maximaler
+ * ULAM-Werte (siehe ulam_runs.h).
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "ulam.h"
+#include "ulam_groups.h"
+#include "ulam_runs.h"
+#include "ulam_shard.h"
+
+
+/* ============================================================================
+ * Typdefinitionen
+ * ========================================================================= */
+
+/**
+ * Liste der Läufe in Reihenfolge der Startzahlen, die beim Aufbau des Index
+ * gefüllt wird.
+ */
+typedef struct
+{
+    int *runs;          /**< abwechselnd Start und Länge */
+    int count;          /**< Anzahl der Läufe in der Liste */
+    int capacity;       /**< Anzahl der Läufe, für die Platz reserviert ist */
+    int failed;         /**< 1, wenn nicht genügend Speicher vorhanden war */
+} ulam_runs_list;
+
+
+/* ============================================================================
+ * Globale Variablen
+ * ========================================================================= */
+
+/**
+ * Startzahlen aller Läufe, nach Länge und innerhalb einer Länge aufsteigend
+ * sortiert. Die Läufe der Länge len liegen in
+ * ulam_runs_starts[ulam_runs_offsets[len]] bis
+ * ulam_runs_starts[ulam_runs_offsets[len + 1] - 1].
+ */
+static int *ulam_runs_starts = NULL;
+
+/** Beginn der Läufe je Länge, ulam_runs_max_len + 2 Einträge */
+static int *ulam_runs_offsets = NULL;
+
+/** größte Lauflänge im Index */
+static int ulam_runs_max_len = 0;
+
+/** größte Startzahl im Index */
+static int ulam_runs_hi = 0;
+
+
+/* ============================================================================
+ * Prototypen der privaten Funktionen
+ * ========================================================================= */
+
+/**
+ * Hängt einen Lauf an die Liste der Läufe an und vergrößert die Liste bei
+ * Bedarf (Callback für ulam_groups()).
+ *
+ * @param start     erste Startzahl des Laufs
+ * @param len       Länge des Laufs
+ * @param peak      maximaler ULAM-Wert des Laufs (nicht benötigt)
+ * @param arg       die Liste (ulam_runs_list)
+ * @return          0 oder -1, wenn nicht genügend Speicher vorhanden ist
+ */
+static int ulam_runs_append(int start, int len, int peak, void *arg);
+
+/**
+ * Sortiert die gesammelten Läufe nach Länge und ersetzt damit den Index.
+ * Die Liste wird dabei freigegeben.
+ *
+ * @param list      Läufe in Reihenfolge der Startzahlen
+ * @param hi        größte Startzahl im Index
+ * @return          0 oder -1, wenn nicht genügend Speicher vorhanden ist
+ */
+static int ulam_runs_install(ulam_runs_list *list, int hi);
+
+
+/* ============================================================================
+ * Funktionsdefinitionen
+ * ========================================================================= */
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_runs_build
+ * ------------------------------------------------------------------------- */
+int ulam_runs_build(int hi)
+{
+    ulam_runs_list list;
+
+    if (hi < 1)
+    {
+        return -1;
+    }
+
+    /* Läufe mit mindestens zwei Gliedern in einem Durchlauf bestimmen */
+    memset(&list, 0, sizeof(list));
+    if (ulam_groups(1, hi, 2, ulam_runs_append, &list) < 0 || list.failed)
+    {
+        free(list.runs);
+        return -1;
+    }
+
+    return ulam_runs_install(&list, hi);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_runs_build_shards
+ * ------------------------------------------------------------------------- */
+int ulam_runs_build_shards(const char *const paths[], int count)
+{
+    ulam_runs_list list;
+    int lo;
+    int hi;
+
+    /* Der Index beginnt immer bei 1 */
+    if (ulam_shard_bounds(paths, count, &lo, &hi) != 0 || lo != 1)
+    {
+        return -1;
+    }
+
+    memset(&list, 0, sizeof(list));
+    if (ulam_shard_merge(paths, count, 2, ulam_runs_append, &list) < 0
+        || list.failed)
+    {
+        free(list.runs);
+        return -1;
+    }
+
+    return ulam_runs_install(&list, hi);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_runs_release
+ * ------------------------------------------------------------------------- */
+void ulam_runs_release(void)
+{
+    free(ulam_runs_starts);
+    free(ulam_runs_offsets);
+    ulam_runs_starts = NULL;
+    ulam_runs_offsets = NULL;
+    ulam_runs_max_len = 0;
+    ulam_runs_hi = 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_runs_get_hi
+ * ------------------------------------------------------------------------- */
+int ulam_runs_get_hi(void)
+{
+    return ulam_runs_hi;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_runs_twins
+ * ------------------------------------------------------------------------- */
+int ulam_runs_twins(int limit)
+{
+    /* Zwillinge sind Mehrlinge mit der Anzahl 2 */
+    if (limit < 1)
+    {
+        return -1;
+    }
+
+    return ulam_runs_multiples(limit, 2);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_runs_multiples
+ * ------------------------------------------------------------------------- */
+int ulam_runs_multiples(int limit, int number)
+{
+    const int *starts;
+    int last_start;     /* größter zulässiger Start eines Mehrlings */
+    int multiples_index;
+    int candidate;
+    int len;
+    int left;
+    int right;
+    int mid;
+
+    if (number < 2 || limit < number)
+    {
+        return -1;
+    }
+
+    /* Außerhalb des Index wird wie bisher gerechnet */
+    if (limit > ulam_runs_hi)
+    {
+        return ulam_multiples(limit, number);
+    }
+
+    last_start = limit - number + 1;
+    multiples_index = -1;
+
+    for (len = number; len <= ulam_runs_max_len; len++)
+    {
+        /* Letzten Lauf der Länge len mit Start <= last_start suchen */
+        starts = ulam_runs_starts + ulam_runs_offsets[len];
+        left = 0;
+        right = ulam_runs_offsets[len + 1] - ulam_runs_offsets[len];
+        while (left < right)
+        {
+            mid = left + (right - left) / 2;
+            if (starts[mid] <= last_start)
+            {
+                left = mid + 1;
+            }
+            else
+            {
+                right = mid;
+            }
+        }
+
+        if (left > 0)
+        {
+            /* Der Mehrling liegt am Ende des Laufs, höchstens bei
+             * last_start */
+            candidate = starts[left - 1] + len - number;
+            if (candidate > last_start)
+            {
+                candidate = last_start;
+            }
+            if (candidate > multiples_index)
+            {
+                multiples_index = candidate;
+            }
+        }
+    }
+
+    return multiples_index;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_runs_append
+ * ------------------------------------------------------------------------- */
+static int ulam_runs_append(int start, int len, int peak, void *arg)
+{
+    ulam_runs_list *list = (ulam_runs_list *) arg;
+    int *grown;
+    int new_capacity;
+
+    (void) peak;
+
+    if (list->count == list->capacity)
+    {
+        new_capacity = (list->capacity > 0) ? 2 * list->capacity : 4096;
+        grown = (int *) realloc(list->runs, 
+                                (size_t) new_capacity * 2 * sizeof(int));
+        if (grown == NULL)
+        {
+            list->failed = 1;
+            return -1;
+        }
+        list->runs = grown;
+        list->capacity = new_capacity;
+    }
+
+    list->runs[2 * list->count] = start;
+    list->runs[2 * list->count + 1] = len;
+    list->count++;
+
+    return 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_runs_install
+ * ------------------------------------------------------------------------- */
+static int ulam_runs_install(ulam_runs_list *list, int hi)
+{
+    int *runs = list->runs;
+    int *starts;
+    int *offsets;
+    int count = list->count;
+    int max_len = 0;
+    int i;
+
+    for (i = 0; i < count; i++)
+    {
+        if (runs[2 * i + 1] > max_len)
+        {
+            max_len = runs[2 * i + 1];
+        }
+    }
+
+    /* Läufe stabil nach Länge sortieren (Sortieren durch Zählen) */
+    starts = (int *) malloc(((size_t) count + 1) * sizeof(int));
+    offsets = (int *) calloc((size_t) max_len + 2, sizeof(int));
+    if (starts == NULL || offsets == NULL)
+    {
+        free(runs);
+        free(starts);
+        free(offsets);
+        return -1;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        offsets[runs[2 * i + 1] + 1]++;
+    }
+    for (i = 1; i <= max_len + 1; i++)
+    {
+        offsets[i] += offsets[i - 1];
+    }
+    for (i = 0; i < count; i++)
+    {
+        starts[offsets[runs[2 * i + 1]]++] = runs[2 * i];
+    }
+    
+    /* Durch das Einsortieren zeigt offsets[len] auf das Ende von len */
+    memmove(offsets + 1, offsets, ((size_t) max_len + 1) * sizeof(int));
+    offsets[0] = 0;
+    free(runs);
+
+    ulam_runs_release();
+    ulam_runs_starts = starts;
+    ulam_runs_offsets = offsets;
+    ulam_runs_max_len = max_len;
+    ulam_runs_hi = hi;
+
+    return 0;
+}
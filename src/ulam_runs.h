@@ -0,0 +1,90 @@
+/**
+ * @file
+ * Dieses Modul verwaltet einen Index der Läufe gleicher maximaler
+ * ULAM-Werte. Ein Lauf ist eine maximale Folge benachbarter Startzahlen
+ * s, s + 1, ..., s + len - 1 mit demselben Wert ulam_max(). Das Ergebnis von
+ * ulam_multiples(limit, number) hängt nur von diesen Läufen ab: es ist der
+ * größte Wert min(s + len - number, limit - number + 1) über alle Läufe mit
+ * len >= number, deren Start s höchstens limit - number + 1 ist.
+ *
+ * Der Index wird einmal für das Intervall [1, hi] aufgebaut und speichert
+ * die Startzahlen aller Läufe mit mindestens zwei Gliedern, getrennt nach
+ * Lauflänge und jeweils aufsteigend sortiert. Eine Anfrage sucht für jede
+ * Länge >= number binär den letzten passenden Lauf. Anfragen mit limit > hi
+ * werden wie bisher mit ulam_multiples() berechnet. Statt im eigenen
+ * Prozess kann der Index auch aus Shards aufgebaut werden, die mehrere
+ * Prozesse berechnet haben (siehe ulam_shard.h).
+ *
+ * Aufbau und Freigabe des Index dürfen nicht gleichzeitig mit Anfragen
+ * erfolgen; Anfragen untereinander können parallel laufen.
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+#ifndef ULAM_RUNS_H
+#define ULAM_RUNS_H
+
+/* ============================================================================
+ * Funktions-Prototypen
+ * ========================================================================= */
+
+/**
+ * Baut den Index der Läufe für die Startzahlen 1 bis hi auf. Ein bereits
+ * vorhandener Index wird ersetzt.
+ *
+ * @param hi        größte Startzahl im Index (>= 1)
+ * @return          0, wenn der Index aufgebaut wurde, oder -1, wenn hi < 1
+ *                  ist oder nicht genügend Speicher vorhanden ist
+ */
+int ulam_runs_build(int hi);
+
+/**
+ * Baut den Index der Läufe aus Shard-Dateien auf, die zusammen die
+ * Startzahlen 1 bis hi lückenlos abdecken (siehe ulam_shard_merge()). Ein
+ * bereits vorhandener Index wird ersetzt.
+ *
+ * @param paths     Pfade der Shard-Dateien in aufsteigender Reihenfolge
+ * @param count     Anzahl der Shards
+ * @return          0, wenn der Index aufgebaut wurde, oder -1, wenn ein
+ *                  Shard fehlt oder ungültig ist, der erste Shard nicht bei
+ *                  1 beginnt oder nicht genügend Speicher vorhanden ist
+ */
+int ulam_runs_build_shards(const char *const paths[], int count);
+
+/**
+ * Gibt den Index der Läufe frei.
+ */
+void ulam_runs_release(void);
+
+/**
+ * Liefert die größte Startzahl im Index.
+ *
+ * @return          die größte Startzahl oder 0, wenn kein Index aufgebaut ist
+ */
+int ulam_runs_get_hi(void);
+
+/**
+ * Liefert dasselbe Ergebnis wie ulam_twins(limit) mit Hilfe des Index.
+ *
+ * @param limit     ganze Zahl, bis zu der nach ULAM-Zwillingen
+ *                  gesucht werden soll.
+ * @return          die kleinere Zahl des letzten ULAM-Zwillingspaars
+ *                  oder -1, wenn es kein solches Paar gibt oder limit < 1 ist
+ */
+int ulam_runs_twins(int limit);
+
+/**
+ * Liefert dasselbe Ergebnis wie ulam_multiples(limit, number) mit Hilfe des
+ * Index in O(L * log n) für L verschiedene Lauflängen.
+ *
+ * @param limit     positive ganze Zahl, bis zu der nach ULAM-Mehrlingen
+ *                  gesucht werden soll.
+ * @param number    positive Zahl, die die Anzahl der gesuchten Mehrlinge angibt
+ * @return          die kleinste Zahl des letzten "ULAM-Mehrlings" oder -1, wenn
+ *                  keine Mehrlinge gefunden wurden, limit < number oder
+ *                  number < 2.
+ */
+int ulam_runs_multiples(int limit, int number);
+
+#endif /* ULAM_RUNS_H */
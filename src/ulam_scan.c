@@ -0,0 +1,375 @@
+/**
+ * @file
+ * Dieses Modul implementiert den fortsetzbaren Stand einer Suche nach
+ * ULAM-Mehrlingen (siehe ulam_scan.h).
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "ulam.h"
+#include "ulam_range.h"
+#include "ulam_scan.h"
+
+
+/* ============================================================================
+ * Symbolische Konstanten
+ * ========================================================================= */
+
+/** Anzahl der Startzahlen, die je Block mit ulam_max_range() berechnet
+ *  werden */
+#define ULAM_SCAN_BLOCK 65536
+
+/** Startwert der FNV-1a-Prüfsumme */
+#define ULAM_SCAN_FNV_OFFSET 14695981039346656037ULL
+
+/** Multiplikator der FNV-1a-Prüfsumme */
+#define ULAM_SCAN_FNV_PRIME 1099511628211ULL
+
+
+/* ============================================================================
+ * Typdefinitionen
+ * ========================================================================= */
+
+/**
+ * Kopf einer Datei mit dem Stand einer Suche. Dahinter folgen die Einträge
+ * best[0] bis best[max_len] als int32_t.
+ */
+typedef struct
+{
+    char magic[8];          /**< #ULAM_SCAN_MAGIC */
+    uint32_t version;       /**< #ULAM_SCAN_VERSION */
+    int32_t frontier;       /**< siehe #ulam_scan_state */
+    int32_t run_peak;
+    int32_t run_len;
+    int32_t max_len;
+    uint32_t reserved;      /**< 0 */
+    uint64_t checksum;      /**< FNV-1a über Kopf bis hier und Einträge */
+} ulam_scan_header;
+
+
+/* ============================================================================
+ * Prototypen der privaten Funktionen
+ * ========================================================================= */
+
+/**
+ * Schließt den offenen Lauf, der bei end endet, und trägt für jede Anzahl
+ * bis zu seiner Länge die letzte Gruppe ein.
+ *
+ * @param state     Stand
+ * @param end       letzte Startzahl des Laufs
+ * @return          0 oder -1, wenn nicht genügend Speicher vorhanden ist
+ */
+static int ulam_scan_close_run(ulam_scan_state *state, int end);
+
+/**
+ * Setzt eine FNV-1a-Prüfsumme über weitere Bytes fort.
+ */
+static uint64_t ulam_scan_fnv(uint64_t hash, const void *data, size_t size);
+
+
+/* ============================================================================
+ * Funktionsdefinitionen
+ * ========================================================================= */
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_scan_init
+ * ------------------------------------------------------------------------- */
+void ulam_scan_init(ulam_scan_state *state)
+{
+    memset(state, 0, sizeof(*state));
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_scan_free
+ * ------------------------------------------------------------------------- */
+void ulam_scan_free(ulam_scan_state *state)
+{
+    free(state->best);
+    ulam_scan_init(state);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_scan_extend
+ * ------------------------------------------------------------------------- */
+int ulam_scan_extend(ulam_scan_state *state, int limit)
+{
+    int *peaks;
+    int count;
+    int block_lo;
+    int block_hi;
+    int i;
+
+    if (limit <= state->frontier)
+    {
+        return 0;
+    }
+
+    /* Eigener Puffer je Aufruf, damit Stände parallel wachsen können */
+    count = (limit - state->frontier < ULAM_SCAN_BLOCK) 
+            ? limit - state->frontier : ULAM_SCAN_BLOCK;
+    peaks = (int *) malloc((size_t) count * sizeof(int));
+    if (peaks == NULL)
+    {
+        return -1;
+    }
+
+    while (state->frontier < limit)
+    {
+        block_lo = state->frontier + 1;
+        block_hi = (limit - block_lo >= ULAM_SCAN_BLOCK) 
+                   ? block_lo + ULAM_SCAN_BLOCK - 1 : limit;
+        ulam_max_range(block_lo, block_hi, peaks);
+
+        /* Über den Abstand zu block_lo, damit block_hi = INT_MAX nicht
+         * überläuft */
+        for (i = 0; i <= block_hi - block_lo; i++)
+        {
+            if (state->run_len > 0 && peaks[i] == state->run_peak)
+            {
+                state->run_len++;
+                continue;
+            }
+
+            if (ulam_scan_close_run(state, block_lo + i - 1) != 0)
+            {
+                /* Front vor dem neuen Lauf, der Stand bleibt gültig */
+                state->frontier = block_lo + i - 1;
+                free(peaks);
+                return -1;
+            }
+            state->run_peak = peaks[i];
+            state->run_len = 1;
+        }
+
+        state->frontier = block_hi;
+    }
+    free(peaks);
+
+    return 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_scan_multiples
+ * ------------------------------------------------------------------------- */
+int ulam_scan_multiples(ulam_scan_state *state, int limit, int number)
+{
+    if (number < 2 || limit < number)
+    {
+        return -1;
+    }
+
+    if (limit < state->frontier)
+    {
+        return ulam_multiples(limit, number);
+    }
+    if (ulam_scan_extend(state, limit) != 0)
+    {
+        return ulam_multiples(limit, number);
+    }
+
+    /* Der offene Lauf liegt hinter allen abgeschlossenen */
+    if (state->run_len >= number)
+    {
+        return state->frontier - number + 1;
+    }
+    if (number <= state->max_len)
+    {
+        return state->best[number];
+    }
+
+    return -1;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_scan_twins
+ * ------------------------------------------------------------------------- */
+int ulam_scan_twins(ulam_scan_state *state, int limit)
+{
+    /* Zwillinge sind Mehrlinge mit der Anzahl 2 */
+    if (limit < 1)
+    {
+        return -1;
+    }
+
+    return ulam_scan_multiples(state, limit, 2);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_scan_save
+ * ------------------------------------------------------------------------- */
+int ulam_scan_save(const char *path, const ulam_scan_state *state)
+{
+    ulam_scan_header header;
+    char tmp_path[4096];
+    int32_t none = -1;
+    FILE *file;
+    size_t count;
+    int ok;
+
+    if (path == NULL || (size_t) snprintf(tmp_path, sizeof(tmp_path), 
+                                          "%s.tmp", path) 
+                        >= sizeof(tmp_path))
+    {
+        return -1;
+    }
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, ULAM_SCAN_MAGIC, sizeof(ULAM_SCAN_MAGIC));
+    header.version = ULAM_SCAN_VERSION;
+    header.frontier = state->frontier;
+    header.run_peak = state->run_peak;
+    header.run_len = state->run_len;
+    header.max_len = state->max_len;
+    count = (size_t) state->max_len + 1;
+    header.checksum = ulam_scan_fnv(ULAM_SCAN_FNV_OFFSET, &header,
+                                    offsetof(ulam_scan_header, checksum));
+    header.checksum = (state->best != NULL)
+                      ? ulam_scan_fnv(header.checksum, state->best,
+                                      count * sizeof(int32_t))
+                      : ulam_scan_fnv(header.checksum, &none, 
+                                      sizeof(int32_t));
+
+    file = fopen(tmp_path, "wb");
+    if (file == NULL)
+    {
+        return -1;
+    }
+    ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = ok && ((state->best != NULL) 
+                ? fwrite(state->best, sizeof(int32_t), count, file) == count
+                : fwrite(&none, sizeof(int32_t), 1, file) == 1);
+    ok = (fclose(file) == 0) && ok;
+    ok = ok && rename(tmp_path, path) == 0;
+    if (!ok)
+    {
+        remove(tmp_path);
+        return -1;
+    }
+
+    return 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_scan_load
+ * ------------------------------------------------------------------------- */
+int ulam_scan_load(const char *path, ulam_scan_state *state)
+{
+    ulam_scan_header header;
+    FILE *file;
+    int *best = NULL;
+    size_t count = 0;
+    uint64_t checksum;
+    int ok;
+
+    file = (path != NULL) ? fopen(path, "rb") : NULL;
+    if (file == NULL)
+    {
+        return -1;
+    }
+
+    ok = fread(&header, sizeof(header), 1, file) == 1
+         && memcmp(header.magic, ULAM_SCAN_MAGIC, 
+                   sizeof(ULAM_SCAN_MAGIC)) == 0
+         && header.version == ULAM_SCAN_VERSION
+         && header.frontier >= 0 && header.max_len >= 0
+         && header.run_len >= 0 && header.run_len <= header.frontier;
+    if (ok)
+    {
+        count = (size_t) header.max_len + 1;
+        best = (int *) malloc(count * sizeof(int));
+        ok = best != NULL && fread(best, sizeof(int32_t), count, file) 
+                             == count;
+    }
+    fclose(file);
+
+    if (ok)
+    {
+        checksum = ulam_scan_fnv(ULAM_SCAN_FNV_OFFSET, &header,
+                                 offsetof(ulam_scan_header, checksum));
+        checksum = ulam_scan_fnv(checksum, best, count * sizeof(int32_t));
+        ok = checksum == header.checksum;
+    }
+    if (!ok)
+    {
+        free(best);
+        return -1;
+    }
+
+    free(state->best);
+    state->frontier = header.frontier;
+    state->run_peak = header.run_peak;
+    state->run_len = header.run_len;
+    state->max_len = header.max_len;
+    state->best = best;
+
+    return 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_scan_close_run
+ * ------------------------------------------------------------------------- */
+static int ulam_scan_close_run(ulam_scan_state *state, int end)
+{
+    int *grown;
+    int n;
+
+    if (state->run_len < 2)
+    {
+        return 0;
+    }
+
+    /* Platz für alle Anzahlen bis zur Länge des Laufs */
+    if (state->run_len > state->max_len)
+    {
+        grown = (int *) realloc(state->best, 
+                                ((size_t) state->run_len + 1) * sizeof(int));
+        if (grown == NULL)
+        {
+            return -1;
+        }
+        for (n = state->max_len + 1; n <= state->run_len; n++)
+        {
+            grown[n] = -1;
+        }
+        grown[0] = -1;
+        grown[1] = -1;
+        state->best = grown;
+        state->max_len = state->run_len;
+    }
+
+    /* Letzte Gruppe aus n Mehrlingen endet mit dem Lauf */
+    for (n = 2; n <= state->run_len; n++)
+    {
+        state->best[n] = end - n + 1;
+    }
+
+    return 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_scan_fnv
+ * ------------------------------------------------------------------------- */
+static uint64_t ulam_scan_fnv(uint64_t hash, const void *data, size_t size)
+{
+    const unsigned char *bytes = (const unsigned char *) data;
+    size_t i;
+
+    for (i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= ULAM_SCAN_FNV_PRIME;
+    }
+
+    return hash;
+}
@@ -0,0 +1,130 @@
+/**
+ * @file
+ * Dieses Modul verwaltet den Stand einer fortsetzbaren Suche nach
+ * ULAM-Zwillingen und -Mehrlingen für wachsende Obergrenzen. Werden
+ * ulam_twins() bzw. ulam_multiples() nacheinander mit steigendem limit
+ * aufgerufen (z.B. 10^6, 2 * 10^6, ...), berechnet jeder Aufruf alle
+ * Startzahlen unterhalb von limit erneut. Ein #ulam_scan_state merkt sich
+ * dagegen, bis zu welcher Startzahl (Front) bereits gesucht wurde, den
+ * offenen Lauf gleicher Maxima an der Front und je Anzahl number den
+ * Beginn der letzten abgeschlossenen Mehrlingsgruppe. Eine größere
+ * Obergrenze kostet dann nur die neuen Startzahlen.
+ *
+ * Der Stand kann in einer Datei gespeichert und wieder geladen werden, so
+ * dass lange Suchen nach einem Abbruch fortgesetzt werden können.
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+#ifndef ULAM_SCAN_H
+#define ULAM_SCAN_H
+
+/* ============================================================================
+ * Symbolische Konstanten
+ * ========================================================================= */
+
+/** Kennung am Anfang einer Datei mit dem Stand einer Suche */
+#define ULAM_SCAN_MAGIC "ULAMSCN"
+
+/** Version des Dateiformats */
+#define ULAM_SCAN_VERSION 1
+
+
+/* ============================================================================
+ * Typdefinitionen
+ * ========================================================================= */
+
+/**
+ * Stand einer Suche über die Startzahlen 1 bis frontier.
+ */
+typedef struct
+{
+    int frontier;       /**< größte bereits berechnete Startzahl */
+    int run_peak;       /**< Maximum des offenen Laufs an der Front */
+    int run_len;        /**< Länge des offenen Laufs (endet bei frontier) */
+    int max_len;        /**< größte Länge eines abgeschlossenen Laufs */
+    int *best;          /**< best[n] für 2 <= n <= max_len: kleinste Zahl 
+                             der letzten abgeschlossenen Gruppe aus n
+                             Mehrlingen oder -1 */
+} ulam_scan_state;
+
+
+/* ============================================================================
+ * Funktions-Prototypen
+ * ========================================================================= */
+
+/**
+ * Initialisiert einen leeren Stand (noch keine Startzahl berechnet).
+ *
+ * @param state     Stand
+ */
+void ulam_scan_init(ulam_scan_state *state);
+
+/**
+ * Gibt den Speicher eines Stands frei und setzt ihn zurück.
+ *
+ * @param state     Stand
+ */
+void ulam_scan_free(ulam_scan_state *state);
+
+/**
+ * Berechnet die Startzahlen frontier + 1 bis limit und schiebt die Front
+ * auf limit. Ist limit <= frontier, ändert sich nichts. Verschiedene Stände
+ * dürfen gleichzeitig aus mehreren Threads erweitert werden.
+ *
+ * @param state     Stand
+ * @param limit     neue Front
+ * @return          0 oder -1, wenn nicht genügend Speicher vorhanden ist
+ */
+int ulam_scan_extend(ulam_scan_state *state, int limit);
+
+/**
+ * Liefert dasselbe Ergebnis wie ulam_multiples(limit, number). Liegt limit
+ * über der Front, wird die Suche bis limit fortgesetzt; liegt es darunter,
+ * wird ulam_multiples() aufgerufen.
+ *
+ * @param state     Stand
+ * @param limit     positive ganze Zahl, bis zu der nach ULAM-Mehrlingen
+ *                  gesucht werden soll.
+ * @param number    positive Zahl, die die Anzahl der gesuchten Mehrlinge angibt
+ * @return          die kleinste Zahl des letzten "ULAM-Mehrlings" oder -1, wenn
+ *                  keine Mehrlinge gefunden wurden, limit < number oder
+ *                  number < 2.
+ */
+int ulam_scan_multiples(ulam_scan_state *state, int limit, int number);
+
+/**
+ * Liefert dasselbe Ergebnis wie ulam_twins(limit), siehe
+ * ulam_scan_multiples().
+ *
+ * @param state     Stand
+ * @param limit     ganze Zahl, bis zu der nach ULAM-Zwillingen
+ *                  gesucht werden soll.
+ * @return          die kleinere Zahl des letzten ULAM-Zwillingspaars
+ *                  oder -1, wenn es kein solches Paar gibt oder limit < 1 ist
+ */
+int ulam_scan_twins(ulam_scan_state *state, int limit);
+
+/**
+ * Speichert den Stand in einer Datei. Die Datei wird zunächst unter
+ * path.tmp geschrieben und dann umbenannt, so dass ein Abbruch den vorigen
+ * Stand nicht zerstört.
+ *
+ * @param path      Pfad der Datei
+ * @param state     Stand
+ * @return          0 oder -1 bei einem Fehler
+ */
+int ulam_scan_save(const char *path, const ulam_scan_state *state);
+
+/**
+ * Lädt einen Stand aus einer Datei und prüft deren Prüfsumme. Ein
+ * vorhandener Stand in state wird dabei ersetzt.
+ *
+ * @param path      Pfad der Datei
+ * @param state     initialisierter Stand
+ * @return          0 oder -1, wenn die Datei fehlt oder ungültig ist
+ */
+int ulam_scan_load(const char *path, ulam_scan_state *state);
+
+#endif /* ULAM_SCAN_H */
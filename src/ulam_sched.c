@@ -0,0 +1,672 @@
+/**
+ * @file
+ * Dieses Modul implementiert den Scheduler mit Work-Stealing für die
+ * Bereichsberechnungen (siehe ulam_sched.h).
+ *
+ * Der Scheduler hält einen Pool von Hilfsthreads, die zwischen zwei
+ * Aufträgen schlafen. Ein Auftrag wird zunächst gleichmäßig auf die Deques
+ * der Threads verteilt. Jeder Thread entnimmt seiner Deque das jüngste
+ * Teilintervall, halbiert es bis zur Körnung und legt die abgetrennten
+ * oberen Hälften in seine Deque. Ist die eigene Deque leer, stiehlt er das
+ * älteste (größte) Teilintervall eines zufällig gewählten anderen Threads.
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#include "ulam_parallel.h"
+#include "ulam_sched.h"
+
+
+/* ============================================================================
+ * Symbolische Konstanten
+ * ========================================================================= */
+
+/**
+ * Kapazität einer Deque. Da die Teilintervalle einer Deque von oben nach
+ * unten jeweils halb so groß sind, reichen wenige Einträge je Thread.
+ */
+#define ULAM_SCHED_DEQUE_SIZE 128
+
+/** Anzahl der Teilintervalle je Thread bei automatisch gewählter Körnung */
+#define ULAM_SCHED_GRAINS_PER_THREAD 32
+
+
+/* ============================================================================
+ * Typdefinitionen
+ * ========================================================================= */
+
+/** Teilintervall lo bis einschließlich hi */
+typedef struct
+{
+    int lo;
+    int hi;
+} ulam_sched_range;
+
+/**
+ * Zustand eines Threads: seine Deque und seine Zähler. Die Einträge
+ * items[top] bis items[bottom - 1] sind belegt; der Besitzer arbeitet am
+ * unteren Ende, Diebe entnehmen am oberen Ende.
+ */
+typedef struct
+{
+    pthread_mutex_t lock;       /* schützt die Deque */
+    ulam_sched_range items[ULAM_SCHED_DEQUE_SIZE];
+    int top;
+    int bottom;
+    unsigned int seed;          /* für die Wahl des Opfers beim Stehlen */
+    ulam_sched_stats stats;     /* nur vom Thread selbst geschrieben */
+    char padding[64];           /* trennt die Cachezeilen der Threads */
+} ulam_sched_worker;
+
+/**
+ * Pool der Hilfsthreads und aktueller Auftrag.
+ */
+typedef struct
+{
+    pthread_mutex_t lock;       /* schützt alle folgenden Komponenten */
+    pthread_cond_t start_cv;    /* signalisiert einen neuen Auftrag */
+    pthread_cond_t idle_cv;     /* signalisiert, dass kein Helfer mehr läuft */
+    int threads;                /* Anzahl der Threads einschl. Aufrufer */
+    int started;                /* Anzahl der gestarteten Hilfsthreads */
+    int generation;             /* laufende Nummer des Auftrags */
+    int running;                /* Anzahl der Helfer im aktuellen Auftrag */
+    int quit;                   /* 1, wenn die Hilfsthreads enden sollen */
+    ulam_sched_task task;       /* Aufgabe des aktuellen Auftrags */
+    void *arg;                  /* Argument der Aufgabe */
+    int grain;                  /* Körnung des aktuellen Auftrags */
+    long long remaining;        /* noch nicht bearbeitete Elemente */
+    ulam_sched_worker *workers; /* Zustände der Threads, 0 = Aufrufer */
+    pthread_t *ids;             /* Hilfsthreads */
+} ulam_sched_pool;
+
+/** Argument eines Hilfsthreads */
+typedef struct
+{
+    ulam_sched_pool *pool;
+    int index;
+} ulam_sched_helper;
+
+
+/* ============================================================================
+ * Prototypen der privaten Funktionen
+ * ========================================================================= */
+
+/**
+ * Startet den Pool mit der eingestellten Anzahl von Threads bzw. startet ihn
+ * neu, wenn sich die Anzahl geändert hat. Wird mit gesperrtem
+ * #ulam_sched_call_lock aufgerufen.
+ *
+ * @return          Anzahl der Threads einschließlich des Aufrufers
+ */
+static int ulam_sched_start(void);
+
+/**
+ * Beendet alle Hilfsthreads des Pools. Wird mit gesperrtem
+ * #ulam_sched_call_lock aufgerufen.
+ */
+static void ulam_sched_stop(void);
+
+/**
+ * Hauptfunktion der Hilfsthreads.
+ *
+ * @param arg       Zeiger auf ulam_sched_helper
+ * @return          immer NULL
+ */
+static void *ulam_sched_helper_main(void *arg);
+
+/**
+ * Bearbeitet Teilintervalle des aktuellen Auftrags aus der eigenen Deque
+ * oder durch Stehlen, bis alle Elemente bearbeitet sind.
+ *
+ * @param self      Index des Threads
+ */
+static void ulam_sched_run(int self);
+
+/**
+ * Halbiert ein Teilintervall bis zur Körnung, legt die oberen Hälften in die
+ * eigene Deque und führt die Aufgabe für den Rest aus.
+ *
+ * @param self      Index des Threads
+ * @param range     zu bearbeitendes Teilintervall
+ */
+static void ulam_sched_execute(int self, ulam_sched_range range);
+
+/**
+ * Führt eine Aufgabe für ein Teilintervall aus und zählt sie in den Zählern
+ * des Threads.
+ *
+ * @param self      Index des Threads
+ * @param task      auszuführende Aufgabe
+ * @param arg       Argument für die Aufgabe
+ * @param range     zu bearbeitendes Teilintervall
+ */
+static void ulam_sched_invoke(int self, ulam_sched_task task, void *arg,
+                              ulam_sched_range range);
+
+/**
+ * Legt ein Teilintervall am unteren Ende einer Deque ab.
+ *
+ * @param worker    Thread, dem die Deque gehört
+ * @param range     abzulegendes Teilintervall
+ * @return          1 bei Erfolg, 0 wenn die Deque voll ist
+ */
+static int ulam_sched_push(ulam_sched_worker *worker, ulam_sched_range range);
+
+/**
+ * Entnimmt das jüngste Teilintervall der eigenen Deque.
+ *
+ * @param worker    Thread, dem die Deque gehört
+ * @param range     entnommenes Teilintervall
+ * @return          1 bei Erfolg, 0 wenn die Deque leer ist
+ */
+static int ulam_sched_pop(ulam_sched_worker *worker, ulam_sched_range *range);
+
+/**
+ * Stiehlt das älteste Teilintervall aus der Deque eines zufällig gewählten
+ * anderen Threads.
+ *
+ * @param self      Index des stehlenden Threads
+ * @param range     gestohlenes Teilintervall
+ * @return          1 bei Erfolg, 0 wenn nichts gestohlen werden konnte
+ */
+static int ulam_sched_steal(int self, ulam_sched_range *range);
+
+/**
+ * Liefert die aktuelle Zeit einer monotonen Uhr in ns.
+ *
+ * @return          Zeit in ns
+ */
+static long long ulam_sched_now(void);
+
+
+/* ============================================================================
+ * Globale Variablen
+ * ========================================================================= */
+
+/** Pool der Hilfsthreads */
+static ulam_sched_pool ulam_sched = {
+    PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER,
+    PTHREAD_COND_INITIALIZER, 0, 0, 0, 0, 0, NULL, NULL, 0, 0, NULL, NULL
+};
+
+/** serialisiert Aufträge sowie Start und Stopp des Pools */
+static pthread_mutex_t ulam_sched_call_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/** 1, solange der Thread eine Aufgabe des Schedulers ausführt */
+static __thread int ulam_sched_in_task = 0;
+
+
+/* ============================================================================
+ * Funktionsdefinitionen
+ * ========================================================================= */
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_sched_parallel_for
+ * ------------------------------------------------------------------------- */
+int ulam_sched_parallel_for(int lo, int hi, int grain,
+                            ulam_sched_task task, void *arg)
+{
+    ulam_sched_range part;
+    ulam_sched_range whole;
+    long long count;
+    long long share;
+    int threads;
+    int i;
+
+    if (lo > hi || task == NULL)
+    {
+        return -1;
+    }
+
+    /* Verschachtelte Aufträge werden direkt ausgeführt */
+    if (ulam_sched_in_task)
+    {
+        task(lo, hi, arg);
+        return 0;
+    }
+
+    pthread_mutex_lock(&ulam_sched_call_lock);
+
+    threads = ulam_sched_start();
+    count = (long long) hi - lo + 1;
+    if (grain < 1)
+    {
+        share = count / ((long long) threads * ULAM_SCHED_GRAINS_PER_THREAD);
+        grain = (share > 1) ? (int) share : 1;
+    }
+
+    /* Ein einzelnes Korn lohnt die Verteilung nicht */
+    if (threads <= 1 || count <= grain)
+    {
+        whole.lo = lo;
+        whole.hi = hi;
+        ulam_sched_invoke(0, task, arg, whole);
+        pthread_mutex_unlock(&ulam_sched_call_lock);
+        return 0;
+    }
+
+    /* Intervall gleichmäßig auf die Deques verteilen */
+    pthread_mutex_lock(&ulam_sched.lock);
+    ulam_sched.task = task;
+    ulam_sched.arg = arg;
+    ulam_sched.grain = grain;
+    __atomic_store_n(&ulam_sched.remaining, count, __ATOMIC_SEQ_CST);
+
+    share = count / threads;
+    part.hi = hi;
+    for (i = 0; i < threads; i++)
+    {
+        part.lo = (i == threads - 1) ? lo : (int) (part.hi - share + 1);
+        pthread_mutex_lock(&ulam_sched.workers[i].lock);
+        ulam_sched_push(&ulam_sched.workers[i], part);
+        pthread_mutex_unlock(&ulam_sched.workers[i].lock);
+        part.hi = part.lo - 1;
+    }
+
+    ulam_sched.generation++;
+    pthread_cond_broadcast(&ulam_sched.start_cv);
+    pthread_mutex_unlock(&ulam_sched.lock);
+
+    /* Der Aufrufer rechnet als Thread 0 mit */
+    ulam_sched_run(0);
+
+    /* Warten, bis kein Helfer mehr auf den Auftrag zugreift */
+    pthread_mutex_lock(&ulam_sched.lock);
+    while (ulam_sched.running > 0)
+    {
+        pthread_cond_wait(&ulam_sched.idle_cv, &ulam_sched.lock);
+    }
+    pthread_mutex_unlock(&ulam_sched.lock);
+
+    pthread_mutex_unlock(&ulam_sched_call_lock);
+
+    return 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_sched_get_stats
+ * ------------------------------------------------------------------------- */
+int ulam_sched_get_stats(ulam_sched_stats stats[], int max)
+{
+    int threads;
+    int i;
+
+    /* Während keines Auftrags ändert kein Thread seine Zähler */
+    pthread_mutex_lock(&ulam_sched_call_lock);
+
+    threads = ulam_sched.threads;
+    for (i = 0; i < threads && i < max; i++)
+    {
+        stats[i] = ulam_sched.workers[i].stats;
+    }
+
+    pthread_mutex_unlock(&ulam_sched_call_lock);
+
+    return threads;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_sched_reset_stats
+ * ------------------------------------------------------------------------- */
+void ulam_sched_reset_stats(void)
+{
+    int i;
+
+    pthread_mutex_lock(&ulam_sched_call_lock);
+
+    for (i = 0; i < ulam_sched.threads; i++)
+    {
+        memset(&ulam_sched.workers[i].stats, 0, sizeof(ulam_sched_stats));
+    }
+
+    pthread_mutex_unlock(&ulam_sched_call_lock);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_sched_shutdown
+ * ------------------------------------------------------------------------- */
+void ulam_sched_shutdown(void)
+{
+    pthread_mutex_lock(&ulam_sched_call_lock);
+    ulam_sched_stop();
+    pthread_mutex_unlock(&ulam_sched_call_lock);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_sched_start
+ * ------------------------------------------------------------------------- */
+static int ulam_sched_start(void)
+{
+    ulam_sched_helper *helper;
+    int threads = ulam_parallel_get_threads();
+    int i;
+
+    if (ulam_sched.workers != NULL && ulam_sched.threads == threads)
+    {
+        return threads;
+    }
+
+    ulam_sched_stop();
+
+    ulam_sched.workers = (ulam_sched_worker *)
+        calloc((size_t) threads, sizeof(ulam_sched_worker));
+    ulam_sched.ids = (pthread_t *) calloc((size_t) threads, sizeof(pthread_t));
+    if (ulam_sched.workers == NULL || ulam_sched.ids == NULL)
+    {
+        /* Ohne Speicher rechnet der Aufrufer allein und ohne Zähler */
+        free(ulam_sched.workers);
+        free(ulam_sched.ids);
+        ulam_sched.workers = NULL;
+        ulam_sched.ids = NULL;
+        return 1;
+    }
+
+    for (i = 0; i < threads; i++)
+    {
+        pthread_mutex_init(&ulam_sched.workers[i].lock, NULL);
+        ulam_sched.workers[i].seed = 2654435761u * (unsigned int) (i + 1);
+    }
+    ulam_sched.threads = threads;
+    ulam_sched.quit = 0;
+    ulam_sched.started = 0;
+
+    /* Thread 0 ist der Aufrufer, nur die übrigen werden gestartet */
+    for (i = 1; i < threads; i++)
+    {
+        helper = (ulam_sched_helper *) malloc(sizeof(ulam_sched_helper));
+        if (helper == NULL)
+        {
+            break;
+        }
+        helper->pool = &ulam_sched;
+        helper->index = i;
+        if (pthread_create(&ulam_sched.ids[ulam_sched.started], NULL,
+                           ulam_sched_helper_main, helper) != 0)
+        {
+            free(helper);
+            break;
+        }
+        ulam_sched.started++;
+    }
+
+    /* Nicht gestartete Threads dürfen keine Teilintervalle erhalten */
+    ulam_sched.threads = ulam_sched.started + 1;
+
+    return ulam_sched.threads;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_sched_stop
+ * ------------------------------------------------------------------------- */
+static void ulam_sched_stop(void)
+{
+    int i;
+
+    if (ulam_sched.workers == NULL)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&ulam_sched.lock);
+    ulam_sched.quit = 1;
+    pthread_cond_broadcast(&ulam_sched.start_cv);
+    pthread_mutex_unlock(&ulam_sched.lock);
+
+    for (i = 0; i < ulam_sched.started; i++)
+    {
+        pthread_join(ulam_sched.ids[i], NULL);
+    }
+
+    for (i = 0; i < ulam_sched.threads; i++)
+    {
+        pthread_mutex_destroy(&ulam_sched.workers[i].lock);
+    }
+
+    free(ulam_sched.workers);
+    free(ulam_sched.ids);
+    ulam_sched.workers = NULL;
+    ulam_sched.ids = NULL;
+    ulam_sched.threads = 0;
+    ulam_sched.started = 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_sched_helper_main
+ * ------------------------------------------------------------------------- */
+static void *ulam_sched_helper_main(void *arg)
+{
+    ulam_sched_helper *helper = (ulam_sched_helper *) arg;
+    ulam_sched_pool *pool = helper->pool;
+    int self = helper->index;
+    int generation;
+
+    free(helper);
+
+    pthread_mutex_lock(&pool->lock);
+    generation = pool->generation;
+    for (;;)
+    {
+        while (!pool->quit && pool->generation == generation)
+        {
+            pthread_cond_wait(&pool->start_cv, &pool->lock);
+        }
+        if (pool->quit)
+        {
+            break;
+        }
+
+        generation = pool->generation;
+        pool->running++;
+        pthread_mutex_unlock(&pool->lock);
+
+        ulam_sched_run(self);
+
+        pthread_mutex_lock(&pool->lock);
+        pool->running--;
+        if (pool->running == 0)
+        {
+            pthread_cond_broadcast(&pool->idle_cv);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    return NULL;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_sched_run
+ * ------------------------------------------------------------------------- */
+static void ulam_sched_run(int self)
+{
+    ulam_sched_worker *worker = &ulam_sched.workers[self];
+    ulam_sched_range range;
+    long long idle_since = 0;
+    int found;
+
+    while (__atomic_load_n(&ulam_sched.remaining, __ATOMIC_ACQUIRE) > 0)
+    {
+        pthread_mutex_lock(&worker->lock);
+        found = ulam_sched_pop(worker, &range);
+        pthread_mutex_unlock(&worker->lock);
+
+        if (!found)
+        {
+            found = ulam_sched_steal(self, &range);
+        }
+
+        if (found)
+        {
+            if (idle_since != 0)
+            {
+                worker->stats.idle_ns += ulam_sched_now() - idle_since;
+                idle_since = 0;
+            }
+            ulam_sched_execute(self, range);
+        }
+        else
+        {
+            /* Leerlauf: andere Threads arbeiten noch an ihren Intervallen */
+            if (idle_since == 0)
+            {
+                idle_since = ulam_sched_now();
+            }
+            sched_yield();
+        }
+    }
+
+    if (idle_since != 0)
+    {
+        worker->stats.idle_ns += ulam_sched_now() - idle_since;
+    }
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_sched_execute
+ * ------------------------------------------------------------------------- */
+static void ulam_sched_execute(int self, ulam_sched_range range)
+{
+    ulam_sched_worker *worker = &ulam_sched.workers[self];
+    ulam_sched_range upper;
+    int pushed;
+
+    /* Obere Hälften für andere Threads bereitstellen */
+    while (range.hi - range.lo >= ulam_sched.grain)
+    {
+        upper.lo = range.lo + (range.hi - range.lo) / 2 + 1;
+        upper.hi = range.hi;
+
+        pthread_mutex_lock(&worker->lock);
+        pushed = ulam_sched_push(worker, upper);
+        pthread_mutex_unlock(&worker->lock);
+        if (!pushed)
+        {
+            break;
+        }
+        range.hi = upper.lo - 1;
+    }
+
+    ulam_sched_invoke(self, ulam_sched.task, ulam_sched.arg, range);
+
+    __atomic_sub_fetch(&ulam_sched.remaining,
+                       (long long) range.hi - range.lo + 1, __ATOMIC_RELEASE);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_sched_invoke
+ * ------------------------------------------------------------------------- */
+static void ulam_sched_invoke(int self, ulam_sched_task task, void *arg,
+                              ulam_sched_range range)
+{
+    ulam_sched_worker *worker;
+    long long start;
+
+    start = ulam_sched_now();
+    ulam_sched_in_task = 1;
+    task(range.lo, range.hi, arg);
+    ulam_sched_in_task = 0;
+
+    if (ulam_sched.workers != NULL)
+    {
+        worker = &ulam_sched.workers[self];
+        worker->stats.busy_ns += ulam_sched_now() - start;
+        worker->stats.tasks++;
+        worker->stats.items += (long long) range.hi - range.lo + 1;
+    }
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_sched_push
+ * ------------------------------------------------------------------------- */
+static int ulam_sched_push(ulam_sched_worker *worker, ulam_sched_range range)
+{
+    if (worker->top == worker->bottom)
+    {
+        worker->top = 0;
+        worker->bottom = 0;
+    }
+    if (worker->bottom == ULAM_SCHED_DEQUE_SIZE)
+    {
+        return 0;
+    }
+
+    worker->items[worker->bottom++] = range;
+
+    return 1;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_sched_pop
+ * ------------------------------------------------------------------------- */
+static int ulam_sched_pop(ulam_sched_worker *worker, ulam_sched_range *range)
+{
+    if (worker->top == worker->bottom)
+    {
+        return 0;
+    }
+
+    *range = worker->items[--worker->bottom];
+
+    return 1;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_sched_steal
+ * ------------------------------------------------------------------------- */
+static int ulam_sched_steal(int self, ulam_sched_range *range)
+{
+    ulam_sched_worker *thief = &ulam_sched.workers[self];
+    ulam_sched_worker *victim;
+    int threads = ulam_sched.threads;
+    int start;
+    int i;
+
+    /* Opfer zufällig wählen, dann reihum alle anderen Threads versuchen */
+    thief->seed = thief->seed * 1103515245u + 12345u;
+    start = (int) ((thief->seed >> 16) % (unsigned int) threads);
+
+    for (i = 0; i < threads; i++)
+    {
+        victim = &ulam_sched.workers[(start + i) % threads];
+        if (victim == thief)
+        {
+            continue;
+        }
+
+        pthread_mutex_lock(&victim->lock);
+        if (victim->top < victim->bottom)
+        {
+            *range = victim->items[victim->top++];
+            pthread_mutex_unlock(&victim->lock);
+            thief->stats.steals++;
+            return 1;
+        }
+        pthread_mutex_unlock(&victim->lock);
+    }
+
+    thief->stats.failed_steals++;
+
+    return 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_sched_now
+ * ------------------------------------------------------------------------- */
+static long long ulam_sched_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (long long) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
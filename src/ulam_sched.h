@@ -0,0 +1,93 @@
+/**
+ * @file
+ * Dieses Modul implementiert einen Scheduler mit Work-Stealing für die
+ * Bereichsberechnungen. Die Rechenzeit je Startzahl schwankt stark (27
+ * benötigt 111 Schritte, ihre Nachbarn nur wenige), daher wird ein Intervall
+ * nicht fest auf die Threads aufgeteilt. Jeder Thread besitzt eine
+ * Warteschlange (Deque) mit Teilintervallen, halbiert seine Intervalle bis
+ * zu einer kleinen Körnung und stiehlt bei Leerlauf die ältesten Einträge
+ * anderer Threads.
+ *
+ * Für jeden Thread werden ausgeführte Teilintervalle, Diebstähle und
+ * Leerlaufzeiten gezählt, um die Lastverteilung prüfen zu können.
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+#ifndef ULAM_SCHED_H
+#define ULAM_SCHED_H
+
+/* ============================================================================
+ * Typdefinitionen
+ * ========================================================================= */
+
+/**
+ * Aufgabe, die für das Teilintervall lo bis einschließlich hi ausgeführt
+ * wird.
+ *
+ * @param lo        untere Grenze des Teilintervalls
+ * @param hi        obere Grenze des Teilintervalls
+ * @param arg       Argument, das an ulam_sched_parallel_for() übergeben wurde
+ */
+typedef void (*ulam_sched_task)(int lo, int hi, void *arg);
+
+/**
+ * Zähler eines Threads des Schedulers.
+ */
+typedef struct
+{
+    long long tasks;            /**< ausgeführte Teilintervalle */
+    long long items;            /**< bearbeitete Elemente */
+    long long steals;           /**< erfolgreiche Diebstähle */
+    long long failed_steals;    /**< Diebstahlversuche ohne Beute */
+    long long busy_ns;          /**< Zeit in Aufgaben in ns */
+    long long idle_ns;          /**< Zeit ohne Arbeit während eines Auftrags */
+} ulam_sched_stats;
+
+
+/* ============================================================================
+ * Funktions-Prototypen
+ * ========================================================================= */
+
+/**
+ * Führt task für alle Elemente von lo bis einschließlich hi aus, verteilt
+ * auf die mit ulam_parallel_set_threads() eingestellten Threads. Der
+ * aufrufende Thread rechnet mit und kehrt erst zurück, wenn alle
+ * Teilintervalle bearbeitet sind. Aufrufe aus einer Aufgabe heraus werden
+ * direkt im aufrufenden Thread ausgeführt.
+ *
+ * @param lo        untere Grenze des Intervalls
+ * @param hi        obere Grenze des Intervalls
+ * @param grain     Größe, bis zu der Teilintervalle halbiert werden;
+ *                  bei grain < 1 wird sie aus Intervall und Threadzahl
+ *                  bestimmt
+ * @param task      auszuführende Aufgabe
+ * @param arg       Argument für die Aufgabe
+ * @return          0 bei Erfolg, -1 wenn lo > hi oder task NULL ist
+ */
+int ulam_sched_parallel_for(int lo, int hi, int grain,
+                            ulam_sched_task task, void *arg);
+
+/**
+ * Kopiert die Zähler der Threads seit dem letzten Zurücksetzen. Eintrag 0
+ * gehört zum aufrufenden Thread von ulam_sched_parallel_for().
+ *
+ * @param stats     Feld für die Zähler
+ * @param max       Anzahl der Einträge in stats
+ * @return          Anzahl der Threads des Schedulers
+ */
+int ulam_sched_get_stats(ulam_sched_stats stats[], int max);
+
+/**
+ * Setzt die Zähler aller Threads auf 0 zurück.
+ */
+void ulam_sched_reset_stats(void);
+
+/**
+ * Beendet die Hilfsthreads des Schedulers. Sie werden beim nächsten Aufruf
+ * von ulam_sched_parallel_for() bei Bedarf neu gestartet.
+ */
+void ulam_sched_shutdown(void);
+
+#endif /* ULAM_SCHED_H */
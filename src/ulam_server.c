@@ -0,0 +1,795 @@
+/**
+ * @file
+ * Dieses Modul implementiert den lokalen Server für Anfragen an die
+ * ULAM-Funktionen (siehe ulam_server.h).
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <time.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "ulam_lru.h"
+#include "ulam_query.h"
+#include "ulam_server.h"
+
+
+/* ============================================================================
+ * Symbolische Konstanten
+ * ========================================================================= */
+
+/** maximale Anzahl gleichzeitiger Verbindungen */
+#define ULAM_SERVER_MAX_CLIENTS 256
+
+/** Größe der Ein- und Ausgabepuffer je Verbindung in Byte */
+#define ULAM_SERVER_BUFFER 65536
+
+/** maximale Anzahl der Anfragen je Stapel */
+#define ULAM_SERVER_BATCH 8192
+
+/** maximale Länge der Antwort auf "stats" in Byte */
+#define ULAM_SERVER_LINE 256
+
+/** maximale Länge jeder anderen Antwort in Byte (Ganzzahl und '\n'); für
+ *  jede Anfrage eines Stapels wird so viel Platz im Ausgabepuffer
+ *  freigehalten */
+#define ULAM_SERVER_ANSWER 16
+
+/** Anzahl der letzten Antwortzeiten, aus denen die Perzentile bestimmt
+ *  werden */
+#define ULAM_SERVER_LATENCY_WINDOW 65536
+
+/** Wartezeit von poll() in ms, nach der das Stopp-Flag geprüft wird */
+#define ULAM_SERVER_POLL_MS 100
+
+
+/* ============================================================================
+ * Typdefinitionen
+ * ========================================================================= */
+
+/**
+ * Verbindung zu einem Client.
+ */
+typedef struct
+{
+    int fd;                         /**< Socket oder -1 für freie Einträge */
+    size_t in_len;                  /**< belegte Bytes in in */
+    size_t out_len;                 /**< belegte, noch nicht gesendete
+                                         Bytes in out */
+    int skipping;                   /**< 1, solange der Rest einer zu
+                                         langen Zeile verworfen wird */
+    char in[ULAM_SERVER_BUFFER];    /**< empfangene, unbearbeitete Daten */
+    char out[ULAM_SERVER_BUFFER];   /**< noch nicht gesendete Antworten */
+} ulam_server_client;
+
+/**
+ * Anfrage im aktuellen Stapel.
+ */
+typedef struct
+{
+    int client;             /**< Index der Verbindung */
+    int is_stats;           /**< 1 für die Anfrage "stats" */
+    int cached;             /**< 1, wenn die Antwort aus dem Cache kommt */
+    int64_t received_ns;    /**< Zeitpunkt des Lesens */
+    ulam_query query;       /**< Anfrage und Ergebnis */
+} ulam_server_request;
+
+/**
+ * Zustand des Servers.
+ */
+typedef struct
+{
+    ulam_server_client *clients;        /**< Verbindungen */
+    ulam_server_request *requests;      /**< aktueller Stapel */
+    ulam_query *misses;                 /**< Anfragen ohne Cache-Treffer */
+    int64_t *latencies;                 /**< Ringpuffer der Antwortzeiten */
+    ulam_lru lru;                       /**< Cache der Antworten */
+    int count;                          /**< Anfragen im Stapel */
+    int first;                          /**< Verbindung, bei der der
+                                             nächste Stapel beginnt */
+    long long queued_total;             /**< Summe der Stapelgrößen */
+} ulam_server_state;
+
+
+/* ============================================================================
+ * Globale Variablen
+ * ========================================================================= */
+
+/** wird von ulam_server_stop() gesetzt */
+static volatile sig_atomic_t ulam_server_stopped = 0;
+
+/** Statistik des Servers */
+static ulam_server_stats ulam_server_current;
+
+/** Zustand des laufenden Servers oder NULL */
+static ulam_server_state *ulam_server_active = NULL;
+
+
+/* ============================================================================
+ * Prototypen der privaten Funktionen
+ * ========================================================================= */
+
+/**
+ * Liefert die aktuelle Zeit in ns (monoton).
+ */
+static int64_t ulam_server_now(void);
+
+/**
+ * Liest verfügbare Daten einer Verbindung. Eine Zeile, die nicht in den
+ * Eingabepuffer passt, wird einmal mit "error" beantwortet und bis zu
+ * ihrem Ende verworfen. Bei Verbindungsende oder Fehler wird die
+ * Verbindung geschlossen.
+ *
+ * @param state     Zustand
+ * @param c         Index der Verbindung
+ */
+static void ulam_server_read(ulam_server_state *state, int c);
+
+/**
+ * Prüft, ob von einer Verbindung gelesen werden kann, ohne dass Daten
+ * verloren gehen.
+ *
+ * @param client    Verbindung
+ * @return          1 oder 0
+ */
+static int ulam_server_wants_input(const ulam_server_client *client);
+
+/**
+ * Übernimmt vollständige Zeilen einer Verbindung in den Stapel, solange
+ * darin und im Ausgabepuffer der Verbindung Platz für die Antworten ist.
+ *
+ * @param state     Zustand
+ * @param c         Index der Verbindung
+ * @param now       Zeitpunkt des Lesens
+ */
+static void ulam_server_collect(ulam_server_state *state, int c, int64_t now);
+
+/**
+ * Prüft, ob eine Verbindung vollständige Zeilen hat, die sofort in einen
+ * Stapel übernommen werden können.
+ *
+ * @param client    Verbindung
+ * @return          1 oder 0
+ */
+static int ulam_server_ready(const ulam_server_client *client);
+
+/**
+ * Schaltet eine Verbindung auf nicht blockierende Ein-/Ausgabe um.
+ *
+ * @param fd        Socket
+ * @return          0 oder -1 bei einem Fehler
+ */
+static int ulam_server_nonblocking(int fd);
+
+/**
+ * Beantwortet den Stapel und schreibt alle Antworten.
+ *
+ * @param state     Zustand
+ */
+static void ulam_server_process(ulam_server_state *state);
+
+/**
+ * Hängt Text an den Ausgabepuffer einer Verbindung an. Der Platz dafür wurde
+ * beim Übernehmen der Anfrage freigehalten.
+ */
+static void ulam_server_append(ulam_server_state *state, int c,
+                               const char *text, size_t len);
+
+/**
+ * Sendet so viel vom Ausgabepuffer einer Verbindung, wie der Socket ohne
+ * Blockieren annimmt; der Rest bleibt im Puffer.
+ */
+static void ulam_server_flush(ulam_server_state *state, int c);
+
+/**
+ * Schließt eine Verbindung.
+ */
+static void ulam_server_close(ulam_server_state *state, int c);
+
+/**
+ * Berechnet die Perzentile der gespeicherten Antwortzeiten.
+ */
+static void ulam_server_percentiles(ulam_server_state *state);
+
+/**
+ * Vergleichsfunktion für qsort() über Antwortzeiten.
+ */
+static int ulam_server_compare(const void *a, const void *b);
+
+
+/* ============================================================================
+ * Funktionsdefinitionen
+ * ========================================================================= */
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_server_run
+ * ------------------------------------------------------------------------- */
+int ulam_server_run(const char *path, int lru_capacity)
+{
+    struct pollfd fds[ULAM_SERVER_MAX_CLIENTS + 1];
+    int slot[ULAM_SERVER_MAX_CLIENTS + 1];  /* Verbindung zu fds[i] */
+    struct sockaddr_un addr;
+    ulam_server_state state;
+    int64_t now;
+    int listen_fd;
+    int backlog;        /* 1, wenn noch vollständige Zeilen warten */
+    int nfds;
+    int fd;
+    int c;
+    int i;
+
+    if (path == NULL || strlen(path) >= sizeof(addr.sun_path))
+    {
+        return -1;
+    }
+
+    /* Schreiben auf geschlossene Verbindungen darf den Server nicht
+     * beenden */
+    signal(SIGPIPE, SIG_IGN);
+
+    listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0 || ulam_server_nonblocking(listen_fd) != 0)
+    {
+        if (listen_fd >= 0)
+        {
+            close(listen_fd);
+        }
+        return -1;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+    unlink(path);
+    if (bind(listen_fd, (struct sockaddr *) &addr, sizeof(addr)) != 0
+        || listen(listen_fd, 64) != 0)
+    {
+        close(listen_fd);
+        return -1;
+    }
+
+    memset(&state, 0, sizeof(state));
+    state.clients = (ulam_server_client *) 
+                    malloc(ULAM_SERVER_MAX_CLIENTS * sizeof(ulam_server_client));
+    state.requests = (ulam_server_request *) 
+                     malloc(ULAM_SERVER_BATCH * sizeof(ulam_server_request));
+    state.misses = (ulam_query *) 
+                   malloc(ULAM_SERVER_BATCH * sizeof(ulam_query));
+    state.latencies = (int64_t *) 
+                      calloc(ULAM_SERVER_LATENCY_WINDOW, sizeof(int64_t));
+    if (state.clients == NULL || state.requests == NULL 
+        || state.misses == NULL || state.latencies == NULL
+        || ulam_lru_init(&state.lru, lru_capacity) != 0)
+    {
+        free(state.clients);
+        free(state.requests);
+        free(state.misses);
+        free(state.latencies);
+        close(listen_fd);
+        unlink(path);
+        return -1;
+    }
+    for (c = 0; c < ULAM_SERVER_MAX_CLIENTS; c++)
+    {
+        state.clients[c].fd = -1;
+    }
+
+    memset(&ulam_server_current, 0, sizeof(ulam_server_current));
+    ulam_server_active = &state;
+    ulam_server_stopped = 0;
+    backlog = 0;
+
+    while (!ulam_server_stopped)
+    {
+        /* Socket und alle Verbindungen überwachen: lesen, solange der
+         * Eingabepuffer Platz hat, schreiben, solange Antworten offen sind */
+        nfds = 0;
+        fds[nfds].fd = listen_fd;
+        fds[nfds].events = POLLIN;
+        slot[nfds++] = -1;
+        for (c = 0; c < ULAM_SERVER_MAX_CLIENTS; c++)
+        {
+            if (state.clients[c].fd >= 0)
+            {
+                fds[nfds].fd = state.clients[c].fd;
+                fds[nfds].events = 0;
+                if (ulam_server_wants_input(&state.clients[c]))
+                {
+                    fds[nfds].events |= POLLIN;
+                }
+                if (state.clients[c].out_len > 0)
+                {
+                    fds[nfds].events |= POLLOUT;
+                }
+                slot[nfds++] = c;
+            }
+        }
+
+        /* Warten nur, wenn keine gelesenen Zeilen mehr offen sind */
+        if (poll(fds, (nfds_t) nfds, backlog ? 0 : ULAM_SERVER_POLL_MS) < 0)
+        {
+            continue;
+        }
+
+        if (fds[0].revents & POLLIN)
+        {
+            fd = accept(listen_fd, NULL, NULL);
+            if (fd >= 0 && ulam_server_nonblocking(fd) != 0)
+            {
+                close(fd);
+                fd = -1;
+            }
+            for (c = 0; fd >= 0 && c < ULAM_SERVER_MAX_CLIENTS; c++)
+            {
+                if (state.clients[c].fd < 0)
+                {
+                    state.clients[c].fd = fd;
+                    state.clients[c].in_len = 0;
+                    state.clients[c].out_len = 0;
+                    state.clients[c].skipping = 0;
+                    ulam_server_current.clients++;
+                    fd = -1;
+                }
+            }
+            if (fd >= 0)
+            {
+                /* Keine freie Verbindung */
+                close(fd);
+            }
+        }
+
+        for (i = 1; i < nfds; i++)
+        {
+            if ((fds[i].revents & POLLOUT) && state.clients[slot[i]].fd >= 0)
+            {
+                ulam_server_flush(&state, slot[i]);
+            }
+            if ((fds[i].revents & (POLLIN | POLLHUP | POLLERR))
+                && state.clients[slot[i]].fd >= 0)
+            {
+                ulam_server_read(&state, slot[i]);
+            }
+        }
+
+        /* Die vorliegenden Zeilen aller Verbindungen zu einem Stapel
+         * zusammenfassen. Der Beginn wechselt reihum, damit ein Client
+         * mit vielen Anfragen die übrigen nicht verdrängt. */
+        now = ulam_server_now();
+        for (i = 0; i < ULAM_SERVER_MAX_CLIENTS; i++)
+        {
+            c = (state.first + i) % ULAM_SERVER_MAX_CLIENTS;
+            if (state.clients[c].fd >= 0)
+            {
+                ulam_server_collect(&state, c, now);
+            }
+        }
+        state.first = (state.first + 1) % ULAM_SERVER_MAX_CLIENTS;
+
+        if (state.count > 0)
+        {
+            ulam_server_process(&state);
+        }
+
+        backlog = 0;
+        for (c = 0; c < ULAM_SERVER_MAX_CLIENTS && !backlog; c++)
+        {
+            backlog = state.clients[c].fd >= 0 
+                      && ulam_server_ready(&state.clients[c]);
+        }
+    }
+
+    for (c = 0; c < ULAM_SERVER_MAX_CLIENTS; c++)
+    {
+        if (state.clients[c].fd >= 0)
+        {
+            ulam_server_close(&state, c);
+        }
+    }
+    ulam_server_percentiles(&state);
+    ulam_server_active = NULL;
+
+    ulam_lru_free(&state.lru);
+    free(state.clients);
+    free(state.requests);
+    free(state.misses);
+    free(state.latencies);
+    close(listen_fd);
+    unlink(path);
+
+    return 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_server_stop
+ * ------------------------------------------------------------------------- */
+void ulam_server_stop(void)
+{
+    ulam_server_stopped = 1;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_server_get_stats
+ * ------------------------------------------------------------------------- */
+void ulam_server_get_stats(ulam_server_stats *stats)
+{
+    if (ulam_server_active != NULL)
+    {
+        ulam_server_percentiles(ulam_server_active);
+    }
+    if (stats != NULL)
+    {
+        *stats = ulam_server_current;
+    }
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_server_now
+ * ------------------------------------------------------------------------- */
+static int64_t ulam_server_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (int64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_server_read
+ * ------------------------------------------------------------------------- */
+static void ulam_server_read(ulam_server_state *state, int c)
+{
+    ulam_server_client *client = &state->clients[c];
+    char *newline;
+    ssize_t n;
+
+    if (!ulam_server_wants_input(client))
+    {
+        /* Erst die gelesenen Zeilen bearbeiten bzw. Antworten senden */
+        return;
+    }
+    if (client->in_len == ULAM_SERVER_BUFFER)
+    {
+        /* Puffer voll ohne vollständige Zeile: die Zeile einmal als
+         * ungültig beantworten und bis zum Zeilenende verwerfen. Alle
+         * früheren Zeilen sind bereits beantwortet. */
+        ulam_server_append(state, c, "error\n", 6);
+        client->skipping = 1;
+        client->in_len = 0;
+    }
+
+    n = read(client->fd, client->in + client->in_len,
+             ULAM_SERVER_BUFFER - client->in_len);
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+    {
+        return;
+    }
+    if (n <= 0)
+    {
+        ulam_server_close(state, c);
+        return;
+    }
+    client->in_len += (size_t) n;
+
+    if (client->skipping)
+    {
+        newline = (char *) memchr(client->in, '\n', client->in_len);
+        if (newline == NULL)
+        {
+            client->in_len = 0;
+            return;
+        }
+        client->in_len -= (size_t) (newline - client->in) + 1;
+        memmove(client->in, newline + 1, client->in_len);
+        client->skipping = 0;
+    }
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_server_wants_input
+ * ------------------------------------------------------------------------- */
+static int ulam_server_wants_input(const ulam_server_client *client)
+{
+    /* Ein voller Puffer ohne Zeilenende wird verworfen, sobald für die
+     * Fehlermeldung Platz im Ausgabepuffer ist */
+    return client->in_len < ULAM_SERVER_BUFFER
+           || (memchr(client->in, '\n', client->in_len) == NULL
+               && ULAM_SERVER_BUFFER - client->out_len >= ULAM_SERVER_ANSWER);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_server_collect
+ * ------------------------------------------------------------------------- */
+static void ulam_server_collect(ulam_server_state *state, int c, int64_t now)
+{
+    ulam_server_client *client = &state->clients[c];
+    ulam_server_request *request;
+    char *newline;
+    size_t room;        /* freie Bytes im Ausgabepuffer */
+    size_t pos = 0;
+    size_t len;
+    int is_stats;
+
+    room = ULAM_SERVER_BUFFER - client->out_len;
+    while (state->count < ULAM_SERVER_BATCH
+           && (newline = (char *) memchr(client->in + pos, '\n',
+                                         client->in_len - pos)) != NULL)
+    {
+        len = (size_t) (newline - (client->in + pos));
+        if (len > 0 && client->in[pos + len - 1] == '\r')
+        {
+            len--;
+        }
+        is_stats = len == 5 && memcmp(client->in + pos, "stats", 5) == 0;
+
+        if (len > 0)
+        {
+            /* Ohne Platz für die Antwort bleibt die Zeile liegen, bis der
+             * Client seine Antworten abgeholt hat */
+            if (room < (is_stats ? ULAM_SERVER_LINE : ULAM_SERVER_ANSWER))
+            {
+                break;
+            }
+            room -= is_stats ? ULAM_SERVER_LINE : ULAM_SERVER_ANSWER;
+
+            request = &state->requests[state->count++];
+            request->client = c;
+            request->cached = 0;
+            request->received_ns = now;
+            request->is_stats = is_stats;
+            ulam_query_parse(client->in + pos, len, &request->query);
+        }
+        pos = (size_t) (newline - client->in) + 1;
+    }
+
+    memmove(client->in, client->in + pos, client->in_len - pos);
+    client->in_len -= pos;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_server_ready
+ * ------------------------------------------------------------------------- */
+static int ulam_server_ready(const ulam_server_client *client)
+{
+    return ULAM_SERVER_BUFFER - client->out_len >= ULAM_SERVER_LINE
+           && memchr(client->in, '\n', client->in_len) != NULL;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_server_nonblocking
+ * ------------------------------------------------------------------------- */
+static int ulam_server_nonblocking(int fd)
+{
+    int flags = fcntl(fd, F_GETFL, 0);
+
+    if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) != 0)
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_server_process
+ * ------------------------------------------------------------------------- */
+static void ulam_server_process(ulam_server_state *state)
+{
+    ulam_server_request *request;
+    ulam_query *query;
+    char line[ULAM_SERVER_LINE];
+    int64_t now;
+    int misses = 0;
+    int len;
+    int i;
+
+    /* Antworten aus dem Cache übernehmen, übrige Anfragen sammeln */
+    for (i = 0; i < state->count; i++)
+    {
+        query = &state->requests[i].query;
+        if (query->type != ULAM_QUERY_INVALID && query->arg1 >= 0 
+            && query->arg2 >= 0
+            && ulam_lru_get(&state->lru, ulam_lru_key(query), &query->result))
+        {
+            state->requests[i].cached = 1;
+            ulam_server_current.cache_hits++;
+        }
+        else
+        {
+            state->misses[misses++] = *query;
+        }
+    }
+
+    /* Alle übrigen Anfragen gemeinsam parallel berechnen */
+    ulam_query_eval_batch(state->misses, misses);
+
+    misses = 0;
+    for (i = 0; i < state->count; i++)
+    {
+        request = &state->requests[i];
+        if (request->cached)
+        {
+            continue;
+        }
+        request->query.result = state->misses[misses++].result;
+        query = &request->query;
+        if (query->type != ULAM_QUERY_INVALID && query->arg1 >= 0 
+            && query->arg2 >= 0)
+        {
+            ulam_lru_put(&state->lru, ulam_lru_key(query), query->result);
+        }
+    }
+
+    /* Statistik des Stapels */
+    ulam_server_current.batches++;
+    state->queued_total += state->count;
+    if (state->count > ulam_server_current.queue_max)
+    {
+        ulam_server_current.queue_max = state->count;
+    }
+    ulam_server_current.queue_avg = (double) state->queued_total
+                                    / ulam_server_current.batches;
+
+    /* Antworten in der Reihenfolge der Anfragen schreiben */
+    for (i = 0; i < state->count; i++)
+    {
+        request = &state->requests[i];
+        if (state->clients[request->client].fd < 0)
+        {
+            continue;
+        }
+
+        if (request->is_stats)
+        {
+            ulam_server_percentiles(state);
+            len = snprintf(line, sizeof(line), 
+                           "requests %lld batches %lld cache_hits %lld "
+                           "clients %d queue_max %d queue_avg %.2f "
+                           "p50_us %.2f p99_us %.2f\n",
+                           ulam_server_current.requests,
+                           ulam_server_current.batches,
+                           ulam_server_current.cache_hits,
+                           ulam_server_current.clients,
+                           ulam_server_current.queue_max,
+                           ulam_server_current.queue_avg,
+                           ulam_server_current.p50_us,
+                           ulam_server_current.p99_us);
+        }
+        else
+        {
+            len = ulam_query_format(&request->query, line, sizeof(line));
+        }
+        ulam_server_append(state, request->client, line, (size_t) len);
+    }
+
+    /* Senden, soweit die Sockets es ohne Blockieren zulassen; der Rest
+     * folgt, sobald poll() POLLOUT meldet */
+    for (i = 0; i < ULAM_SERVER_MAX_CLIENTS; i++)
+    {
+        if (state->clients[i].fd >= 0 && state->clients[i].out_len > 0)
+        {
+            ulam_server_flush(state, i);
+        }
+    }
+
+    /* Antwortzeiten nach dem (ersten) Senden erfassen */
+    now = ulam_server_now();
+    for (i = 0; i < state->count; i++)
+    {
+        state->latencies[ulam_server_current.requests 
+                         % ULAM_SERVER_LATENCY_WINDOW] 
+            = now - state->requests[i].received_ns;
+        ulam_server_current.requests++;
+    }
+
+    state->count = 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_server_append
+ * ------------------------------------------------------------------------- */
+static void ulam_server_append(ulam_server_state *state, int c,
+                               const char *text, size_t len)
+{
+    ulam_server_client *client = &state->clients[c];
+
+    if (client->fd >= 0 && ULAM_SERVER_BUFFER - client->out_len >= len)
+    {
+        memcpy(client->out + client->out_len, text, len);
+        client->out_len += len;
+    }
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_server_flush
+ * ------------------------------------------------------------------------- */
+static void ulam_server_flush(ulam_server_state *state, int c)
+{
+    ulam_server_client *client = &state->clients[c];
+    size_t written = 0;
+    ssize_t n;
+
+    while (written < client->out_len)
+    {
+        n = write(client->fd, client->out + written, 
+                  client->out_len - written);
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            /* Socket voll: Rest beim nächsten POLLOUT senden */
+            break;
+        }
+        if (n <= 0)
+        {
+            ulam_server_close(state, c);
+            return;
+        }
+        written += (size_t) n;
+    }
+
+    memmove(client->out, client->out + written, client->out_len - written);
+    client->out_len -= written;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_server_close
+ * ------------------------------------------------------------------------- */
+static void ulam_server_close(ulam_server_state *state, int c)
+{
+    close(state->clients[c].fd);
+    state->clients[c].fd = -1;
+    state->clients[c].in_len = 0;
+    state->clients[c].out_len = 0;
+    state->clients[c].skipping = 0;
+    ulam_server_current.clients--;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_server_percentiles
+ * ------------------------------------------------------------------------- */
+static void ulam_server_percentiles(ulam_server_state *state)
+{
+    static int64_t sorted[ULAM_SERVER_LATENCY_WINDOW];
+    size_t count;
+
+    count = (ulam_server_current.requests < ULAM_SERVER_LATENCY_WINDOW)
+            ? (size_t) ulam_server_current.requests 
+            : ULAM_SERVER_LATENCY_WINDOW;
+    if (count == 0)
+    {
+        return;
+    }
+
+    memcpy(sorted, state->latencies, count * sizeof(int64_t));
+    qsort(sorted, count, sizeof(int64_t), ulam_server_compare);
+    ulam_server_current.p50_us = sorted[count * 50 / 100] / 1000.0;
+    ulam_server_current.p99_us = sorted[count * 99 / 100] / 1000.0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_server_compare
+ * ------------------------------------------------------------------------- */
+static int ulam_server_compare(const void *a, const void *b)
+{
+    int64_t x = *(const int64_t *) a;
+    int64_t y = *(const int64_t *) b;
+
+    return (x > y) - (x < y);
+}
@@ -0,0 +1,83 @@
+/**
+ * @file
+ * Dieses Modul implementiert einen lokalen Server, der Anfragen an die
+ * ULAM-Funktionen über ein Unix-Domain-Socket beantwortet. Das Protokoll ist
+ * zeilenweise wie beim Programm ulam (siehe ulam_query.h): jede Anfrage
+ * steht in einer Zeile, die Antwort ist eine Zeile mit dem Ergebnis. Ein
+ * Client darf mehrere Anfragen senden, ohne auf die Antworten zu warten;
+ * die Antworten kommen in derselben Reihenfolge zurück. Die Zeile "stats"
+ * liefert die Statistik des Servers als eine Zeile.
+ *
+ * Der Server bedient alle Verbindungen in einer Schleife mit poll(). Alle
+ * Anfragen, die in einem Durchlauf von beliebig vielen Clients eintreffen,
+ * werden zu einem Stapel zusammengefasst. Antworten aus dem LRU-Cache
+ * (siehe ulam_lru.h) werden direkt übernommen, die übrigen Anfragen werden
+ * gemeinsam mit ulam_query_eval_batch() parallel berechnet.
+ *
+ * Alle Verbindungen sind nicht blockierend. Antworten, die ein Client noch
+ * nicht abgeholt hat, bleiben in seinem Ausgabepuffer und werden gesendet,
+ * sobald poll() POLLOUT meldet. Eine Anfrage wird erst in einen Stapel
+ * übernommen, wenn im Ausgabepuffer Platz für ihre Antwort ist; ein Client,
+ * der nicht liest, hält so nur sich selbst auf. Die Verbindung, bei der das
+ * Sammeln eines Stapels beginnt, wechselt reihum.
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+#ifndef ULAM_SERVER_H
+#define ULAM_SERVER_H
+
+/* ============================================================================
+ * Typdefinitionen
+ * ========================================================================= */
+
+/**
+ * Statistik des Servers. Die Perzentile beziehen sich auf die letzten
+ * Anfragen (siehe #ULAM_SERVER_LATENCY_WINDOW in ulam_server.c) und messen
+ * die Zeit vom Lesen einer Anfrage bis zum Schreiben ihrer Antwort.
+ */
+typedef struct
+{
+    long long requests;     /**< beantwortete Anfragen */
+    long long batches;      /**< verarbeitete Stapel */
+    long long cache_hits;   /**< Antworten aus dem LRU-Cache */
+    int clients;            /**< aktuell verbundene Clients */
+    int queue_max;          /**< größte Stapelgröße */
+    double queue_avg;       /**< mittlere Stapelgröße */
+    double p50_us;          /**< Median der Antwortzeit in µs */
+    double p99_us;          /**< 99. Perzentil der Antwortzeit in µs */
+} ulam_server_stats;
+
+
+/* ============================================================================
+ * Funktions-Prototypen
+ * ========================================================================= */
+
+/**
+ * Startet den Server und bedient Anfragen, bis ulam_server_stop() aufgerufen
+ * wird. Eine vorhandene Datei path wird ersetzt.
+ *
+ * @param path          Pfad des Unix-Domain-Sockets
+ * @param lru_capacity  Anzahl der Einträge des LRU-Caches
+ * @return              0 nach dem Beenden oder -1, wenn der Socket nicht
+ *                      angelegt werden kann
+ */
+int ulam_server_run(const char *path, int lru_capacity);
+
+/**
+ * Beendet den Server nach dem aktuellen Durchlauf. Die Funktion darf aus
+ * einem Signal-Handler aufgerufen werden.
+ */
+void ulam_server_stop(void);
+
+/**
+ * Liefert die Statistik des zuletzt bzw. aktuell laufenden Servers. Die
+ * Funktion darf nur im Thread des Servers oder nach dessen Ende aufgerufen
+ * werden.
+ *
+ * @param stats     Ziel für die Statistik
+ */
+void ulam_server_get_stats(ulam_server_stats *stats);
+
+#endif /* ULAM_SERVER_H */
@@ -0,0 +1,580 @@
+/**
+ * @file
+ * Dieses Modul implementiert die Verteilung der Gruppensuche auf mehrere
+ * Prozesse und das Zusammenführen der Shards (siehe ulam_shard.h).
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "ulam_groups.h"
+#include "ulam_parallel.h"
+#include "ulam_sched.h"
+#include "ulam_shard.h"
+
+
+/* ============================================================================
+ * Symbolische Konstanten
+ * ========================================================================= */
+
+/** Anzahl der Gruppen, die beim Lesen eines Shards auf einmal gelesen
+ *  werden */
+#define ULAM_SHARD_CHUNK 4096
+
+/** Größe des Schreibpuffers einer Shard-Datei in Byte */
+#define ULAM_SHARD_BUFFER (1 << 20)
+
+/** Startwert der FNV-1a-Prüfsumme */
+#define ULAM_SHARD_FNV_OFFSET 14695981039346656037ULL
+
+/** Multiplikator der FNV-1a-Prüfsumme */
+#define ULAM_SHARD_FNV_PRIME 1099511628211ULL
+
+
+/* ============================================================================
+ * Typdefinitionen
+ * ========================================================================= */
+
+/**
+ * Zustand beim Schreiben eines Shards.
+ */
+typedef struct
+{
+    FILE *file;                 /**< geöffnete Datei (path.tmp) */
+    ulam_shard_header header;   /**< Kopf, der am Ende geschrieben wird */
+    uint64_t hash;              /**< Prüfsumme der bisherigen Gruppen */
+    int failed;                 /**< 1 nach einem Schreibfehler */
+} ulam_shard_writer;
+
+/**
+ * Gruppe, die beim Zusammenführen noch verlängert werden kann.
+ */
+typedef struct
+{
+    int start;          /**< kleinste Startzahl */
+    int len;            /**< bisherige Länge, 0 = keine Gruppe */
+    int peak;           /**< maximaler ULAM-Wert */
+} ulam_shard_group;
+
+
+/* ============================================================================
+ * Prototypen der privaten Funktionen
+ * ========================================================================= */
+
+/**
+ * Nimmt eine Gruppe des Shards auf (Callback für ulam_groups()). Die erste
+ * und die letzte Gruppe werden im Kopf vermerkt, Gruppen mit mindestens
+ * zwei Gliedern in die Datei geschrieben.
+ *
+ * @param start     kleinste Startzahl der Gruppe
+ * @param len       Länge der Gruppe
+ * @param peak      maximaler ULAM-Wert der Gruppe
+ * @param arg       Zustand (ulam_shard_writer)
+ * @return          0 oder -1 nach einem Schreibfehler
+ */
+static int ulam_shard_write_group(int start, int len, int peak, void *arg);
+
+/**
+ * Öffnet eine Shard-Datei und liest ihren Kopf.
+ *
+ * @param path      Pfad der Shard-Datei
+ * @param header    gelesener Kopf
+ * @return          die geöffnete Datei oder NULL, wenn sie fehlt oder der
+ *                  Kopf ungültig ist
+ */
+static FILE *ulam_shard_open(const char *path, ulam_shard_header *header);
+
+/**
+ * Liest eine Shard-Datei vollständig und prüft Prüfsumme und Gruppen.
+ *
+ * @param path      Pfad der Shard-Datei
+ * @param header    gelesener Kopf
+ * @return          0 oder -1, wenn die Datei ungültig ist
+ */
+static int ulam_shard_verify(const char *path, ulam_shard_header *header);
+
+/**
+ * Meldet eine zusammengeführte Gruppe, wenn sie groß genug ist.
+ *
+ * @param group     Gruppe
+ * @param number    Mindestgröße der gemeldeten Gruppen
+ * @param callback  Funktion, die für die Gruppe aufgerufen wird
+ * @param arg       Argument für callback
+ * @param groups    Anzahl der bisher gemeldeten Gruppen
+ * @return          0, um fortzufahren, sonst der Wert von callback
+ */
+static int ulam_shard_emit(const ulam_shard_group *group, int number,
+                           ulam_group_callback callback, void *arg,
+                           long *groups);
+
+/**
+ * Setzt eine FNV-1a-Prüfsumme über weitere Bytes fort.
+ */
+static uint64_t ulam_shard_fnv(uint64_t hash, const void *data, size_t size);
+
+
+/* ============================================================================
+ * Funktionsdefinitionen
+ * ========================================================================= */
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_shard_run
+ * ------------------------------------------------------------------------- */
+int ulam_shard_run(const char *path, int lo, int hi)
+{
+    ulam_shard_writer writer;
+    char tmp_path[4096];
+    int ok;
+
+    if (path == NULL || lo < 1 || lo > hi
+        || (size_t) snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path) 
+           >= sizeof(tmp_path))
+    {
+        return -1;
+    }
+
+    memset(&writer, 0, sizeof(writer));
+    memcpy(writer.header.magic, ULAM_SHARD_MAGIC, sizeof(ULAM_SHARD_MAGIC));
+    writer.header.version = ULAM_SHARD_VERSION;
+    writer.header.lo = lo;
+    writer.header.hi = hi;
+    writer.hash = ULAM_SHARD_FNV_OFFSET;
+
+    writer.file = fopen(tmp_path, "wb");
+    if (writer.file == NULL)
+    {
+        return -1;
+    }
+    setvbuf(writer.file, NULL, _IOFBF, ULAM_SHARD_BUFFER);
+
+    /* Platz für den Kopf, der erst am Ende bekannt ist */
+    ok = fwrite(&writer.header, sizeof(writer.header), 1, writer.file) == 1;
+    ok = ok && ulam_groups(lo, hi, 1, ulam_shard_write_group, &writer) >= 0
+         && !writer.failed;
+
+    writer.header.checksum = ulam_shard_fnv(writer.hash, &writer.header,
+                                 offsetof(ulam_shard_header, checksum));
+    ok = ok && fseek(writer.file, 0, SEEK_SET) == 0
+         && fwrite(&writer.header, sizeof(writer.header), 1, 
+                   writer.file) == 1;
+    ok = (fclose(writer.file) == 0) && ok;
+    ok = ok && rename(tmp_path, path) == 0;
+    if (!ok)
+    {
+        remove(tmp_path);
+        return -1;
+    }
+
+    return 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_shard_sweep
+ * ------------------------------------------------------------------------- */
+int ulam_shard_sweep(const char *prefix, int lo, int hi, int shards,
+                     int workers)
+{
+    char path[4096];
+    long long count;
+    int shard_lo;
+    int shard_hi;
+    pid_t *pids;
+    int started;
+    int status;
+    int ok;
+    int w;
+    int i;
+
+    if (prefix == NULL || lo < 1 || lo > hi || shards < 1 || workers < 1
+        || shards > (long long) hi - lo + 1)
+    {
+        return -1;
+    }
+    if (workers > shards)
+    {
+        workers = shards;
+    }
+
+    pids = (pid_t *) malloc((size_t) workers * sizeof(pid_t));
+    if (pids == NULL)
+    {
+        return -1;
+    }
+
+    /* Kindprozesse erben nur den aufrufenden Thread; der Pool darf beim
+     * fork() nicht laufen, gepufferte Ausgaben dürfen nicht doppelt
+     * erscheinen */
+    ulam_sched_shutdown();
+    fflush(stdout);
+    fflush(stderr);
+
+    count = (long long) hi - lo + 1;
+    for (started = 0; started < workers; started++)
+    {
+        pids[started] = fork();
+        if (pids[started] < 0)
+        {
+            break;
+        }
+        if (pids[started] > 0)
+        {
+            continue;
+        }
+
+        /* Kindprozess: Shards w, w + workers, ... nacheinander berechnen,
+         * so dass alle Prozesse ähnlich weit oben im Intervall rechnen */
+        ulam_parallel_set_threads(1);
+        ok = 1;
+        for (i = started; ok && i < shards; i += workers)
+        {
+            shard_lo = (int) (lo + count * i / shards);
+            shard_hi = (int) (lo + count * (i + 1) / shards - 1);
+            ok = ulam_shard_path(path, sizeof(path), prefix, i) == 0
+                 && ulam_shard_run(path, shard_lo, shard_hi) == 0;
+        }
+        _exit(ok ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    ok = started == workers;
+    for (w = 0; w < started; w++)
+    {
+        if (waitpid(pids[w], &status, 0) != pids[w]
+            || !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)
+        {
+            ok = 0;
+        }
+    }
+    free(pids);
+
+    return ok ? 0 : -1;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_shard_path
+ * ------------------------------------------------------------------------- */
+int ulam_shard_path(char *buffer, size_t size, const char *prefix, int index)
+{
+    int n;
+
+    n = snprintf(buffer, size, "%s.%04d", prefix, index);
+
+    return (n < 0 || (size_t) n >= size) ? -1 : 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_shard_merge
+ * ------------------------------------------------------------------------- */
+long ulam_shard_merge(const char *const paths[], int count, int number,
+                      ulam_group_callback callback, void *arg)
+{
+    ulam_shard_header header;
+    ulam_shard_group pending;   /* Gruppe, die am Shardende offen ist */
+    ulam_shard_group first;
+    int32_t chunk[3 * ULAM_SHARD_CHUNK];
+    long groups = 0;
+    long long expected_lo = 0;
+    int64_t left;
+    size_t n;
+    size_t j;
+    FILE *file;
+    int s;
+
+    if (paths == NULL || count < 1 || number < 1 || callback == NULL)
+    {
+        return -1;
+    }
+
+    /* Zuerst alle Shards prüfen, damit keine Gruppe aus einem
+     * unvollständigen Ergebnis gemeldet wird */
+    for (s = 0; s < count; s++)
+    {
+        if (ulam_shard_verify(paths[s], &header) != 0
+            || (s > 0 && header.lo != expected_lo))
+        {
+            return -1;
+        }
+        expected_lo = (long long) header.hi + 1;
+    }
+
+    memset(&pending, 0, sizeof(pending));
+    for (s = 0; s < count; s++)
+    {
+        file = ulam_shard_open(paths[s], &header);
+        if (file == NULL)
+        {
+            return -1;
+        }
+
+        /* Die erste Gruppe setzt eine offene Gruppe gleichen Maximums
+         * fort */
+        first.start = header.lo;
+        first.len = header.first_len;
+        first.peak = header.first_peak;
+        if (pending.len > 0 && pending.peak == first.peak)
+        {
+            pending.len += first.len;
+        }
+        else
+        {
+            if (ulam_shard_emit(&pending, number, callback, arg, 
+                                &groups) != 0)
+            {
+                fclose(file);
+                return groups;
+            }
+            pending = first;
+        }
+
+        /* Besteht der Shard aus einer einzigen Gruppe, bleibt sie offen */
+        if (header.first_len == header.hi - header.lo + 1)
+        {
+            fclose(file);
+            continue;
+        }
+
+        if (ulam_shard_emit(&pending, number, callback, arg, &groups) != 0)
+        {
+            fclose(file);
+            return groups;
+        }
+
+        /* Innere Gruppen unverändert melden, die Randgruppen sind aus dem
+         * Kopf bekannt */
+        left = header.count;
+        while (left > 0)
+        {
+            n = (left < ULAM_SHARD_CHUNK) ? (size_t) left : ULAM_SHARD_CHUNK;
+            if (fread(chunk, 3 * sizeof(int32_t), n, file) != n)
+            {
+                fclose(file);
+                return -1;
+            }
+            left -= (int64_t) n;
+
+            for (j = 0; j < n; j++)
+            {
+                if (chunk[3 * j] == header.lo
+                    || chunk[3 * j] + chunk[3 * j + 1] - 1 == header.hi
+                    || chunk[3 * j + 1] < number)
+                {
+                    continue;
+                }
+                groups++;
+                if (callback(chunk[3 * j], chunk[3 * j + 1], 
+                             chunk[3 * j + 2], arg) != 0)
+                {
+                    fclose(file);
+                    return groups;
+                }
+            }
+        }
+        fclose(file);
+
+        pending.start = header.hi - header.last_len + 1;
+        pending.len = header.last_len;
+        pending.peak = header.last_peak;
+    }
+
+    /* Letzte Gruppe endet beim letzten Shard */
+    ulam_shard_emit(&pending, number, callback, arg, &groups);
+
+    return groups;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_shard_bounds
+ * ------------------------------------------------------------------------- */
+int ulam_shard_bounds(const char *const paths[], int count, int *lo, int *hi)
+{
+    ulam_shard_header header;
+    FILE *file;
+
+    if (paths == NULL || count < 1)
+    {
+        return -1;
+    }
+
+    file = ulam_shard_open(paths[0], &header);
+    if (file == NULL)
+    {
+        return -1;
+    }
+    fclose(file);
+    *lo = header.lo;
+
+    file = ulam_shard_open(paths[count - 1], &header);
+    if (file == NULL)
+    {
+        return -1;
+    }
+    fclose(file);
+    *hi = header.hi;
+
+    return 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_shard_write_group
+ * ------------------------------------------------------------------------- */
+static int ulam_shard_write_group(int start, int len, int peak, void *arg)
+{
+    ulam_shard_writer *writer = (ulam_shard_writer *) arg;
+    int32_t group[3];
+
+    if (start == writer->header.lo)
+    {
+        writer->header.first_len = len;
+        writer->header.first_peak = peak;
+    }
+    writer->header.last_len = len;
+    writer->header.last_peak = peak;
+
+    if (len < 2)
+    {
+        return 0;
+    }
+
+    group[0] = start;
+    group[1] = len;
+    group[2] = peak;
+    if (fwrite(group, sizeof(group), 1, writer->file) != 1)
+    {
+        writer->failed = 1;
+        return -1;
+    }
+    writer->hash = ulam_shard_fnv(writer->hash, group, sizeof(group));
+    writer->header.count++;
+
+    return 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_shard_open
+ * ------------------------------------------------------------------------- */
+static FILE *ulam_shard_open(const char *path, ulam_shard_header *header)
+{
+    FILE *file;
+    long long size;
+
+    file = (path != NULL) ? fopen(path, "rb") : NULL;
+    if (file == NULL)
+    {
+        return NULL;
+    }
+
+    if (fread(header, sizeof(*header), 1, file) != 1
+        || memcmp(header->magic, ULAM_SHARD_MAGIC, 
+                  sizeof(ULAM_SHARD_MAGIC)) != 0
+        || header->version != ULAM_SHARD_VERSION
+        || header->lo < 1 || header->lo > header->hi)
+    {
+        fclose(file);
+        return NULL;
+    }
+
+    /* Randgruppen und Anzahl der Gruppen müssen in den Shard passen */
+    size = (long long) header->hi - header->lo + 1;
+    if (header->first_len < 1 || header->first_len > size
+        || header->last_len < 1 || header->last_len > size
+        || header->count < 0 || header->count > size / 2)
+    {
+        fclose(file);
+        return NULL;
+    }
+
+    return file;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_shard_verify
+ * ------------------------------------------------------------------------- */
+static int ulam_shard_verify(const char *path, ulam_shard_header *header)
+{
+    int32_t chunk[3 * ULAM_SHARD_CHUNK];
+    uint64_t hash = ULAM_SHARD_FNV_OFFSET;
+    long long next;         /* kleinste zulässige Startzahl */
+    int64_t left;
+    size_t n;
+    size_t j;
+    FILE *file;
+    int ok = 1;
+
+    file = ulam_shard_open(path, header);
+    if (file == NULL)
+    {
+        return -1;
+    }
+
+    next = header->lo;
+    left = header->count;
+    while (ok && left > 0)
+    {
+        n = (left < ULAM_SHARD_CHUNK) ? (size_t) left : ULAM_SHARD_CHUNK;
+        ok = fread(chunk, 3 * sizeof(int32_t), n, file) == n;
+        left -= (int64_t) n;
+
+        /* Gruppen aufsteigend, disjunkt und innerhalb des Shards */
+        for (j = 0; ok && j < n; j++)
+        {
+            ok = chunk[3 * j] >= next && chunk[3 * j + 1] >= 2
+                 && (long long) chunk[3 * j] + chunk[3 * j + 1] - 1 
+                    <= header->hi;
+            next = (long long) chunk[3 * j] + chunk[3 * j + 1];
+        }
+        if (ok)
+        {
+            hash = ulam_shard_fnv(hash, chunk, n * 3 * sizeof(int32_t));
+        }
+    }
+    ok = ok && fgetc(file) == EOF;
+    fclose(file);
+
+    hash = ulam_shard_fnv(hash, header, offsetof(ulam_shard_header, checksum));
+
+    return (ok && hash == header->checksum) ? 0 : -1;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_shard_emit
+ * ------------------------------------------------------------------------- */
+static int ulam_shard_emit(const ulam_shard_group *group, int number,
+                           ulam_group_callback callback, void *arg,
+                           long *groups)
+{
+    if (group->len < number)
+    {
+        return 0;
+    }
+
+    (*groups)++;
+    return callback(group->start, group->len, group->peak, arg);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_shard_fnv
+ * ------------------------------------------------------------------------- */
+static uint64_t ulam_shard_fnv(uint64_t hash, const void *data, size_t size)
+{
+    const unsigned char *bytes = (const unsigned char *) data;
+    size_t i;
+
+    for (i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= ULAM_SHARD_FNV_PRIME;
+    }
+
+    return hash;
+}
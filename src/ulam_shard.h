@@ -0,0 +1,150 @@
+/**
+ * @file
+ * Dieses Modul verteilt die Suche nach Gruppen gleicher maximaler
+ * ULAM-Werte auf mehrere Prozesse. Ein Intervall [lo, hi] wird in Scheiben
+ * (Shards) zerlegt, die unabhängige Kindprozesse mit ulam_groups()
+ * berechnen. Jeder Shard wird in eine eigene Datei geschrieben und enthält
+ * neben allen Gruppen mit mindestens zwei Gliedern die erste und die letzte
+ * Gruppe des Shards, auch wenn diese nur ein Glied haben. Über diese
+ * Randgruppen setzt ulam_shard_merge() Gruppen, die über Shardgrenzen
+ * hinausreichen, wieder zusammen und liefert exakt dieselben Gruppen wie
+ * ulam_groups() über das gesamte Intervall. Mit ulam_runs_build_shards()
+ * wird daraus der Lauf-Index für ulam_runs_twins() und
+ * ulam_runs_multiples() aufgebaut.
+ *
+ * Die Shards können auch einzeln mit ulam_shard_run() (z.B. auf anderen
+ * Rechnern) berechnet und danach gemeinsam zusammengeführt werden.
+ *
+ * Aufbau einer Shard-Datei: ein Kopf (#ulam_shard_header), dahinter je
+ * Gruppe mit mindestens zwei Gliedern Start, Länge und Maximum als int32_t
+ * in aufsteigender Reihenfolge.
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+#ifndef ULAM_SHARD_H
+#define ULAM_SHARD_H
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ulam_groups.h"
+
+
+/* ============================================================================
+ * Symbolische Konstanten
+ * ========================================================================= */
+
+/** Kennung am Anfang einer Shard-Datei */
+#define ULAM_SHARD_MAGIC "ULAMSHD"
+
+/** Version des Dateiformats */
+#define ULAM_SHARD_VERSION 1
+
+
+/* ============================================================================
+ * Typdefinitionen
+ * ========================================================================= */
+
+/**
+ * Kopf einer Shard-Datei.
+ */
+typedef struct
+{
+    char magic[8];          /**< #ULAM_SHARD_MAGIC */
+    uint32_t version;       /**< #ULAM_SHARD_VERSION */
+    uint32_t reserved;      /**< 0 */
+    int32_t lo;             /**< kleinste Startzahl des Shards */
+    int32_t hi;             /**< größte Startzahl des Shards */
+    int32_t first_len;      /**< Länge der Gruppe, die bei lo beginnt */
+    int32_t first_peak;     /**< deren maximaler ULAM-Wert */
+    int32_t last_len;       /**< Länge der Gruppe, die bei hi endet */
+    int32_t last_peak;      /**< deren maximaler ULAM-Wert */
+    int64_t count;          /**< Anzahl der gespeicherten Gruppen */
+    uint64_t checksum;      /**< FNV-1a über die Gruppen und danach über
+                                 den Kopf bis vor checksum */
+} ulam_shard_header;
+
+
+/* ============================================================================
+ * Funktions-Prototypen
+ * ========================================================================= */
+
+/**
+ * Berechnet einen Shard im aufrufenden Prozess und schreibt ihn in eine
+ * Datei. Die Datei wird zunächst unter path.tmp geschrieben und erst nach
+ * Abschluss umbenannt.
+ *
+ * @param path      Pfad der Shard-Datei
+ * @param lo        kleinste Startzahl (>= 1)
+ * @param hi        größte Startzahl (>= lo)
+ * @return          0 oder -1 bei ungültigen Parametern oder Schreibfehlern
+ */
+int ulam_shard_run(const char *path, int lo, int hi);
+
+/**
+ * Zerlegt [lo, hi] in shards gleich große Shards und berechnet sie in
+ * workers gleichzeitig laufenden Kindprozessen mit je einem Thread. Shard i
+ * wird in die Datei ulam_shard_path(prefix, i) geschrieben. Vor dem Start
+ * der Kindprozesse werden die Hilfsthreads des Schedulers beendet; die
+ * Funktion darf daher nicht gleichzeitig mit anderen Berechnungen
+ * aufgerufen werden.
+ *
+ * @param prefix    Präfix der Shard-Dateien
+ * @param lo        kleinste Startzahl (>= 1)
+ * @param hi        größte Startzahl (>= lo)
+ * @param shards    Anzahl der Shards (>= 1, höchstens hi - lo + 1)
+ * @param workers   Anzahl der gleichzeitigen Prozesse (>= 1)
+ * @return          0, wenn alle Shards geschrieben wurden, sonst -1
+ */
+int ulam_shard_sweep(const char *prefix, int lo, int hi, int shards,
+                     int workers);
+
+/**
+ * Bildet den Pfad des Shards index zu einem Präfix ("prefix.0007").
+ *
+ * @param buffer    Puffer für den Pfad
+ * @param size      Größe des Puffers
+ * @param prefix    Präfix der Shard-Dateien
+ * @param index     Nummer des Shards
+ * @return          0 oder -1, wenn der Puffer zu klein ist
+ */
+int ulam_shard_path(char *buffer, size_t size, const char *prefix, int index);
+
+/**
+ * Führt Shards zusammen und ruft für jede Gruppe gleicher Maxima mit
+ * mindestens number Gliedern die Funktion callback auf, in aufsteigender
+ * Reihenfolge und genau wie ulam_groups() über die Vereinigung der
+ * Shards. Die Shards müssen in aufsteigender Reihenfolge lückenlos
+ * aufeinander folgen. Alle Dateien werden vor der ersten Meldung geprüft.
+ *
+ * @param paths     Pfade der Shard-Dateien
+ * @param count     Anzahl der Shards (>= 1)
+ * @param number    Mindestgröße der gemeldeten Gruppen (>= 1)
+ * @param callback  Funktion, die für jede Gruppe aufgerufen wird
+ * @param arg       beliebiges Argument für callback
+ * @return          die Anzahl der gemeldeten Gruppen oder -1, wenn eine
+ *                  Datei fehlt oder ungültig ist oder die Shards nicht
+ *                  lückenlos aufeinander folgen
+ */
+long ulam_shard_merge(const char *const paths[], int count, int number,
+                      ulam_group_callback callback, void *arg);
+
+/**
+ * Liefert das Intervall, das eine Folge von Shards abdeckt, ohne die
+ * Gruppen zu lesen.
+ *
+ * @param paths     Pfade der Shard-Dateien
+ * @param count     Anzahl der Shards (>= 1)
+ * @param lo        kleinste Startzahl des ersten Shards
+ * @param hi        größte Startzahl des letzten Shards
+ * @return          0 oder -1, wenn ein Kopf fehlt oder ungültig ist
+ */
+int ulam_shard_bounds(const char *const paths[], int count, int *lo, int *hi);
+
+#endif /* ULAM_SHARD_H */
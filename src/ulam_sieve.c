@@ -0,0 +1,87 @@
+/**
+ * @file
+ * Dieses Modul implementiert die Berechnung der maximalen ULAM-Werte aller
+ * Startzahlen bis n im Sieb-Verfahren (siehe ulam_sieve.h).
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ulam_sieve.h"
+
+
+/* ============================================================================
+ * Funktionsdefinitionen
+ * ========================================================================= */
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_peak_table
+ * ------------------------------------------------------------------------- */
+int ulam_peak_table(int n, int64_t peaks[])
+{
+    uint64_t a0;
+    uint64_t an;        /* aktuelles Folgenglied */
+    uint64_t max_value; /* max. ULAM-Wert in der Folge von a0 bis an */
+
+    if (n < 0 || peaks == NULL)
+    {
+        return -1;
+    }
+
+    peaks[0] = -1;
+    if (n >= 1)
+    {
+        peaks[1] = 1;
+    }
+
+    for (a0 = 2; a0 <= (uint64_t) n; a0++)
+    {
+        /* Gerade Startzahl: a0 / 2 ist bereits berechnet */
+        if (a0 % 2 == 0)
+        {
+            max_value = (uint64_t) peaks[a0 / 2];
+            peaks[a0] = (int64_t) (max_value > a0 ? max_value : a0);
+            continue;
+        }
+
+        /*
+         * Ungerade Startzahl: Folge verfolgen, bis sie unter a0 fällt. Die
+         * geraden Schritte werden auf einmal ausgeführt; alle dabei 
+         * übersprungenen Glieder sind kleiner als das vorangehende 3 * an + 1.
+         */
+        an = a0;
+        max_value = a0;
+        while (an >= a0)
+        {
+            if (an > (UINT64_MAX - 1) / 3)
+            {
+                return -1;
+            }
+            an = 3 * an + 1;
+            if (an > max_value)
+            {
+                max_value = an;
+            }
+            an >>= __builtin_ctzll(an);
+        }
+
+        if ((uint64_t) peaks[an] > max_value)
+        {
+            max_value = (uint64_t) peaks[an];
+        }
+        if (max_value > INT64_MAX)
+        {
+            return -1;
+        }
+        peaks[a0] = (int64_t) max_value;
+    }
+
+    return 0;
+}
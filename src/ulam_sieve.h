@@ -0,0 +1,43 @@
+/**
+ * @file
+ * Dieses Modul berechnet die maximalen ULAM-Werte aller Startzahlen von 1 bis
+ * n in einem Durchlauf (Sieb-Verfahren). Statt jede Folge bis 1 zu
+ * verfolgen, wird die Rekursion peak(a) = max(a, peak(ulam(a))) ausgenutzt:
+ * Für gerade a ist peak(a) = max(a, peak(a / 2)) sofort bekannt, ungerade a
+ * werden nur so lange verfolgt, bis die Folge unter a fällt und damit den
+ * bereits berechneten Bereich erreicht.
+ *
+ * Die Maxima werden mit 64 Bit berechnet, es kommt also im Gegensatz zu
+ * ulam_max() für keine int-Startzahl zu einem Überlauf.
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+#ifndef ULAM_SIEVE_H
+#define ULAM_SIEVE_H
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <stdint.h>
+
+
+/* ============================================================================
+ * Funktions-Prototypen
+ * ========================================================================= */
+
+/**
+ * Füllt peaks[0..n] mit den maximalen ULAM-Werten der Startzahlen 0 bis n.
+ * peaks[0] erhält wie ulam_max(0) den Wert -1.
+ *
+ * @param n         größte Startzahl, für die das Maximum berechnet wird
+ * @param peaks     Feld mit mindestens n + 1 Einträgen für die Ergebnisse
+ * @return          0, wenn die Tabelle gefüllt wurde, oder -1, wenn n < 0
+ *                  ist, peaks NULL ist oder ein Maximum nicht mit 64 Bit
+ *                  darstellbar ist
+ */
+int ulam_peak_table(int n, int64_t peaks[]);
+
+#endif /* ULAM_SIEVE_H */
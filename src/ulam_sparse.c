@@ -0,0 +1,205 @@
+/**
+ * @file
+ * Dieses Modul implementiert den dünn besetzten Cache für maximale
+ * ULAM-Werte großer Folgenglieder (siehe ulam_sparse.h).
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "ulam_sparse.h"
+
+
+/* ============================================================================
+ * Symbolische Konstanten
+ * ========================================================================= */
+
+/** Anzahl der Einträge, die für ein Folgenglied durchsucht werden */
+#define ULAM_SPARSE_PROBES 8
+
+/** Referenzbit eines Eintrags */
+#define ULAM_SPARSE_REF ((uint64_t) 1)
+
+/*
+ * Aufbau eines Eintrags: Bit 32 bis 62 Folgenglied, Bit 1 bis 31 Maximum,
+ * Bit 0 Referenzbit. 0 kennzeichnet einen freien Eintrag.
+ */
+#define ULAM_SPARSE_PACK(an, peak) \
+    (((uint64_t) (an) << 32) | ((uint64_t) (peak) << 1))
+#define ULAM_SPARSE_KEY(entry)  ((int) ((entry) >> 32))
+#define ULAM_SPARSE_PEAK(entry) ((int) (((entry) >> 1) & 0x7fffffff))
+
+
+/* ============================================================================
+ * Globale Variablen
+ * ========================================================================= */
+
+/** Einträge des Caches */
+static uint64_t *ulam_sparse_slots = NULL;
+
+size_t ulam_sparse_size = 0;
+
+
+/* ============================================================================
+ * Prototypen der privaten Funktionen
+ * ========================================================================= */
+
+/**
+ * Liefert den ersten Eintrag des Suchfensters von an.
+ */
+static inline size_t ulam_sparse_home(int an);
+
+
+/* ============================================================================
+ * Funktionsdefinitionen
+ * ========================================================================= */
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_sparse_set_budget
+ * ------------------------------------------------------------------------- */
+int ulam_sparse_set_budget(size_t bytes)
+{
+    size_t size = 0;
+
+    free(ulam_sparse_slots);
+    ulam_sparse_slots = NULL;
+    ulam_sparse_size = 0;
+
+    /* Größte Zweierpotenz an Einträgen innerhalb des Budgets */
+    if (bytes / sizeof(uint64_t) >= ULAM_SPARSE_PROBES)
+    {
+        size = ULAM_SPARSE_PROBES;
+        while (size * 2 <= bytes / sizeof(uint64_t))
+        {
+            size *= 2;
+        }
+        ulam_sparse_slots = (uint64_t *) calloc(size, sizeof(uint64_t));
+        if (ulam_sparse_slots == NULL)
+        {
+            return -1;
+        }
+    }
+
+    ulam_sparse_size = size;
+
+    return 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_sparse_get_budget
+ * ------------------------------------------------------------------------- */
+size_t ulam_sparse_get_budget(void)
+{
+    return ulam_sparse_size * sizeof(uint64_t);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_sparse_lookup
+ * ------------------------------------------------------------------------- */
+int ulam_sparse_lookup(int an)
+{
+    size_t home;
+    size_t slot;
+    uint64_t entry;
+    int i;
+
+    if (ulam_sparse_size == 0)
+    {
+        return 0;
+    }
+
+    home = ulam_sparse_home(an);
+    for (i = 0; i < ULAM_SPARSE_PROBES; i++)
+    {
+        slot = (home + i) & (ulam_sparse_size - 1);
+        entry = __atomic_load_n(&ulam_sparse_slots[slot], __ATOMIC_RELAXED);
+        if (entry != 0 && ULAM_SPARSE_KEY(entry) == an)
+        {
+            /* Zweite Chance bei der nächsten Verdrängung; wurde der Eintrag
+             * inzwischen ersetzt, trifft das Bit nur einen anderen */
+            if ((entry & ULAM_SPARSE_REF) == 0)
+            {
+                __atomic_fetch_or(&ulam_sparse_slots[slot], ULAM_SPARSE_REF,
+                                  __ATOMIC_RELAXED);
+            }
+            return ULAM_SPARSE_PEAK(entry);
+        }
+    }
+
+    return 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_sparse_insert
+ * ------------------------------------------------------------------------- */
+void ulam_sparse_insert(int an, int peak)
+{
+    const uint64_t value = ULAM_SPARSE_PACK(an, peak);
+    size_t home;
+    size_t slot;
+    uint64_t entry;
+    int round;
+    int i;
+
+    if (ulam_sparse_size == 0 || an < 1 || peak < 1)
+    {
+        return;
+    }
+
+    /*
+     * Zwei Runden über das Suchfenster: freie Einträge belegen, Einträge
+     * ohne Referenzbit ersetzen, sonst das Referenzbit löschen. Schlägt ein
+     * CAS fehl, hat ein anderer Thread den Eintrag geändert; er wird dann
+     * übergangen. Da das Maximum zu an eindeutig ist, schaden doppelte
+     * Einträge nicht.
+     */
+    home = ulam_sparse_home(an);
+    for (round = 0; round < 2; round++)
+    {
+        for (i = 0; i < ULAM_SPARSE_PROBES; i++)
+        {
+            slot = (home + i) & (ulam_sparse_size - 1);
+            entry = __atomic_load_n(&ulam_sparse_slots[slot], 
+                                    __ATOMIC_RELAXED);
+
+            if (entry != 0 && ULAM_SPARSE_KEY(entry) == an)
+            {
+                return;
+            }
+            if (entry == 0 || (round > 0 && (entry & ULAM_SPARSE_REF) == 0))
+            {
+                if (__atomic_compare_exchange_n(&ulam_sparse_slots[slot],
+                                                &entry, value, 0,
+                                                __ATOMIC_RELAXED,
+                                                __ATOMIC_RELAXED))
+                {
+                    return;
+                }
+            }
+            else if (round > 0)
+            {
+                __atomic_compare_exchange_n(&ulam_sparse_slots[slot], &entry,
+                                            entry & ~ULAM_SPARSE_REF, 0,
+                                            __ATOMIC_RELAXED,
+                                            __ATOMIC_RELAXED);
+            }
+        }
+    }
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_sparse_home
+ * ------------------------------------------------------------------------- */
+static inline size_t ulam_sparse_home(int an)
+{
+    /* Fibonacci-Hashing, die hohen Bits streuen am besten */
+    return (size_t) (((uint64_t) an * 0x9e3779b97f4a7c15ULL) >> 32)
+           & (ulam_sparse_size - 1);
+}
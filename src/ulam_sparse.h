@@ -0,0 +1,96 @@
+/**
+ * @file
+ * Dieses Modul verwaltet einen dünn besetzten Cache für maximale ULAM-Werte
+ * großer Folgenglieder. Der dichte Cache (siehe ulam_cache.h) deckt nur
+ * Startzahlen bis zu seiner Größe ab; die Folgen großer Startzahlen laufen
+ * aber durch große Zwischenwerte, die in den Folgen vieler Startzahlen
+ * wiederkehren. Der dünne Cache ordnet solchen Folgengliedern an das
+ * Maximum der restlichen Folge zu.
+ *
+ * Der Cache ist eine Hash-Tabelle mit offener Adressierung und fester
+ * Größe. Jeder Eintrag ist ein 64-Bit-Wort aus Folgenglied, Maximum und
+ * einem Referenzbit und wird nur mit atomaren Operationen (CAS) gelesen und
+ * geschrieben, so dass alle Threads den Cache ohne Mutex gemeinsam nutzen.
+ * Ist das Suchfenster eines Folgenglieds voll, wird ein Eintrag nach dem
+ * Second-Chance-Verfahren verdrängt: Einträge mit gesetztem Referenzbit
+ * verlieren es und werden erst beim nächsten Mal ersetzt.
+ *
+ * ulam_max() fragt den Cache nur für Folgenglieder oberhalb des dichten
+ * Caches ab, die durch #ULAM_SPARSE_SAMPLE teilbar sind. Da die Auswahl vom
+ * Wert und nicht von der Position abhängt, treffen zwei Folgen, die sich
+ * vereinigen, nach wenigen Schritten auf denselben Eintrag.
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+#ifndef ULAM_SPARSE_H
+#define ULAM_SPARSE_H
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+/* ============================================================================
+ * Symbolische Konstanten
+ * ========================================================================= */
+
+/** Nur Folgenglieder, die durch diesen Wert teilbar sind, werden im Cache
+ *  gesucht und abgelegt (Zweierpotenz) */
+#define ULAM_SPARSE_SAMPLE 8
+
+
+/* ============================================================================
+ * Globale Variablen
+ * ========================================================================= */
+
+/**
+ * Anzahl der Einträge des Caches; 0, wenn der Cache abgeschaltet ist.
+ */
+extern size_t ulam_sparse_size;
+
+
+/* ============================================================================
+ * Funktions-Prototypen
+ * ========================================================================= */
+
+/**
+ * Legt den Cache mit höchstens bytes Byte an bzw. schaltet ihn mit 0 ab.
+ * Ein vorhandener Cache wird verworfen. Die Funktion darf nicht
+ * gleichzeitig mit Zugriffen auf den Cache aufgerufen werden.
+ *
+ * @param bytes     maximale Größe des Caches in Byte
+ * @return          0 oder -1, wenn nicht genügend Speicher vorhanden ist
+ */
+int ulam_sparse_set_budget(size_t bytes);
+
+/**
+ * Liefert die aktuelle Größe des Caches in Byte.
+ *
+ * @return          die Größe des Caches in Byte
+ */
+size_t ulam_sparse_get_budget(void);
+
+/**
+ * Sucht das Maximum der Folge ab dem Folgenglied an. Die Funktion ist
+ * threadsicher.
+ *
+ * @param an        Folgenglied (> 0)
+ * @return          das Maximum oder 0, wenn an nicht im Cache steht
+ */
+int ulam_sparse_lookup(int an);
+
+/**
+ * Trägt das Maximum der Folge ab dem Folgenglied an ein. Die Funktion ist
+ * threadsicher.
+ *
+ * @param an        Folgenglied (> 0)
+ * @param peak      Maximum der Folge ab an
+ */
+void ulam_sparse_insert(int an, int peak);
+
+#endif /* ULAM_SPARSE_H */
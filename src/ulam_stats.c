@@ -0,0 +1,159 @@
+/**
+ * @file
+ * Dieses Modul implementiert die Instrumentierungszähler (siehe
+ * ulam_stats.h).
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "ulam_registry.h"
+#include "ulam_stats.h"
+
+
+/* ============================================================================
+ * Symbolische Konstanten
+ * ========================================================================= */
+
+/** Anzahl der Zähler; alle Zähler bestehen aus uint64_t */
+#define ULAM_STATS_FIELDS (sizeof(ulam_stats_counters) / sizeof(uint64_t))
+
+
+/* ============================================================================
+ * Prototypen der privaten Funktionen
+ * ========================================================================= */
+
+/**
+ * Addiert die Zähler eines Threads zu einer Summe (für
+ * ulam_registry_visit()).
+ *
+ * @param block     Zähler des Threads
+ * @param arg       Summe (ulam_stats_counters)
+ */
+static void ulam_stats_sum(void *block, void *arg);
+
+/**
+ * Setzt die Zähler eines Threads zurück (für ulam_registry_visit()).
+ *
+ * @param block     Zähler des Threads
+ * @param arg       nicht verwendet
+ */
+static void ulam_stats_clear(void *block, void *arg);
+
+
+/* ============================================================================
+ * Globale Variablen
+ * ========================================================================= */
+
+/** Zähler für den Fall, dass kein Speicher angelegt werden kann */
+static ulam_stats_counters ulam_stats_fallback;
+
+/** Summe der Zähler beendeter Threads */
+static ulam_stats_counters ulam_stats_retired;
+
+/** Zählerblöcke aller Threads */
+static ulam_registry ulam_stats_registry =
+    ULAM_REGISTRY_INIT(sizeof(ulam_stats_counters), &ulam_stats_fallback,
+                       &ulam_stats_retired, ulam_stats_sum);
+
+
+/* ============================================================================
+ * Funktionsdefinitionen
+ * ========================================================================= */
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_stats_enabled
+ * ------------------------------------------------------------------------- */
+int ulam_stats_enabled(void)
+{
+#ifdef ULAM_STATS
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_stats_snapshot
+ * ------------------------------------------------------------------------- */
+void ulam_stats_snapshot(ulam_stats_counters *snapshot)
+{
+    if (snapshot == NULL)
+    {
+        return;
+    }
+    memset(snapshot, 0, sizeof(*snapshot));
+    ulam_registry_visit(&ulam_stats_registry, ulam_stats_sum, snapshot);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_stats_reset
+ * ------------------------------------------------------------------------- */
+void ulam_stats_reset(void)
+{
+    ulam_registry_visit(&ulam_stats_registry, ulam_stats_clear, NULL);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_stats_local
+ * ------------------------------------------------------------------------- */
+ulam_stats_counters *ulam_stats_local(void)
+{
+    return (ulam_stats_counters *) ulam_registry_local(&ulam_stats_registry);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_stats_trajectory
+ * ------------------------------------------------------------------------- */
+void ulam_stats_trajectory(uint64_t steps, uint64_t odd_steps)
+{
+    ulam_stats_counters *counters = ulam_stats_local();
+    uint64_t bucket = steps / ULAM_STATS_HIST_WIDTH;
+
+    if (bucket >= ULAM_STATS_HIST_BUCKETS)
+    {
+        bucket = ULAM_STATS_HIST_BUCKETS - 1;
+    }
+
+    ulam_stats_add(&counters->steps, steps);
+    ulam_stats_add(&counters->odd_steps, odd_steps);
+    ulam_stats_add(&counters->trajectories, 1);
+    ulam_stats_add(&counters->length_hist[bucket], 1);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_stats_sum
+ * ------------------------------------------------------------------------- */
+static void ulam_stats_sum(void *block, void *arg)
+{
+    const uint64_t *src = (const uint64_t *) block;
+    uint64_t *dst = (uint64_t *) arg;
+    size_t i;
+
+    for (i = 0; i < ULAM_STATS_FIELDS; i++)
+    {
+        dst[i] += __atomic_load_n(&src[i], __ATOMIC_RELAXED);
+    }
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_stats_clear
+ * ------------------------------------------------------------------------- */
+static void ulam_stats_clear(void *block, void *arg)
+{
+    uint64_t *counters = (uint64_t *) block;
+    size_t i;
+
+    (void) arg;
+    for (i = 0; i < ULAM_STATS_FIELDS; i++)
+    {
+        __atomic_store_n(&counters[i], 0, __ATOMIC_RELAXED);
+    }
+}
@@ -0,0 +1,139 @@
+/**
+ * @file
+ * Dieses Modul zählt, wo die Rechenzeit der ULAM-Berechnungen bleibt:
+ * Anzahl der Schritte (gerade und ungerade), Länge der Folgen als
+ * Histogramm, Treffer und Fehlschläge im Cache sowie Anzahl der durchsuchten
+ * Startzahlen und vorzeitigen Abbrüche von ulam_twins() und
+ * ulam_multiples().
+ *
+ * Die Zählung wird nur beim Übersetzen mit -DULAM_STATS eingebaut, bspw.
+ * mit "make compile CFLAGS+=-DULAM_STATS". Ohne diesen Schalter werden die
+ * Makros zu leeren Anweisungen und ulam_stats_snapshot() liefert nur Nullen.
+ *
+ * Jeder Thread zählt in einem eigenen Zählerblock, der beim ersten Zugriff
+ * angelegt und in eine globale Liste eingetragen wird. ulam_stats_snapshot()
+ * summiert die Blöcke aller Threads, auch bereits beendeter.
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+#ifndef ULAM_STATS_H
+#define ULAM_STATS_H
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <stdint.h>
+
+
+/* ============================================================================
+ * Symbolische Konstanten
+ * ========================================================================= */
+
+/** Anzahl der Klassen im Histogramm der Folgenlängen */
+#define ULAM_STATS_HIST_BUCKETS 64
+
+/** Breite einer Klasse im Histogramm (Anzahl Schritte); die letzte Klasse
+ *  enthält alle längeren Folgen */
+#define ULAM_STATS_HIST_WIDTH 16
+
+
+/* ============================================================================
+ * Typdefinitionen
+ * ========================================================================= */
+
+/**
+ * Zählerstände der Instrumentierung.
+ */
+typedef struct
+{
+    uint64_t steps;             /**< berechnete Schritte insgesamt */
+    uint64_t odd_steps;         /**< davon ungerade Schritte (3 * an + 1) */
+    uint64_t trajectories;      /**< vollständig berechnete Folgen */
+    uint64_t length_hist[ULAM_STATS_HIST_BUCKETS]; /**< Folgenlängen */
+    uint64_t cache_hits;        /**< Folgen, die im Cache abgekürzt wurden */
+    uint64_t cache_misses;      /**< Folgen, die ohne Treffer endeten */
+    uint64_t searches;          /**< Aufrufe von ulam_twins/ulam_multiples */
+    uint64_t search_seeds;      /**< dabei berechnete Startzahlen */
+    uint64_t search_early_exits; /**< Suchen, die vor a0 = 0 endeten */
+} ulam_stats_counters;
+
+
+/* ============================================================================
+ * Makros
+ * ========================================================================= */
+
+#ifdef ULAM_STATS
+
+/** Erhöht einen Zähler des aktuellen Threads */
+#define ULAM_STATS_ADD(field, n) \
+    ulam_stats_add(&ulam_stats_local()->field, (uint64_t) (n))
+
+/** Vermerkt eine vollständig berechnete Folge */
+#define ULAM_STATS_TRAJECTORY(steps, odd_steps) \
+    ulam_stats_trajectory((uint64_t) (steps), (uint64_t) (odd_steps))
+
+#else
+
+#define ULAM_STATS_ADD(field, n) ((void) 0)
+#define ULAM_STATS_TRAJECTORY(steps, odd_steps) ((void) 0)
+
+#endif
+
+
+/* ============================================================================
+ * Funktions-Prototypen
+ * ========================================================================= */
+
+/**
+ * Liefert, ob die Instrumentierung eingebaut ist.
+ *
+ * @return          1, wenn mit ULAM_STATS übersetzt wurde, sonst 0
+ */
+int ulam_stats_enabled(void);
+
+/**
+ * Summiert die Zähler aller Threads.
+ *
+ * @param snapshot  Ziel für die summierten Zählerstände
+ */
+void ulam_stats_snapshot(ulam_stats_counters *snapshot);
+
+/**
+ * Setzt die Zähler aller Threads zurück. Zählungen, die gleichzeitig in
+ * anderen Threads laufen, können dabei teilweise verloren gehen.
+ */
+void ulam_stats_reset(void);
+
+/**
+ * Liefert den Zählerblock des aufrufenden Threads und legt ihn beim ersten
+ * Aufruf an.
+ *
+ * @return          der Zählerblock des Threads
+ */
+ulam_stats_counters *ulam_stats_local(void);
+
+/**
+ * Vermerkt eine vollständig berechnete Folge im Zählerblock des Threads.
+ *
+ * @param steps     Anzahl der Schritte der Folge
+ * @param odd_steps davon ungerade Schritte
+ */
+void ulam_stats_trajectory(uint64_t steps, uint64_t odd_steps);
+
+/**
+ * Erhöht einen Zähler. Nur der besitzende Thread schreibt, daher genügt ein
+ * atomares Speichern ohne Sperre, damit ulam_stats_snapshot() gleichzeitig
+ * lesen darf.
+ *
+ * @param counter   Zähler im Block des aktuellen Threads
+ * @param n         Betrag, um den erhöht wird
+ */
+static inline void ulam_stats_add(uint64_t *counter, uint64_t n)
+{
+    __atomic_store_n(counter, *counter + n, __ATOMIC_RELAXED);
+}
+
+#endif /* ULAM_STATS_H */
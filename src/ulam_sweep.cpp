@@ -0,0 +1,347 @@
+/**
+ * @file
+ * Programm zur verteilten Suche nach Gruppen gleicher maximaler ULAM-Werte
+ * (siehe ulam_shard.h) und zur Ausgabe der Ergebnisse je Startzahl im
+ * Spaltenformat (siehe ulam_column.h).
+ *
+ * Aufruf: ulam_sweep run [-s shards] [-w prozesse] präfix lo hi
+ *         ulam_sweep shard präfix nummer lo hi
+ *         ulam_sweep merge [-n anzahl] präfix shards
+ *         ulam_sweep query präfix shards limit anzahl
+ *         ulam_sweep dump datei lo hi
+ *         ulam_sweep cat [-n maximum] datei
+ *
+ * <ul>
+ *   <li> run    berechnet [lo, hi] in mehreren Prozessen und schreibt die
+ *               Shards präfix.0000 bis präfix.(shards - 1)
+ *   <li> shard  berechnet einen einzelnen Shard im eigenen Prozess, z.B.
+ *               auf einem anderen Rechner
+ *   <li> merge  gibt alle Gruppen mit mindestens anzahl Gliedern als Zeilen
+ *               "start länge maximum" aus
+ *   <li> query  baut den Lauf-Index aus den Shards auf und gibt
+ *               ulam_multiples(limit, anzahl) aus
+ *   <li> dump   schreibt Startzahl, Maximum und Schritte bis 1 für [lo, hi]
+ *               in eine Datei im Spaltenformat
+ *   <li> cat    gibt die Zeilen einer solchen Datei als Text
+ *               "startzahl maximum schritte" aus, mit -n nur die Zeilen mit
+ *               einem Maximum von mindestens maximum; Blöcke ohne solche
+ *               Zeilen werden nicht dekodiert
+ * </ul>
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "ulam_column.h"
+#include "ulam_runs.h"
+#include "ulam_shard.h"
+
+
+/* ============================================================================
+ * Symbolische Konstanten
+ * ========================================================================= */
+
+/** Voreingestellte Anzahl der Shards je Prozess */
+#define ULAM_SWEEP_SHARDS_PER_WORKER 4
+
+/** Maximale Länge eines Shard-Pfads */
+#define ULAM_SWEEP_PATH 4096
+
+
+/* ============================================================================
+ * Prototypen der privaten Funktionen
+ * ========================================================================= */
+
+/**
+ * Gibt eine Gruppe als Zeile aus (Callback für ulam_shard_merge()).
+ */
+static int ulam_sweep_print(int start, int len, int peak, void *arg);
+
+/**
+ * Bildet die Pfade der Shards 0 bis count - 1.
+ *
+ * @param prefix    Präfix der Shard-Dateien
+ * @param count     Anzahl der Shards
+ * @return          Feld der Pfade (mit free() freizugeben) oder NULL
+ */
+static const char **ulam_sweep_paths(const char *prefix, int count);
+
+/**
+ * Gibt die Zeilen einer Datei im Spaltenformat aus, deren Maximum
+ * mindestens min_peak ist.
+ *
+ * @param path      Pfad der Datei
+ * @param min_peak  kleinstes ausgegebenes Maximum
+ * @return          EXIT_SUCCESS oder EXIT_FAILURE
+ */
+static int ulam_sweep_cat(const char *path, int min_peak);
+
+/**
+ * Gibt den Aufruf des Programms aus.
+ */
+static int ulam_sweep_usage(const char *name);
+
+
+/* ============================================================================
+ * Funktionsdefinitionen
+ * ========================================================================= */
+
+/* ----------------------------------------------------------------------------
+ * Funktion: main
+ * ------------------------------------------------------------------------- */
+int main(int argc, char **argv)
+{
+    const char **paths;
+    const char *args[4];
+    char path[ULAM_SWEEP_PATH];
+    long groups;
+    long cpus;
+    int workers = 0;
+    int shards = 0;
+    int number = 2;
+    int min_peak = -1;
+    int nargs = 0;
+    int i;
+
+    if (argc < 2)
+    {
+        return ulam_sweep_usage(argv[0]);
+    }
+
+    for (i = 2; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-w") == 0 && i + 1 < argc)
+        {
+            workers = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+        {
+            shards = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+        {
+            number = atoi(argv[++i]);
+            min_peak = number;
+        }
+        else if (argv[i][0] != '-' && nargs < 4)
+        {
+            args[nargs++] = argv[i];
+        }
+        else
+        {
+            return ulam_sweep_usage(argv[0]);
+        }
+    }
+
+    if (strcmp(argv[1], "run") == 0 && nargs == 3)
+    {
+        if (workers < 1)
+        {
+            cpus = sysconf(_SC_NPROCESSORS_ONLN);
+            workers = (cpus > 0) ? (int) cpus : 1;
+        }
+        if (shards < 1)
+        {
+            shards = workers * ULAM_SWEEP_SHARDS_PER_WORKER;
+        }
+        if (ulam_shard_sweep(args[0], atoi(args[1]), atoi(args[2]), shards,
+                             workers) != 0)
+        {
+            fprintf(stderr, "Shards von %s konnten nicht berechnet werden\n",
+                    args[0]);
+            return EXIT_FAILURE;
+        }
+        fprintf(stderr, "%d Shards mit %d Prozessen geschrieben\n", shards,
+                workers);
+        return EXIT_SUCCESS;
+    }
+
+    if (strcmp(argv[1], "shard") == 0 && nargs == 4)
+    {
+        if (ulam_shard_path(path, sizeof(path), args[0], atoi(args[1])) != 0
+            || ulam_shard_run(path, atoi(args[2]), atoi(args[3])) != 0)
+        {
+            fprintf(stderr, "Shard %s kann nicht berechnet werden\n", path);
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    if ((strcmp(argv[1], "merge") == 0 && nargs == 2)
+        || (strcmp(argv[1], "query") == 0 && nargs == 4))
+    {
+        paths = ulam_sweep_paths(args[0], atoi(args[1]));
+        if (paths == NULL)
+        {
+            return ulam_sweep_usage(argv[0]);
+        }
+
+        if (argv[1][0] == 'm')
+        {
+            groups = ulam_shard_merge(paths, atoi(args[1]), number, 
+                                      ulam_sweep_print, NULL);
+        }
+        else
+        {
+            groups = ulam_runs_build_shards(paths, atoi(args[1]));
+            if (groups == 0)
+            {
+                printf("%d\n", ulam_runs_multiples(atoi(args[2]), 
+                                                   atoi(args[3])));
+            }
+        }
+        free(paths);
+
+        if (groups < 0)
+        {
+            fprintf(stderr, "Shards von %s fehlen oder sind ungueltig\n",
+                    args[0]);
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    if (strcmp(argv[1], "dump") == 0 && nargs == 3)
+    {
+        if (ulam_column_write_range(args[0], atoi(args[1]), 
+                                    atoi(args[2])) != 0)
+        {
+            fprintf(stderr, "%s kann nicht geschrieben werden\n", args[0]);
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    if (strcmp(argv[1], "cat") == 0 && nargs == 1)
+    {
+        return ulam_sweep_cat(args[0], min_peak);
+    }
+
+    return ulam_sweep_usage(argv[0]);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_sweep_cat
+ * ------------------------------------------------------------------------- */
+static int ulam_sweep_cat(const char *path, int min_peak)
+{
+    static int seeds[ULAM_COLUMN_BLOCK_ROWS];
+    static int peaks[ULAM_COLUMN_BLOCK_ROWS];
+    static int steps[ULAM_COLUMN_BLOCK_ROWS];
+    ulam_column_reader reader;
+    ulam_column_block block;
+    int status;
+    int rows;
+    int i;
+
+    if (ulam_column_read_open(&reader, path) != 0)
+    {
+        fprintf(stderr, "%s fehlt oder ist ungueltig\n", path);
+        return EXIT_FAILURE;
+    }
+
+    while ((status = ulam_column_read_next(&reader, &block)) == 1)
+    {
+        if (block.peak_max < min_peak)
+        {
+            continue;
+        }
+
+        rows = ulam_column_read_decode(&reader, seeds, peaks, steps);
+        if (rows < 0)
+        {
+            break;
+        }
+        for (i = 0; i < rows; i++)
+        {
+            if (peaks[i] >= min_peak)
+            {
+                printf("%d %d %d\n", seeds[i], peaks[i], steps[i]);
+            }
+        }
+    }
+    ulam_column_read_close(&reader);
+
+    if (status != 0)
+    {
+        fprintf(stderr, "%s ist beschaedigt oder unvollstaendig\n", path);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_sweep_print
+ * ------------------------------------------------------------------------- */
+static int ulam_sweep_print(int start, int len, int peak, void *arg)
+{
+    (void) arg;
+
+    printf("%d %d %d\n", start, len, peak);
+
+    return 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_sweep_paths
+ * ------------------------------------------------------------------------- */
+static const char **ulam_sweep_paths(const char *prefix, int count)
+{
+    const char **paths;
+    char *names;
+    int i;
+
+    if (count < 1)
+    {
+        return NULL;
+    }
+
+    /* Zeiger und Namen in einem Block, damit free() genügt */
+    paths = (const char **) malloc((size_t) count 
+                                   * (sizeof(char *) + ULAM_SWEEP_PATH));
+    if (paths == NULL)
+    {
+        return NULL;
+    }
+    names = (char *) (paths + count);
+
+    for (i = 0; i < count; i++)
+    {
+        if (ulam_shard_path(names + (size_t) i * ULAM_SWEEP_PATH, 
+                            ULAM_SWEEP_PATH, prefix, i) != 0)
+        {
+            free(paths);
+            return NULL;
+        }
+        paths[i] = names + (size_t) i * ULAM_SWEEP_PATH;
+    }
+
+    return paths;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_sweep_usage
+ * ------------------------------------------------------------------------- */
+static int ulam_sweep_usage(const char *name)
+{
+    fprintf(stderr, 
+            "Aufruf: %s run [-s shards] [-w prozesse] praefix lo hi\n"
+            "        %s shard praefix nummer lo hi\n"
+            "        %s merge [-n anzahl] praefix shards\n"
+            "        %s query praefix shards limit anzahl\n"
+            "        %s dump datei lo hi\n"
+            "        %s cat [-n maximum] datei\n",
+            name, name, name, name, name, name);
+
+    return EXIT_FAILURE;
+}
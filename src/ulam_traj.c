@@ -0,0 +1,118 @@
+/**
+ * @file
+ * Dieses Modul implementiert die Berechnung mehrerer Kennzahlen einer
+ * ULAM-Folge in einem Durchlauf (siehe ulam_traj.h).
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <stdlib.h>
+
+#include "ulam.h"
+#include "ulam_sched.h"
+#include "ulam_traj.h"
+
+
+/* ============================================================================
+ * Symbolische Konstanten
+ * ========================================================================= */
+
+/** Körnung der parallelen Bereichsberechnung */
+#define ULAM_TRAJ_GRAIN 4096
+
+
+/* ============================================================================
+ * Typdefinitionen
+ * ========================================================================= */
+
+/** Kernel für eine feste Maske */
+typedef ulam_status (*ulam_traj_fn)(int a0, ulam_traj_stats *stats);
+
+/**
+ * Auftrag für ulam_traj_range().
+ */
+typedef struct
+{
+    int lo;                 /**< kleinste Startzahl */
+    ulam_traj_fn kernel;    /**< Kernel für die Maske */
+    ulam_traj_stats *out;   /**< Ziel */
+} ulam_traj_job;
+
+
+/* ============================================================================
+ * Globale Variablen
+ * ========================================================================= */
+
+/** Kernel je Maske, vom Compiler für alle 16 Masken erzeugt */
+static const ulam_traj_fn ulam_traj_kernels[ULAM_TRAJ_ALL + 1] =
+{
+    ulam_traj_kernel<0>,  ulam_traj_kernel<1>,  ulam_traj_kernel<2>,
+    ulam_traj_kernel<3>,  ulam_traj_kernel<4>,  ulam_traj_kernel<5>,
+    ulam_traj_kernel<6>,  ulam_traj_kernel<7>,  ulam_traj_kernel<8>,
+    ulam_traj_kernel<9>,  ulam_traj_kernel<10>, ulam_traj_kernel<11>,
+    ulam_traj_kernel<12>, ulam_traj_kernel<13>, ulam_traj_kernel<14>,
+    ulam_traj_kernel<15>
+};
+
+
+/* ============================================================================
+ * Prototypen der privaten Funktionen
+ * ========================================================================= */
+
+/**
+ * Aufgabe für ulam_sched_parallel_for(): berechnet die Kennzahlen der
+ * Startzahlen lo bis hi.
+ */
+static void ulam_traj_task(int lo, int hi, void *arg);
+
+
+/* ============================================================================
+ * Funktionsdefinitionen
+ * ========================================================================= */
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_traj
+ * ------------------------------------------------------------------------- */
+ulam_status ulam_traj(int a0, unsigned int flags, ulam_traj_stats *stats)
+{
+    return ulam_traj_kernels[flags & ULAM_TRAJ_ALL](a0, stats);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_traj_range
+ * ------------------------------------------------------------------------- */
+int ulam_traj_range(int lo, int hi, unsigned int flags, ulam_traj_stats out[])
+{
+    ulam_traj_job job;
+
+    if (lo > hi || out == NULL)
+    {
+        return -1;
+    }
+
+    job.lo = lo;
+    job.kernel = ulam_traj_kernels[flags & ULAM_TRAJ_ALL];
+    job.out = out;
+
+    return ulam_sched_parallel_for(lo, hi, ULAM_TRAJ_GRAIN, ulam_traj_task,
+                                   &job);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_traj_task
+ * ------------------------------------------------------------------------- */
+static void ulam_traj_task(int lo, int hi, void *arg)
+{
+    ulam_traj_job *job = (ulam_traj_job *) arg;
+    long long a0;       /* long long, damit hi = INT_MAX nicht überläuft */
+
+    for (a0 = lo; a0 <= hi; a0++)
+    {
+        job->kernel((int) a0, &job->out[a0 - job->lo]);
+    }
+}
@@ -0,0 +1,192 @@
+/**
+ * @file
+ * Dieses Modul berechnet mehrere Kennzahlen einer ULAM-Folge in einem
+ * einzigen Durchlauf:
+ *
+ * <ul>
+ *   <li> das Maximum der Folge wie ulam_max(),
+ *   <li> die Anzahl der Schritte bis 1 (Stoppzeit),
+ *   <li> die Anzahl der Schritte, bis die Folge erstmals unter a0 fällt
+ *        (Gleitzeit),
+ *   <li> den Schritt, in dem das Maximum erstmals erreicht wird.
+ * </ul>
+ *
+ * Welche Kennzahlen berechnet werden, legt eine Bitmaske fest. Der Kernel
+ * ulam_traj_kernel<FLAGS>() erhält die Maske als Template-Argument, so dass
+ * der Compiler den Code für nicht angeforderte Kennzahlen entfernt; wird nur
+ * die Gleitzeit angefordert, endet die Berechnung, sobald sie feststeht.
+ * ulam_traj() und ulam_traj_range() wählen die passende Instanz zur Laufzeit.
+ *
+ * Bei einem Überlauf endet die Folge wie bei ulam_max(): Maximum und
+ * Maximumschritt beziehen sich auf den berechneten Teil, Stoppzeit und eine
+ * noch nicht erreichte Gleitzeit sind -1.
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+#ifndef ULAM_TRAJ_H
+#define ULAM_TRAJ_H
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include "ulam.h"
+#include "ulam_overflow.h"
+
+
+/* ============================================================================
+ * Symbolische Konstanten
+ * ========================================================================= */
+
+/** Maximum der Folge */
+#define ULAM_TRAJ_PEAK          0x1u
+
+/** Anzahl der Schritte bis 1 */
+#define ULAM_TRAJ_STOPPING_TIME 0x2u
+
+/** Anzahl der Schritte, bis die Folge erstmals unter a0 fällt */
+#define ULAM_TRAJ_GLIDE         0x4u
+
+/** Schritt, in dem das Maximum erstmals erreicht wird */
+#define ULAM_TRAJ_PEAK_STEP     0x8u
+
+/** alle Kennzahlen */
+#define ULAM_TRAJ_ALL           0xfu
+
+
+/* ============================================================================
+ * Typdefinitionen
+ * ========================================================================= */
+
+/**
+ * Kennzahlen einer ULAM-Folge. Nicht angeforderte Kennzahlen sind -1.
+ */
+typedef struct
+{
+    int peak;           /**< Maximum der Folge */
+    int stopping_time;  /**< Schritte bis 1 */
+    int glide;          /**< Schritte bis unter a0, 0 für a0 = 1 */
+    int peak_step;      /**< Schritt des Maximums, 0 wenn a0 das Maximum ist */
+} ulam_traj_stats;
+
+
+/* ============================================================================
+ * Funktions-Prototypen
+ * ========================================================================= */
+
+/**
+ * Berechnet die in flags angeforderten Kennzahlen der Folge zu a0.
+ *
+ * @param a0        Startzahl
+ * @param flags     Oder-Verknüpfung von ULAM_TRAJ_...
+ * @param stats     Ziel für die Kennzahlen
+ * @return          #ULAM_OK, #ULAM_INVALID für a0 < 1 oder #ULAM_OVERFLOW
+ */
+ulam_status ulam_traj(int a0, unsigned int flags, ulam_traj_stats *stats);
+
+/**
+ * Berechnet die in flags angeforderten Kennzahlen für alle Startzahlen von
+ * lo bis einschließlich hi parallel (siehe ulam_sched.h) und legt sie in
+ * out[a0 - lo] ab.
+ *
+ * @param lo        kleinste Startzahl
+ * @param hi        größte Startzahl
+ * @param flags     Oder-Verknüpfung von ULAM_TRAJ_...
+ * @param out       Feld mit mindestens hi - lo + 1 Einträgen
+ * @return          0 bei Erfolg, -1 wenn lo > hi oder out NULL ist
+ */
+int ulam_traj_range(int lo, int hi, unsigned int flags, ulam_traj_stats out[]);
+
+
+/* ============================================================================
+ * Funktionsdefinitionen
+ * ========================================================================= */
+
+/**
+ * Kernel von ulam_traj() für eine beim Übersetzen bekannte Maske.
+ *
+ * @tparam FLAGS    Oder-Verknüpfung von ULAM_TRAJ_...
+ * @param a0        Startzahl
+ * @param stats     Ziel für die Kennzahlen
+ * @return          #ULAM_OK, #ULAM_INVALID für a0 < 1 oder #ULAM_OVERFLOW
+ */
+template <unsigned int FLAGS>
+inline ulam_status ulam_traj_kernel(int a0, ulam_traj_stats *stats)
+{
+    const bool need_peak = (FLAGS & (ULAM_TRAJ_PEAK | ULAM_TRAJ_PEAK_STEP));
+    const bool need_glide = (FLAGS & ULAM_TRAJ_GLIDE);
+    const bool glide_only = (FLAGS == ULAM_TRAJ_GLIDE);
+    ulam_status status = ULAM_OK;
+    int an = a0;        /* aktuelles Folgenglied */
+    int steps = 0;      /* bisherige Schritte */
+    int peak = a0;
+    int peak_step = 0;
+    int glide = (a0 == 1) ? 0 : -1;
+
+    stats->peak = -1;
+    stats->stopping_time = -1;
+    stats->glide = -1;
+    stats->peak_step = -1;
+
+    if (a0 < 1)
+    {
+        return ULAM_INVALID;
+    }
+
+    while (an > 1)
+    {
+        if (an % 2 == 0)
+        {
+            an = an / 2;
+        }
+        else
+        {
+            if (an >= ULAM_MAX)
+            {
+                /* Überlauf: die Folge endet wie bei ulam_max() */
+                ulam_overflow_record(a0, an);
+                status = ULAM_OVERFLOW;
+                break;
+            }
+            an = 3 * an + 1;
+        }
+        steps++;
+
+        if (need_peak && an > peak)
+        {
+            peak = an;
+            peak_step = steps;
+        }
+        if (need_glide && glide < 0 && an < a0)
+        {
+            glide = steps;
+            if (glide_only)
+            {
+                break;
+            }
+        }
+    }
+
+    if (FLAGS & ULAM_TRAJ_PEAK)
+    {
+        stats->peak = peak;
+    }
+    if (FLAGS & ULAM_TRAJ_PEAK_STEP)
+    {
+        stats->peak_step = peak_step;
+    }
+    if (FLAGS & ULAM_TRAJ_GLIDE)
+    {
+        stats->glide = glide;
+    }
+    if ((FLAGS & ULAM_TRAJ_STOPPING_TIME) && status == ULAM_OK)
+    {
+        stats->stopping_time = steps;
+    }
+
+    return status;
+}
+
+#endif /* ULAM_TRAJ_H */
@@ -0,0 +1,308 @@
+/**
+ * @file
+ * Dieses Modul implementiert die ULAM-Berechnungen mit 64 und 128 Bit
+ * breiten Zahlen (siehe ulam_wide.h).
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <stdint.h>
+
+#include "ulam_wide.h"
+
+
+/* ============================================================================
+ * Prototypen der privaten Funktionen
+ * ========================================================================= */
+
+/**
+ * Setzt eine ULAM-Folge ab dem Folgenglied an mit 128 Bit fort und liefert
+ * ihr Maximum.
+ *
+ * @param an        aktuelles Folgenglied (>= 1)
+ * @param max_value bisheriges Maximum der Folge
+ * @return          das Maximum der gesamten Folge oder 0 bei Überlauf
+ */
+static ulam_u128 ulam_wide_finish128(ulam_u128 an, ulam_u128 max_value);
+
+
+/* ============================================================================
+ * Funktionsdefinitionen
+ * ========================================================================= */
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam64
+ * ------------------------------------------------------------------------- */
+uint64_t ulam64(uint64_t an)
+{
+    uint64_t ulam_an;
+
+    if (an < 1)
+    {
+        return 0;
+    }
+
+    if (an % 2 == 0)
+    {
+        return an / 2;
+    }
+
+    /* Nur der ungerade Schritt kann überlaufen */
+    if (__builtin_mul_overflow(an, (uint64_t) 3, &ulam_an)
+        || __builtin_add_overflow(ulam_an, (uint64_t) 1, &ulam_an))
+    {
+        return 0;
+    }
+
+    return ulam_an;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam128
+ * ------------------------------------------------------------------------- */
+ulam_u128 ulam128(ulam_u128 an)
+{
+    ulam_u128 ulam_an;
+
+    if (an < 1)
+    {
+        return 0;
+    }
+
+    if (an % 2 == 0)
+    {
+        return an / 2;
+    }
+
+    /* Nur der ungerade Schritt kann überlaufen */
+    if (__builtin_mul_overflow(an, (ulam_u128) 3, &ulam_an)
+        || __builtin_add_overflow(ulam_an, (ulam_u128) 1, &ulam_an))
+    {
+        return 0;
+    }
+
+    return ulam_an;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_max64
+ * ------------------------------------------------------------------------- */
+uint64_t ulam_max64(uint64_t a0)
+{
+    ulam_u128 max_value = ulam_max_wide(a0);
+
+    if (max_value > UINT64_MAX)
+    {
+        return 0;
+    }
+
+    return (uint64_t) max_value;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_max128
+ * ------------------------------------------------------------------------- */
+ulam_u128 ulam_max128(ulam_u128 a0)
+{
+    if (a0 < 1)
+    {
+        return 0;
+    }
+
+    return ulam_wide_finish128(a0, a0);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_max_wide
+ * ------------------------------------------------------------------------- */
+ulam_u128 ulam_max_wide(uint64_t a0)
+{
+    uint64_t an;        /* Zahl, deren ULAM-Wert berechnet wird */
+    uint64_t ulam_an;   /* ULAM-Wert zu an */
+    uint64_t max_value; /* max. ULAM-Wert in der Folge von a0 bis an */
+
+    if (a0 < 1)
+    {
+        return 0;
+    }
+
+    an = a0;
+    max_value = a0;
+
+    while (an > 1)
+    {
+        if (an % 2 == 0)
+        {
+            /* Gerade Schritte verkleinern die Zahl und ändern das Maximum
+             * nicht */
+            an = an / 2;
+            continue;
+        }
+
+        if (__builtin_mul_overflow(an, (uint64_t) 3, &ulam_an)
+            || __builtin_add_overflow(ulam_an, (uint64_t) 1, &ulam_an))
+        {
+            /* 64 Bit reichen nicht mehr: mit 128 Bit fortsetzen */
+            return ulam_wide_finish128(an, max_value);
+        }
+
+        an = ulam_an;
+        if (an > max_value)
+        {
+            max_value = an;
+        }
+    }
+
+    return max_value;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_twins64
+ * ------------------------------------------------------------------------- */
+int64_t ulam_twins64(int64_t limit)
+{
+    /* Zwillinge sind Mehrlinge mit der Anzahl 2 */
+    if (limit < 1)
+    {
+        return -1;
+    }
+
+    return ulam_multiples64(limit, 2);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_multiples64
+ * ------------------------------------------------------------------------- */
+int64_t ulam_multiples64(int64_t limit, int64_t number)
+{
+    ulam_u128 ulam_max_1;   /* ULAM-Max-Werte von zwei benachbarten Zahlen */
+    ulam_u128 ulam_max_2;
+    int64_t count;          /* Anzahl der bereits gefundenen Mehrlinge */
+    int64_t multiples_index;
+    int64_t a0;
+
+    if (number < 2 || limit < number)
+    {
+        return -1;
+    }
+
+    /* Suche von limit abwärts wie bei ulam_multiples() */
+    multiples_index = -1;
+    ulam_max_1 = ulam_max_wide((uint64_t) limit);
+    count = 1;
+
+    for (a0 = limit - 1; a0 >= 0 && multiples_index == -1; a0--)
+    {
+        ulam_max_2 = ulam_max_wide((uint64_t) a0);
+        if (ulam_max_1 == ulam_max_2)
+        {
+            count += 1;
+        }
+        else
+        {
+            ulam_max_1 = ulam_max_2;
+            count = 1;
+        }
+
+        if (count == number)
+        {
+            multiples_index = a0;
+        }
+    }
+
+    return multiples_index;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_twins128
+ * ------------------------------------------------------------------------- */
+ulam_i128 ulam_twins128(ulam_i128 limit)
+{
+    /* Zwillinge sind Mehrlinge mit der Anzahl 2 */
+    if (limit < 1)
+    {
+        return -1;
+    }
+
+    return ulam_multiples128(limit, 2);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_multiples128
+ * ------------------------------------------------------------------------- */
+ulam_i128 ulam_multiples128(ulam_i128 limit, int64_t number)
+{
+    ulam_u128 ulam_max_1;   /* ULAM-Max-Werte von zwei benachbarten Zahlen */
+    ulam_u128 ulam_max_2;
+    int64_t count;          /* Anzahl der bereits gefundenen Mehrlinge */
+    ulam_i128 multiples_index;
+    ulam_i128 a0;
+
+    if (number < 2 || limit < number)
+    {
+        return -1;
+    }
+
+    /* Suche von limit abwärts wie bei ulam_multiples() */
+    multiples_index = -1;
+    ulam_max_1 = ulam_max128((ulam_u128) limit);
+    count = 1;
+
+    for (a0 = limit - 1; a0 >= 0 && multiples_index == -1; a0--)
+    {
+        ulam_max_2 = ulam_max128((ulam_u128) a0);
+        if (ulam_max_1 == ulam_max_2)
+        {
+            count += 1;
+        }
+        else
+        {
+            ulam_max_1 = ulam_max_2;
+            count = 1;
+        }
+
+        if (count == number)
+        {
+            multiples_index = a0;
+        }
+    }
+
+    return multiples_index;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ulam_wide_finish128
+ * ------------------------------------------------------------------------- */
+static ulam_u128 ulam_wide_finish128(ulam_u128 an, ulam_u128 max_value)
+{
+    ulam_u128 ulam_an;
+
+    while (an > 1)
+    {
+        if (an % 2 == 0)
+        {
+            an = an / 2;
+            continue;
+        }
+
+        if (__builtin_mul_overflow(an, (ulam_u128) 3, &ulam_an)
+            || __builtin_add_overflow(ulam_an, (ulam_u128) 1, &ulam_an))
+        {
+            /* Auch 128 Bit reichen nicht */
+            return 0;
+        }
+
+        an = ulam_an;
+        if (an > max_value)
+        {
+            max_value = an;
+        }
+    }
+
+    return max_value;
+}
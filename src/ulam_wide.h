@@ -0,0 +1,143 @@
+/**
+ * @file
+ * Dieses Modul implementiert die ULAM-Berechnungen mit 64 und 128 Bit
+ * breiten Zahlen. Damit entfällt die Grenze #ULAM_MAX der int-Funktionen:
+ * Überläufe können nur noch im ungeraden Schritt 3 * an + 1 auftreten und
+ * werden dort mit __builtin_mul_overflow() bzw. __builtin_add_overflow()
+ * geprüft. Läuft eine 64-Bit-Folge über, wird sie mit 128 Bit fortgesetzt.
+ *
+ * Da 0 niemals Glied einer ULAM-Folge ist, liefern die Funktionen für
+ * Folgenglieder und Maxima den Wert 0, wenn kein Ergebnis existiert.
+ *
+ * @author  Ulrike Griefahn
+ * @date    2014-10-05
+ */
+
+#ifndef ULAM_WIDE_H
+#define ULAM_WIDE_H
+
+/* ============================================================================
+ * Header-Dateien
+ * ========================================================================= */
+
+#include <stdint.h>
+
+
+/* ============================================================================
+ * Typdefinitionen
+ * ========================================================================= */
+
+/** vorzeichenlose 128-Bit-Zahl für Folgenglieder und Maxima */
+typedef unsigned __int128 ulam_u128;
+
+/** vorzeichenbehaftete 128-Bit-Zahl für Indizes mit -1 als Fehlerwert */
+typedef __int128 ulam_i128;
+
+
+/* ============================================================================
+ * Funktions-Prototypen
+ * ========================================================================= */
+
+/**
+ * Liefert den nächsten ULAM-Wert zu einer positiven 64-Bit-Zahl.
+ *
+ * @param an        positive Zahl, zu der der nächste ULAM-Wert geliefert
+ *                  werden soll
+ * @return          der nächste ULAM-Wert oder 0, wenn an = 0 ist oder
+ *                  3 * an + 1 nicht mit 64 Bit darstellbar ist
+ */
+uint64_t ulam64(uint64_t an);
+
+/**
+ * Liefert den nächsten ULAM-Wert zu einer positiven 128-Bit-Zahl.
+ *
+ * @param an        positive Zahl, zu der der nächste ULAM-Wert geliefert
+ *                  werden soll
+ * @return          der nächste ULAM-Wert oder 0, wenn an = 0 ist oder
+ *                  3 * an + 1 nicht mit 128 Bit darstellbar ist
+ */
+ulam_u128 ulam128(ulam_u128 an);
+
+/**
+ * Liefert den maximalen Wert der ULAM-Folge zu a0, wenn er mit 64 Bit
+ * darstellbar ist.
+ *
+ * @param a0        positive Zahl, zu der der maximale ULAM-Wert geliefert
+ *                  werden soll
+ * @return          der maximale ULAM-Wert oder 0, wenn a0 = 0 ist oder das
+ *                  Maximum nicht mit 64 Bit darstellbar ist
+ */
+uint64_t ulam_max64(uint64_t a0);
+
+/**
+ * Liefert den maximalen Wert der ULAM-Folge zu a0 mit 128 Bit.
+ *
+ * @param a0        positive Zahl, zu der der maximale ULAM-Wert geliefert
+ *                  werden soll
+ * @return          der maximale ULAM-Wert oder 0, wenn a0 = 0 ist oder es
+ *                  auch mit 128 Bit zu einem Überlauf kommen würde
+ */
+ulam_u128 ulam_max128(ulam_u128 a0);
+
+/**
+ * Liefert den maximalen Wert der ULAM-Folge zu a0. Die Folge wird mit 64 Bit
+ * berechnet und erst dann mit 128 Bit fortgesetzt, wenn ein ungerader
+ * Schritt mit 64 Bit überlaufen würde.
+ *
+ * @param a0        positive Zahl, zu der der maximale ULAM-Wert geliefert
+ *                  werden soll
+ * @return          der maximale ULAM-Wert oder 0, wenn a0 = 0 ist oder es
+ *                  auch mit 128 Bit zu einem Überlauf kommen würde
+ */
+ulam_u128 ulam_max_wide(uint64_t a0);
+
+/**
+ * Variante von ulam_twins() für 64-Bit-Intervalle. Die Maxima werden mit
+ * ulam_max_wide() berechnet, es gehen also keine Startzahlen durch Überlauf
+ * verloren.
+ *
+ * @param limit     ganze Zahl, bis zu der nach ULAM-Zwillingen
+ *                  gesucht werden soll.
+ * @return          die kleinere Zahl des letzten ULAM-Zwillingspaars
+ *                  oder -1, wenn es kein solches Paar gibt oder limit < 1 ist
+ */
+int64_t ulam_twins64(int64_t limit);
+
+/**
+ * Variante von ulam_multiples() für 64-Bit-Intervalle. Die Maxima werden mit
+ * ulam_max_wide() berechnet.
+ *
+ * @param limit     positive ganze Zahl, bis zu der nach ULAM-Mehrlingen
+ *                  gesucht werden soll.
+ * @param number    positive Zahl, die die Anzahl der gesuchten Mehrlinge angibt
+ * @return          die kleinste Zahl des letzten "ULAM-Mehrlings" oder -1, wenn
+ *                  keine Mehrlinge gefunden wurden, limit < number oder
+ *                  number < 2.
+ */
+int64_t ulam_multiples64(int64_t limit, int64_t number);
+
+/**
+ * Variante von ulam_twins() für 128-Bit-Intervalle. Die Maxima werden mit
+ * ulam_max128() berechnet.
+ *
+ * @param limit     ganze Zahl, bis zu der nach ULAM-Zwillingen
+ *                  gesucht werden soll.
+ * @return          die kleinere Zahl des letzten ULAM-Zwillingspaars
+ *                  oder -1, wenn es kein solches Paar gibt oder limit < 1 ist
+ */
+ulam_i128 ulam_twins128(ulam_i128 limit);
+
+/**
+ * Variante von ulam_multiples() für 128-Bit-Intervalle. Die Maxima werden
+ * mit ulam_max128() berechnet.
+ *
+ * @param limit     positive ganze Zahl, bis zu der nach ULAM-Mehrlingen
+ *                  gesucht werden soll.
+ * @param number    positive Zahl, die die Anzahl der gesuchten Mehrlinge angibt
+ * @return          die kleinste Zahl des letzten "ULAM-Mehrlings" oder -1, wenn
+ *                  keine Mehrlinge gefunden wurden, limit < number oder
+ *                  number < 2.
+ */
+ulam_i128 ulam_multiples128(ulam_i128 limit, int64_t number);
+
+#endif /* ULAM_WIDE_H */
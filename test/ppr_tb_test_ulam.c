@@ -15,6 +15,33 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
+
+#include "ulam.h"
+#include "ulam_cache.h"
+#include "ulam_range.h"
+#include "ulam_parallel.h"
+#include "ulam_sched.h"
+#include "ulam_wide.h"
+#include "ulam_jump.h"
+#include "ulam_sieve.h"
+#include "ulam_index.h"
+#include "ulam_runs.h"
+#include "ulam_groups.h"
+#include "ulam_overflow.h"
+#include "ulam_stats.h"
+#include "ulam_query.h"
+#include "ulam_lru.h"
+#include "ulam_constexpr.h"
+#include "ulam_map.h"
+#include "ulam_traj.h"
+#include "ulam_rmq.h"
+#include "ulam_records.h"
+#include "ulam_sparse.h"
+#include "ulam_scan.h"
+#include "ulam_shard.h"
+#include "ulam_column.h"
+#include "ulam_async.h"
 #ifdef TESTBENCH
 #include "ppr_tb_logging.h"
 #endif
@@ -278,64 +305,2151 @@ void ppr_tb_testUlam_multiples()
 }
 
 /* ----------------------------------------------------------------------------
- * Funktion: ppr_tb_assert_equal
+ * Funktion: ppr_tb_check_twins
  * ------------------------------------------------------------------------- */
-static void ppr_tb_assert_equal(char *testcase, char *function,
-                                int a0_bzw_limit, int number, 
-                                int expected, int result)
-{    
-    if (result == expected)
+static void ppr_tb_check_twins(int lo, int hi, void *arg)
+{
+    int *expected = (int *) arg;    /* expected[0] zaehlt Abweichungen */
+    int limit;
+
+    for (limit = lo; limit <= hi; limit++)
     {
-        ppr_tb_print_ok();
+        if (ulam_twins(limit) != expected[limit - 9999]
+            || ulam_multiples(limit, 3) != expected[limit - 9999 + 2000])
+        {
+            __atomic_add_fetch(&expected[0], 1, __ATOMIC_RELAXED);
+        }
     }
-    else
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ppr_tb_testUlam_cache
+ * ------------------------------------------------------------------------- */
+void ppr_tb_testUlam_cache()
+{
+    int a0;
+    int limit;
+    int number;
+    int expected;
+    int result;
+    int mismatches;
+    int uncached[1001];
+    static int searches[4001];
+    
+    char *msg = "testUlam_cache (test_ulam)";
+    
+    printf("========================================================\n");
+    printf("Ueberpruefe Testfaelle ( U L A M _ C A C H E ): ");
+    printf("\n========================================================\n");
+    printf("Testfall 11 ulam_max: "
+           "Werte mit und ohne Cache stimmen ueberein\n");
+    fflush(stdout);
+
+    ulam_cache_release();
+    for (a0 = 1; a0 <= 1000; a0++)
     {
-        printf("[ERROR]\n");
+        uncached[a0] = ulam_max(a0);
+    }
 
-        if (number >= -1)
+    ulam_cache_prepare(1000);
+    mismatches = 0;
+    for (a0 = 1000; a0 >= 1; a0--)
+    {
+        if (ulam_max(a0) != uncached[a0])
         {
-            printf("   Aufruf von %s(%d, %d)\n", 
-                   function, a0_bzw_limit, number);
+            mismatches++;
         }
-        else
+    }
+    ulam_cache_release();
+
+    /* Anzahl der Abweichungen = 0 */
+    expected = 0;
+    result = mismatches;
+    ppr_tb_assert_equal(msg, "ulam_max", 1000, -2, expected, result);
+
+    printf("Testfall 12 ulam_multiples: "
+           "Persistenter Cache liefert gleiche Ergebnisse\n");
+    fflush(stdout);
+
+    ulam_cache_set_persistent(1);
+
+    /* ulam_multiples(1000, 2) = 982 */
+    limit = 1000;
+    number = 2;
+    expected = 982;
+    result = ulam_multiples(limit, number);
+    ppr_tb_assert_equal(msg, "ulam_multiples", limit, number, 
+                        expected, result);
+
+    /* ulam_multiples(391, 6) = 386, Cache aus vorigem Aufruf */
+    limit = 391;
+    number = 6;
+    expected = 386;
+    result = ulam_multiples(limit, number);
+    ppr_tb_assert_equal(msg, "ulam_multiples", limit, number, 
+                        expected, result);
+
+    ulam_cache_set_persistent(0);
+    ulam_cache_release();
+
+    printf("Testfall 13 ulam_multiples: "
+           "Cache kleiner als das Suchintervall\n");
+    fflush(stdout);
+
+    ulam_cache_set_budget(64 * sizeof(int));
+
+    /* ulam_multiples(111, 4) = 108 */
+    limit = 111;
+    number = 4;
+    expected = 108;
+    result = ulam_multiples(limit, number);
+    ppr_tb_assert_equal(msg, "ulam_multiples", limit, number, 
+                        expected, result);
+
+    ulam_cache_set_budget(ULAM_CACHE_DEFAULT_BUDGET);
+
+    /* Jede Suche hat ihren eigenen Cache: gleichzeitige Aufrufe aus 4
+     * Threads liefern dieselben Ergebnisse wie nacheinander */
+    for (limit = 10000; limit < 12000; limit++)
+    {
+        searches[limit - 9999] = ulam_twins(limit);
+        searches[limit - 9999 + 2000] = ulam_multiples(limit, 3);
+    }
+    searches[0] = 0;
+    ulam_parallel_set_threads(4);
+    ulam_sched_parallel_for(10000, 11999, 16, ppr_tb_check_twins, searches);
+    ulam_parallel_set_threads(0);
+    expected = 0;
+    result = searches[0];
+    ppr_tb_assert_equal(msg, "ulam_twins", 11999, -2, expected, result);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ppr_tb_testUlam_max_range
+ * ------------------------------------------------------------------------- */
+void ppr_tb_testUlam_max_range()
+{
+    int isa;
+    int i;
+    int lo;
+    int hi;
+    int expected;
+    int result;
+    int mismatches;
+    int out[20005];
+    
+    char *msg = "testUlam_max_range (test_ulam)";
+    char *fct = "ulam_max_range";
+    
+    printf("========================================================\n");
+    printf("Ueberpruefe Testfaelle ( U L A M _ M A X _ R A N G E ): ");
+    printf("\n========================================================\n");
+    printf("Testfall 14 ulam_max_range: Ungueltiges Intervall\n");
+    fflush(stdout);
+
+    /* ulam_max_range(10, 9, out) = -1 */
+    lo = 10;
+    hi = 9;
+    expected = -1;
+    result = ulam_max_range(lo, hi, out);
+    ppr_tb_assert_equal(msg, fct, lo, hi, expected, result);
+
+    printf("Testfall 15 ulam_max_range: "
+           "Alle Kernel stimmen mit ulam_max ueberein\n");
+    fflush(stdout);
+
+    for (isa = ULAM_ISA_SCALAR; isa <= ULAM_ISA_AVX512; isa++)
+    {
+        mismatches = 0;
+        if (ulam_range_set_isa((ulam_isa) isa) == 0)
         {
-            printf("   Aufruf von %s(%d)\n", function, a0_bzw_limit);
+            /* kleine Startzahlen einschliesslich ungueltiger Werte */
+            lo = -3;
+            hi = 20000;
+            ulam_max_range(lo, hi, out);
+            for (i = lo; i <= hi; i++)
+            {
+                if (out[i - lo] != ulam_max(i))
+                {
+                    mismatches++;
+                }
+            }
+
+            /* Startzahlen im Bereich des Ueberlaufs */
+            lo = ULAM_MAX - 20;
+            hi = ULAM_MAX + 20;
+            ulam_max_range(lo, hi, out);
+            for (i = lo; i <= hi; i++)
+            {
+                if (out[i - lo] != ulam_max(i))
+                {
+                    mismatches++;
+                }
+            }
         }
-        printf("   expected:<[\n");
-        printf("   %d\n", expected);
-        printf("   ]> but was:<[\n");
-        printf("   %d", result);
-        printf("\n   ]>\n");
-        fflush(stdout);
 
-#ifndef TESTBENCH
-        printf("%%TEST_FAILED%% time=0 testname=%s "
-               "message=expected: %d, but was %d\n", 
-               testcase, expected, result);
-#endif
+        /* Anzahl der Abweichungen = 0 */
+        expected = 0;
+        result = mismatches;
+        ppr_tb_assert_equal(msg, fct, isa, -2, expected, result);
     }
 }
 
 /* ----------------------------------------------------------------------------
- * Funktion: main
+ * Funktion: ppr_tb_testUlam_parallel
  * ------------------------------------------------------------------------- */
-#ifndef TESTBENCH
-int main(void)
-{   
-    printf("%%SUITE_STARTING%% test_ulam\n");
-    printf("%%SUITE_STARTED%%\n");
+void ppr_tb_testUlam_parallel()
+{
+    int threads;
+    int limit;
+    int number;
+    int expected;
+    int result;
+    int mismatches;
+    
+    char *msg = "testUlam_parallel (test_ulam)";
+    
+    printf("========================================================\n");
+    printf("Ueberpruefe Testfaelle ( U L A M _ P A R A L L E L ): ");
+    printf("\n========================================================\n");
+    printf("Testfall 16 ulam_multiples_parallel: "
+           "Gueltige Werte fuer Parameter limit und number\n");
+    fflush(stdout);
 
-    printf("%%TEST_STARTED%%  testUlam_max (test_ulam)\n");
-    ppr_tb_testUlam_max();
-    printf("%%TEST_FINISHED%% time=0 testUlam_max (test_ulam)\n");
+    ulam_parallel_set_threads(4);
 
-    printf("%%TEST_STARTED%%  testUlam_twins (test_ulam)\n");
-    ppr_tb_testUlam_twins();
-    printf("%%TEST_FINISHED%% time=0 testUlam_twins (test_ulam)\n");
+    /* ulam_twins_parallel(5) = -1 */
+    limit = 5;
+    expected = -1;
+    result = ulam_twins_parallel(limit);
+    ppr_tb_assert_equal(msg, "ulam_twins_parallel", limit, -2, 
+                        expected, result);
 
-    printf("%%TEST_STARTED%%  testUlam_multiples (test_ulam)\n");
-    ppr_tb_testUlam_multiples();
-    printf("%%TEST_FINISHED%% time=0 testUlam_multiples (test_ulam)\n");
+    /* ulam_twins_parallel(6) = 5 */
+    limit = 6;
+    expected = 5;
+    result = ulam_twins_parallel(limit);
+    ppr_tb_assert_equal(msg, "ulam_twins_parallel", limit, -2, 
+                        expected, result);
+
+    /* ulam_multiples_parallel(391, 6) = 386 */
+    limit = 391;
+    number = 6;
+    expected = 386;
+    result = ulam_multiples_parallel(limit, number);
+    ppr_tb_assert_equal(msg, "ulam_multiples_parallel", limit, number, 
+                        expected, result);
+
+    printf("Testfall 17 ulam_multiples_parallel: "
+           "Ergebnisse stimmen mit ulam_multiples ueberein\n");
+    fflush(stdout);
+
+    for (threads = 1; threads <= 4; threads += 3)
+    {
+        ulam_parallel_set_threads(threads);
+        mismatches = 0;
+        for (number = 2; number <= 12; number++)
+        {
+            for (limit = number - 1; limit <= 3000; limit += 37)
+            {
+                if (ulam_multiples_parallel(limit, number)
+                    != ulam_multiples(limit, number))
+                {
+                    mismatches++;
+                }
+            }
+        }
+
+        /* Anzahl der Abweichungen = 0 */
+        expected = 0;
+        result = mismatches;
+        ppr_tb_assert_equal(msg, "ulam_multiples_parallel", threads, -2, 
+                            expected, result);
+    }
+
+    ulam_parallel_set_threads(0);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ppr_tb_count_items
+ * ------------------------------------------------------------------------- */
+static void ppr_tb_count_items(int lo, int hi, void *arg)
+{
+    int *visits = (int *) arg;
+    int i;
+
+    for (i = lo; i <= hi; i++)
+    {
+        __atomic_add_fetch(&visits[i], 1, __ATOMIC_RELAXED);
+    }
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ppr_tb_testUlam_sched
+ * ------------------------------------------------------------------------- */
+void ppr_tb_testUlam_sched()
+{
+    static int visits[100000];
+    static int serial[100000];
+    static int parallel[100000];
+    ulam_sched_stats stats[8];
+    long long items;
+    int threads;
+    int expected;
+    int result;
+    int mismatches;
+    int i;
+    
+    char *msg = "testUlam_sched (test_ulam)";
+    
+    printf("========================================================\n");
+    printf("Ueberpruefe Testfaelle ( U L A M _ S C H E D ): ");
+    printf("\n========================================================\n");
+    printf("Testfall 18 ulam_sched_parallel_for: "
+           "Jedes Element wird genau einmal bearbeitet\n");
+    fflush(stdout);
+
+    ulam_parallel_set_threads(4);
+    ulam_sched_parallel_for(0, 0, 1, ppr_tb_count_items, visits);
+    ulam_sched_reset_stats();
+
+    memset(visits, 0, sizeof(visits));
+    ulam_sched_parallel_for(0, 99999, 0, ppr_tb_count_items, visits);
+    mismatches = 0;
+    for (i = 0; i < 100000; i++)
+    {
+        if (visits[i] != 1)
+        {
+            mismatches++;
+        }
+    }
+
+    /* Anzahl der Abweichungen = 0 */
+    expected = 0;
+    result = mismatches;
+    ppr_tb_assert_equal(msg, "ulam_sched_parallel_for", 99999, -2, 
+                        expected, result);
+
+    /* Summe der bearbeiteten Elemente aller Threads = 100000 */
+    threads = ulam_sched_get_stats(stats, 8);
+    items = 0;
+    for (i = 0; i < threads && i < 8; i++)
+    {
+        items += stats[i].items;
+    }
+    expected = 100000;
+    result = (int) items;
+    ppr_tb_assert_equal(msg, "ulam_sched_get_stats", threads, -2, 
+                        expected, result);
+
+    printf("Testfall 19 ulam_max_range: "
+           "Verteilung auf Threads liefert gleiche Werte\n");
+    fflush(stdout);
+
+    ulam_parallel_set_threads(1);
+    ulam_max_range(1, 100000, serial);
+    ulam_parallel_set_threads(4);
+    ulam_max_range(1, 100000, parallel);
+
+    /* Anzahl der Abweichungen = 0 */
+    expected = 0;
+    result = memcmp(serial, parallel, sizeof(serial)) == 0 ? 0 : 1;
+    ppr_tb_assert_equal(msg, "ulam_max_range", 100000, -2, 
+                        expected, result);
+
+    ulam_parallel_set_threads(0);
+    ulam_sched_shutdown();
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ppr_tb_testUlam_wide
+ * ------------------------------------------------------------------------- */
+void ppr_tb_testUlam_wide()
+{
+    ulam_u128 peak;
+    int limit;
+    int number;
+    int expected;
+    int result;
+    
+    char *msg = "testUlam_wide (test_ulam)";
+    
+    printf("========================================================\n");
+    printf("Ueberpruefe Testfaelle ( U L A M _ W I D E ): ");
+    printf("\n========================================================\n");
+    printf("Testfall 20 ulam_max64: "
+           "Maxima oberhalb von INT_MAX ohne Ueberlauf\n");
+    fflush(stdout);
+
+    /* ulam_max64(27) = 9232 */
+    expected = 1;
+    result = ulam_max64(27) == 9232;
+    ppr_tb_assert_equal(msg, "ulam_max64", 27, -2, expected, result);
+
+    /* ulam_max64(ULAM_MAX) = 3221225476 */
+    expected = 1;
+    result = ulam_max64(ULAM_MAX) == 3221225476ULL;
+    ppr_tb_assert_equal(msg, "ulam_max64", ULAM_MAX, -2, expected, result);
+
+    printf("Testfall 21 ulam_max_wide: "
+           "Maximum oberhalb von 2^64 durch Wechsel auf 128 Bit\n");
+    fflush(stdout);
+
+    /* ulam_max_wide(12327829503) = 20722398914405051728 */
+    peak = (ulam_u128) 20722398914ULL * 1000000000ULL + 405051728ULL;
+    expected = 1;
+    result = ulam_max_wide(12327829503ULL) == peak
+             && ulam_max128(12327829503ULL) == peak;
+    ppr_tb_assert_equal(msg, "ulam_max_wide", -1, -2, expected, result);
+
+    /* ulam_max64(12327829503) = 0, da nicht mit 64 Bit darstellbar */
+    expected = 1;
+    result = ulam_max64(12327829503ULL) == 0;
+    ppr_tb_assert_equal(msg, "ulam_max64", -1, -2, expected, result);
+
+    printf("Testfall 22 ulam_multiples64: "
+           "Gueltige Werte fuer Parameter limit und number\n");
+    fflush(stdout);
+
+    /* ulam_twins64(6) = 5 */
+    limit = 6;
+    expected = 5;
+    result = (int) ulam_twins64(limit);
+    ppr_tb_assert_equal(msg, "ulam_twins64", limit, -2, expected, result);
+
+    /* ulam_multiples64(391, 6) = 386 */
+    limit = 391;
+    number = 6;
+    expected = 386;
+    result = (int) ulam_multiples64(limit, number);
+    ppr_tb_assert_equal(msg, "ulam_multiples64", limit, number, 
+                        expected, result);
+
+    /* ulam_multiples128(1000, 2) = 982 */
+    limit = 1000;
+    number = 2;
+    expected = 982;
+    result = (int) ulam_multiples128(limit, number);
+    ppr_tb_assert_equal(msg, "ulam_multiples128", limit, number, 
+                        expected, result);
+
+    /* ulam_multiples64(109, 4) = -1 */
+    limit = 109;
+    number = 4;
+    expected = -1;
+    result = (int) ulam_multiples64(limit, number);
+    ppr_tb_assert_equal(msg, "ulam_multiples64", limit, number, 
+                        expected, result);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ppr_tb_testUlam_jump
+ * ------------------------------------------------------------------------- */
+void ppr_tb_testUlam_jump()
+{
+    int a0;
+    int expected;
+    int result;
+    int mismatches;
+    
+    char *msg = "testUlam_jump (test_ulam)";
+    char *fct = "ulam_max_jump";
+    
+    printf("========================================================\n");
+    printf("Ueberpruefe Testfaelle ( U L A M _ M A X _ J U M P ): ");
+    printf("\n========================================================\n");
+    printf("Testfall 23 ulam_max_jump: "
+           "Uebereinstimmung mit ulam_max\n");
+    fflush(stdout);
+
+    /* ulam_max_jump(0) = -1 */
+    a0 = 0;
+    expected = -1;
+    result = ulam_max_jump(a0);
+    ppr_tb_assert_equal(msg, fct, a0, -2, expected, result);
+
+    /* kleine Startzahlen und Startzahlen im Bereich des Ueberlaufs */
+    mismatches = 0;
+    for (a0 = 1; a0 <= 200000; a0++)
+    {
+        if (ulam_max_jump(a0) != ulam_max(a0))
+        {
+            mismatches++;
+        }
+    }
+    for (a0 = ULAM_MAX - 20; a0 <= ULAM_MAX + 20; a0++)
+    {
+        if (ulam_max_jump(a0) != ulam_max(a0))
+        {
+            mismatches++;
+        }
+    }
+
+    /* Anzahl der Abweichungen = 0 */
+    expected = 0;
+    result = mismatches;
+    ppr_tb_assert_equal(msg, fct, 200000, -2, expected, result);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ppr_tb_testUlam_sieve
+ * ------------------------------------------------------------------------- */
+void ppr_tb_testUlam_sieve()
+{
+    int64_t *peaks;
+    int n;
+    int a0;
+    int expected;
+    int result;
+    int mismatches;
+    
+    char *msg = "testUlam_sieve (test_ulam)";
+    char *fct = "ulam_peak_table";
+    
+    printf("========================================================\n");
+    printf("Ueberpruefe Testfaelle ( U L A M _ S I E V E ): ");
+    printf("\n========================================================\n");
+    printf("Testfall 24 ulam_peak_table: Ungueltige Parameter\n");
+    fflush(stdout);
+
+    /* ulam_peak_table(-1, peaks) = -1 */
+    n = -1;
+    expected = -1;
+    result = ulam_peak_table(n, NULL);
+    ppr_tb_assert_equal(msg, fct, n, -2, expected, result);
+
+    printf("Testfall 25 ulam_peak_table: "
+           "Uebereinstimmung mit ulam_max_wide\n");
+    fflush(stdout);
+
+    n = 200000;
+    peaks = (int64_t *) malloc(((size_t) n + 1) * sizeof(int64_t));
+    mismatches = ulam_peak_table(n, peaks) == 0 ? 0 : 1;
+    if (peaks[0] != -1)
+    {
+        mismatches++;
+    }
+    for (a0 = 1; a0 <= n; a0++)
+    {
+        if ((ulam_u128) peaks[a0] != ulam_max_wide((uint64_t) a0))
+        {
+            mismatches++;
+        }
+    }
+    free(peaks);
+
+    /* Anzahl der Abweichungen = 0 */
+    expected = 0;
+    result = mismatches;
+    ppr_tb_assert_equal(msg, fct, n, -2, expected, result);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ppr_tb_testUlam_index
+ * ------------------------------------------------------------------------- */
+void ppr_tb_testUlam_index()
+{
+    const char *path = "ppr_tb_test_ulam.idx";
+    int *serial;
+    FILE *file;
+    int width;
+    int hi;
+    int a0;
+    int expected;
+    int result;
+    int mismatches;
+    
+    char *msg = "testUlam_index (test_ulam)";
+    
+    printf("========================================================\n");
+    printf("Ueberpruefe Testfaelle ( U L A M _ I N D E X ): ");
+    printf("\n========================================================\n");
+    printf("Testfall 26 ulam_index: Ungueltige Parameter und Dateien\n");
+    fflush(stdout);
+
+    /* ulam_index_build(path, 1, 100, 16) = -1 */
+    expected = -1;
+    result = ulam_index_build(path, 1, 100, 16);
+    ppr_tb_assert_equal(msg, "ulam_index_build", 16, -2, expected, result);
+
+    /* ulam_index_open fuer eine nicht vorhandene Datei = -1 */
+    remove(path);
+    expected = -1;
+    result = ulam_index_open(path, 1);
+    ppr_tb_assert_equal(msg, "ulam_index_open", -1, -2, expected, result);
+
+    printf("Testfall 27 ulam_index: "
+           "ulam_max mit Index stimmt mit ulam_max ohne Index ueberein\n");
+    fflush(stdout);
+
+    hi = 100000;
+    serial = (int *) malloc(((size_t) hi + 2) * sizeof(int));
+    for (a0 = 1; a0 <= hi + 1; a0++)
+    {
+        serial[a0] = ulam_max(a0);
+    }
+
+    for (width = 32; width <= 64; width += 32)
+    {
+        mismatches = 0;
+        if (ulam_index_build(path, 2, hi, width) != 0
+            || ulam_index_open(path, 1) != 0)
+        {
+            mismatches++;
+        }
+        if (ulam_index_lookup(1) != 0 || ulam_index_lookup(hi + 1) != 0)
+        {
+            mismatches++;
+        }
+        for (a0 = 1; a0 <= hi + 1; a0++)
+        {
+            if (ulam_max(a0) != serial[a0])
+            {
+                mismatches++;
+            }
+        }
+        ulam_index_close();
+
+        /* Anzahl der Abweichungen = 0 */
+        expected = 0;
+        result = mismatches;
+        ppr_tb_assert_equal(msg, "ulam_index_open", width, -2, 
+                            expected, result);
+    }
+    free(serial);
+
+    printf("Testfall 28 ulam_index: Beschaedigte Datei\n");
+    fflush(stdout);
+
+    /* Ein veraenderter Wert wird durch die Pruefsumme erkannt */
+    file = fopen(path, "r+b");
+    if (file != NULL)
+    {
+        fseek(file, (long) sizeof(ulam_index_header) + 100, SEEK_SET);
+        fputc(0x7f, file);
+        fclose(file);
+    }
+    expected = -1;
+    result = ulam_index_open(path, 1);
+    ppr_tb_assert_equal(msg, "ulam_index_open", -1, -2, expected, result);
+
+    ulam_index_close();
+    remove(path);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ppr_tb_testUlam_runs
+ * ------------------------------------------------------------------------- */
+void ppr_tb_testUlam_runs()
+{
+    int limit;
+    int number;
+    int expected;
+    int result;
+    int mismatches;
+    
+    char *msg = "testUlam_runs (test_ulam)";
+    char *fct = "ulam_runs_multiples";
+    
+    printf("========================================================\n");
+    printf("Ueberpruefe Testfaelle ( U L A M _ R U N S ): ");
+    printf("\n========================================================\n");
+    printf("Testfall 29 ulam_runs_multiples: Ungueltige Parameter\n");
+    fflush(stdout);
+
+    /* ulam_runs_build(0) = -1 */
+    expected = -1;
+    result = ulam_runs_build(0);
+    ppr_tb_assert_equal(msg, "ulam_runs_build", 0, -2, expected, result);
+
+    ulam_runs_build(2000);
+
+    /* ulam_runs_multiples(1000, 1) = -1 */
+    limit = 1000;
+    number = 1;
+    expected = -1;
+    result = ulam_runs_multiples(limit, number);
+    ppr_tb_assert_equal(msg, fct, limit, number, expected, result);
+
+    printf("Testfall 30 ulam_runs_multiples: "
+           "Uebereinstimmung mit ulam_multiples\n");
+    fflush(stdout);
+
+    /* ulam_runs_multiples(391, 6) = 386 */
+    limit = 391;
+    number = 6;
+    expected = 386;
+    result = ulam_runs_multiples(limit, number);
+    ppr_tb_assert_equal(msg, fct, limit, number, expected, result);
+
+    /* ulam_runs_twins(6) = 5 */
+    limit = 6;
+    expected = 5;
+    result = ulam_runs_twins(limit);
+    ppr_tb_assert_equal(msg, "ulam_runs_twins", limit, -2, expected, result);
+
+    /* alle Grenzen innerhalb und knapp ausserhalb des Index */
+    mismatches = 0;
+    for (number = 2; number <= 8; number++)
+    {
+        for (limit = 1; limit <= 2100; limit++)
+        {
+            if (ulam_runs_multiples(limit, number) 
+                != ulam_multiples(limit, number))
+            {
+                mismatches++;
+            }
+        }
+    }
+
+    /* Anzahl der Abweichungen = 0 */
+    expected = 0;
+    result = mismatches;
+    ppr_tb_assert_equal(msg, fct, 2100, -2, expected, result);
+
+    ulam_runs_release();
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ppr_tb_collect_group
+ * ------------------------------------------------------------------------- */
+static int ppr_tb_collect_group(int start, int len, int peak, void *arg)
+{
+    int *summary = (int *) arg;
+
+    /* summary: Anzahl der Startzahlen, letzter Start, letzte Laenge, Abbruch */
+    summary[0] += len;
+    summary[1] = start;
+    summary[2] = len;
+    if (peak != ulam_max(start) || peak != ulam_max(start + len - 1))
+    {
+        summary[0] = -1000000;
+    }
+
+    return summary[3];
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ppr_tb_testUlam_groups
+ * ------------------------------------------------------------------------- */
+void ppr_tb_testUlam_groups()
+{
+    int summary[4];
+    int number;
+    int expected;
+    int result;
+    int mismatches;
+    
+    char *msg = "testUlam_groups (test_ulam)";
+    char *fct = "ulam_groups";
+    
+    printf("========================================================\n");
+    printf("Ueberpruefe Testfaelle ( U L A M _ G R O U P S ): ");
+    printf("\n========================================================\n");
+    printf("Testfall 31 ulam_groups: Ungueltige Parameter\n");
+    fflush(stdout);
+
+    /* ulam_groups(10, 9, 2, ...) = -1 */
+    memset(summary, 0, sizeof(summary));
+    expected = -1;
+    result = (int) ulam_groups(10, 9, 2, ppr_tb_collect_group, summary);
+    ppr_tb_assert_equal(msg, fct, 10, 9, expected, result);
+
+    printf("Testfall 32 ulam_groups: Alle Gruppen eines Intervalls\n");
+    fflush(stdout);
+
+    /* Gruppen der Groesse 1 ueberdecken [100, 2000] vollstaendig */
+    memset(summary, 0, sizeof(summary));
+    ulam_groups(100, 2000, 1, ppr_tb_collect_group, summary);
+    expected = 1901;
+    result = summary[0];
+    ppr_tb_assert_equal(msg, fct, 100, 2000, expected, result);
+
+    /* Die letzte Gruppe entspricht dem Ergebnis von ulam_multiples */
+    mismatches = 0;
+    for (number = 2; number <= 6; number++)
+    {
+        memset(summary, 0, sizeof(summary));
+        ulam_groups(1, 1000, number, ppr_tb_collect_group, summary);
+        if (summary[1] + summary[2] - number != ulam_multiples(1000, number))
+        {
+            mismatches++;
+        }
+    }
+    expected = 0;
+    result = mismatches;
+    ppr_tb_assert_equal(msg, fct, 1000, -2, expected, result);
+
+    /* Abbruch durch die Callback-Funktion nach der ersten Gruppe */
+    memset(summary, 0, sizeof(summary));
+    summary[3] = 1;
+    expected = 1;
+    result = (int) ulam_groups(1, 1000, 2, ppr_tb_collect_group, summary);
+    ppr_tb_assert_equal(msg, fct, 1, 1000, expected, result);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ppr_tb_count_overflow
+ * ------------------------------------------------------------------------- */
+static void ppr_tb_count_overflow(int seed, int an, long count, void *arg)
+{
+    (*(int *) arg)++;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ppr_tb_overflow_thread
+ * ------------------------------------------------------------------------- */
+static void *ppr_tb_overflow_thread(void *arg)
+{
+    /* Ein Ueberlauf, danach endet der Thread */
+    ulam(ULAM_MAX);
+
+    return arg;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ppr_tb_testUlam_overflow
+ * ------------------------------------------------------------------------- */
+void ppr_tb_testUlam_overflow()
+{
+    ulam_overflow_stats stats;
+    pthread_t threads[8];
+    int out[41];
+    static int range[131072];
+    int started;
+    int i;
+    int next;
+    int logged;
+    long serial;
+    int a0;
+    int expected;
+    int result;
+    
+    char *msg = "testUlam_overflow (test_ulam)";
+    
+    printf("========================================================\n");
+    printf("Ueberpruefe Testfaelle ( U L A M _ O V E R F L O W ): ");
+    printf("\n========================================================\n");
+    printf("Testfall 33 ulam_step: Status statt Ausgabe\n");
+    fflush(stdout);
+
+    /* ulam_step(0, &next) = ULAM_INVALID */
+    a0 = 0;
+    expected = ULAM_INVALID;
+    result = ulam_step(a0, &next);
+    ppr_tb_assert_equal(msg, "ulam_step", a0, -2, expected, result);
+
+    /* ulam_step(ULAM_MAX, &next) = ULAM_OVERFLOW */
+    a0 = ULAM_MAX;
+    expected = ULAM_OVERFLOW;
+    result = ulam_step(a0, &next);
+    ppr_tb_assert_equal(msg, "ulam_step", a0, -2, expected, result);
+
+    printf("Testfall 34 ulam_overflow: Statistik aller Threads\n");
+    fflush(stdout);
+
+    /* ulam(ULAM_MAX) und ulam_max(ULAM_MAX + 2) werden gezaehlt */
+    ulam_overflow_reset_stats();
+    ulam(ULAM_MAX);
+    ulam_max(ULAM_MAX + 2);
+    ulam_overflow_get_stats(&stats);
+    expected = 1;
+    result = stats.count == 2 && stats.first_seed == ULAM_MAX 
+             && stats.last_seed == ULAM_MAX + 2;
+    ppr_tb_assert_equal(msg, "ulam_overflow_get_stats", ULAM_MAX, -2, 
+                        expected, result);
+
+    /* Protokoll des ersten und jedes zweiten Ueberlaufs */
+    ulam_overflow_reset_stats();
+    logged = 0;
+    ulam_overflow_set_logger(ppr_tb_count_overflow, 2, &logged);
+    ulam(ULAM_MAX);
+    ulam(ULAM_MAX);
+    ulam(ULAM_MAX);
+    ulam_overflow_set_logger(NULL, 1, NULL);
+    expected = 2;
+    result = logged;
+    ppr_tb_assert_equal(msg, "ulam_overflow_set_logger", 2, -2, 
+                        expected, result);
+
+    /* ulam_max_range zaehlt dieselben Ueberlaeufe wie ulam_max */
+    ulam_overflow_reset_stats();
+    for (a0 = ULAM_MAX - 20; a0 <= ULAM_MAX + 20; a0++)
+    {
+        ulam_max(a0);
+    }
+    ulam_overflow_get_stats(&stats);
+    serial = stats.count;
+    ulam_overflow_reset_stats();
+    ulam_max_range(ULAM_MAX - 20, ULAM_MAX + 20, out);
+    ulam_overflow_get_stats(&stats);
+    expected = 1;
+    result = serial > 0 && stats.count == serial;
+    ppr_tb_assert_equal(msg, "ulam_max_range", ULAM_MAX - 20, ULAM_MAX + 20, 
+                        expected, result);
+
+    /* Ueberlaeufe in den Hilfsthreads zaehlen mit */
+    ulam_parallel_set_threads(1);
+    ulam_overflow_reset_stats();
+    ulam_max_range(ULAM_MAX - 131071, ULAM_MAX, range);
+    ulam_overflow_get_stats(&stats);
+    serial = stats.count;
+    ulam_parallel_set_threads(4);
+    ulam_overflow_reset_stats();
+    ulam_max_range(ULAM_MAX - 131071, ULAM_MAX, range);
+    ulam_overflow_get_stats(&stats);
+    ulam_parallel_set_threads(0);
+    expected = 1;
+    result = serial > 0 && stats.count == serial;
+    ppr_tb_assert_equal(msg, "ulam_max_range", ULAM_MAX - 131071, ULAM_MAX, 
+                        expected, result);
+
+    /* Ueberlaeufe beendeter Threads bleiben erhalten */
+    ulam_overflow_reset_stats();
+    started = 0;
+    for (i = 0; i < 8; i++)
+    {
+        if (pthread_create(&threads[started], NULL, ppr_tb_overflow_thread, 
+                           NULL) == 0)
+        {
+            started++;
+        }
+    }
+    for (i = 0; i < started; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    ulam_overflow_get_stats(&stats);
+    expected = started;
+    result = (int) stats.count;
+    ppr_tb_assert_equal(msg, "ulam_overflow_get_stats", ULAM_MAX, -2, 
+                        expected, result);
+    ulam_overflow_reset_stats();
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ppr_tb_testUlam_stats
+ * ------------------------------------------------------------------------- */
+void ppr_tb_testUlam_stats()
+{
+    ulam_stats_counters stats;
+    int expected;
+    int result;
+    
+    char *msg = "testUlam_stats (test_ulam)";
+    
+    printf("========================================================\n");
+    printf("Ueberpruefe Testfaelle ( U L A M _ S T A T S ): ");
+    printf("\n========================================================\n");
+    printf("Testfall 35 ulam_stats: Zaehler mit und ohne ULAM_STATS\n");
+    fflush(stdout);
+
+    /* ulam_max(77671) hat 231 Schritte, davon 83 ungerade; kleinere
+     * Startzahlen stehen in der Tabelle aus ulam_constexpr.h */
+    ulam_stats_reset();
+    ulam_max(77671);
+    ulam_stats_snapshot(&stats);
+    expected = 1;
+    if (ulam_stats_enabled())
+    {
+        result = stats.trajectories == 1 && stats.steps == 231 
+                 && stats.odd_steps == 83
+                 && stats.length_hist[231 / ULAM_STATS_HIST_WIDTH] == 1;
+    }
+    else
+    {
+        result = stats.trajectories == 0 && stats.steps == 0;
+    }
+    ppr_tb_assert_equal(msg, "ulam_stats_snapshot", 77671, -2, 
+                        expected, result);
+
+    /* ulam_twins(6) = 5 durchsucht die Startzahlen 6 und 5; deren Maxima
+     * stehen in der Tabelle aus ulam_constexpr.h, der Cache wird nicht
+     * benutzt */
+    ulam_stats_reset();
+    ulam_twins(6);
+    ulam_stats_snapshot(&stats);
+    expected = 1;
+    if (ulam_stats_enabled())
+    {
+        result = stats.searches == 1 && stats.search_seeds == 2 
+                 && stats.search_early_exits == 1
+                 && stats.cache_misses + stats.cache_hits == 0;
+    }
+    else
+    {
+        result = stats.searches == 0;
+    }
+    ppr_tb_assert_equal(msg, "ulam_stats_snapshot", 6, -2, 
+                        expected, result);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ppr_tb_testUlam_query
+ * ------------------------------------------------------------------------- */
+void ppr_tb_testUlam_query()
+{
+    const char *lines[] = { "max 27", "twins 6", "multiples 391 6", 
+                            "  multiples  1000 3 ", "max 0", "max", 
+                            "max 27 1", "min 27", "max 99999999999" };
+    const int results[] = { 9232, 5, 386, 972, -1, -1, -1, -1, -1 };
+    const int valid[] = { 1, 1, 1, 1, 1, 0, 0, 0, 0 };
+    ulam_query queries[9];
+    char buffer[32];
+    int i;
+    int expected;
+    int result;
+    int mismatches;
+    
+    char *msg = "testUlam_query (test_ulam)";
+    
+    printf("========================================================\n");
+    printf("Ueberpruefe Testfaelle ( U L A M _ Q U E R Y ): ");
+    printf("\n========================================================\n");
+    printf("Testfall 36 ulam_query: Anfragen lesen und beantworten\n");
+    fflush(stdout);
+
+    /* Gueltige und ungueltige Zeilen */
+    mismatches = 0;
+    for (i = 0; i < 9; i++)
+    {
+        if ((ulam_query_parse(lines[i], strlen(lines[i]), &queries[i]) == 0)
+            != valid[i])
+        {
+            mismatches++;
+        }
+    }
+    expected = 0;
+    result = mismatches;
+    ppr_tb_assert_equal(msg, "ulam_query_parse", 9, -2, expected, result);
+
+    /* Ergebnisse des Stapels in der Reihenfolge der Anfragen */
+    ulam_query_eval_batch(queries, 9);
+    mismatches = 0;
+    for (i = 0; i < 9; i++)
+    {
+        if (valid[i] && queries[i].result != results[i])
+        {
+            mismatches++;
+        }
+    }
+    expected = 0;
+    result = mismatches;
+    ppr_tb_assert_equal(msg, "ulam_query_eval_batch", 9, -2, 
+                        expected, result);
+
+    /* Ausgabe eines Ergebnisses und einer ungueltigen Anfrage */
+    expected = 1;
+    result = ulam_query_format(&queries[0], buffer, sizeof(buffer)) == 5
+             && memcmp(buffer, "9232\n", 5) == 0
+             && ulam_query_format(&queries[5], buffer, sizeof(buffer)) == 6
+             && memcmp(buffer, "error\n", 6) == 0;
+    ppr_tb_assert_equal(msg, "ulam_query_format", 27, -2, expected, result);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ppr_tb_testUlam_lru
+ * ------------------------------------------------------------------------- */
+void ppr_tb_testUlam_lru()
+{
+    ulam_query queries[3];
+    ulam_lru lru;
+    int value;
+    int expected;
+    int result;
+    
+    char *msg = "testUlam_lru (test_ulam)";
+    
+    printf("========================================================\n");
+    printf("Ueberpruefe Testfaelle ( U L A M _ L R U ): ");
+    printf("\n========================================================\n");
+    printf("Testfall 37 ulam_lru: Antworten zwischenspeichern\n");
+    fflush(stdout);
+
+    ulam_query_parse("max 27", 6, &queries[0]);
+    ulam_query_parse("twins 27", 8, &queries[1]);
+    ulam_query_parse("multiples 27 2", 14, &queries[2]);
+
+    /* Gleiche Argumente, aber verschiedene Arten ergeben verschiedene
+     * Schluessel */
+    expected = 1;
+    result = ulam_lru_key(&queries[0]) != ulam_lru_key(&queries[1])
+             && ulam_lru_key(&queries[1]) != ulam_lru_key(&queries[2]);
+    ppr_tb_assert_equal(msg, "ulam_lru_key", 27, -2, expected, result);
+
+    /* Bei zwei Eintraegen verdraengt der dritte den am laengsten nicht
+     * benutzten */
+    expected = 1;
+    result = ulam_lru_init(&lru, 2) == 0;
+    if (result)
+    {
+        ulam_lru_put(&lru, ulam_lru_key(&queries[0]), 9232);
+        ulam_lru_put(&lru, ulam_lru_key(&queries[1]), 25);
+        result = ulam_lru_get(&lru, ulam_lru_key(&queries[0]), &value)
+                 && value == 9232;
+        ulam_lru_put(&lru, ulam_lru_key(&queries[2]), 25);
+        result = result
+                 && !ulam_lru_get(&lru, ulam_lru_key(&queries[1]), &value)
+                 && ulam_lru_get(&lru, ulam_lru_key(&queries[0]), &value)
+                 && value == 9232
+                 && ulam_lru_get(&lru, ulam_lru_key(&queries[2]), &value)
+                 && value == 25;
+        ulam_lru_free(&lru);
+    }
+    ppr_tb_assert_equal(msg, "ulam_lru_put", 2, -2, expected, result);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ppr_tb_testUlam_constexpr
+ * ------------------------------------------------------------------------- */
+void ppr_tb_testUlam_constexpr()
+{
+    /* Beim Uebersetzen berechnet */
+    static_assert(ulam_constexpr(27) == 82, "ulam_constexpr(27)");
+    static_assert(ulam_max_constexpr(27) == 9232, "ulam_max_constexpr(27)");
+    static constexpr ulam_constexpr_table<8> table;
+    static_assert(table.peak[27] == 9232, "ulam_constexpr_table");
+
+    int a0;
+    int expected;
+    int result;
+    int mismatches;
+    
+    char *msg = "testUlam_constexpr (test_ulam)";
+    
+    printf("========================================================\n");
+    printf("Ueberpruefe Testfaelle ( U L A M _ C O N S T E X P R ): ");
+    printf("\n========================================================\n");
+    printf("Testfall 38 ulam_max_constexpr: "
+           "Tabelle und Laufzeitwerte stimmen ueberein\n");
+    fflush(stdout);
+
+    /* Kleine Startzahlen aus der Tabelle von ulam_max() */
+    mismatches = 0;
+    for (a0 = 1; a0 < table.size; a0++)
+    {
+        if (table.peak[a0] != ulam_max_constexpr(a0)
+            || ulam_max(a0) != ulam_max_constexpr(a0))
+        {
+            mismatches++;
+        }
+    }
+    expected = 0;
+    result = mismatches;
+    ppr_tb_assert_equal(msg, "ulam_max_constexpr", 255, -2, 
+                        expected, result);
+
+    /* Randwerte der Tabelle in ulam_max() */
+    expected = 1;
+    result = ulam_max(60975) == 593279152
+             && ulam_max((1 << ULAM_CONSTEXPR_BITS) - 1) 
+                == ulam_max_constexpr((1 << ULAM_CONSTEXPR_BITS) - 1)
+             && ulam_max(1 << ULAM_CONSTEXPR_BITS) 
+                == ulam_max_constexpr(1 << ULAM_CONSTEXPR_BITS)
+             && ulam_max_constexpr(0) == -1;
+    ppr_tb_assert_equal(msg, "ulam_max", 60975, -2, expected, result);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ppr_tb_map_reference
+ * ------------------------------------------------------------------------- */
+static ulam_map_result ppr_tb_map_reference(int64_t a0, int64_t max_steps)
+{
+    /* Schrittweise wie die allgemeine Regel, ohne Zykluserkennung */
+    ulam_map_result result = { ULAM_MAP_ONE, a0, 0, 0, 0 };
+    int64_t an = a0;
+
+    while (an != 1)
+    {
+        if (result.steps == max_steps)
+        {
+            result.status = ULAM_MAP_LIMIT;
+            break;
+        }
+        if (ulam_map<3, 1, 2>::step(an, &an) != 0)
+        {
+            result.status = ULAM_MAP_OVERFLOW;
+            break;
+        }
+        result.steps++;
+        if (an > result.peak)
+        {
+            result.peak = an;
+        }
+    }
+
+    return result;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ppr_tb_testUlam_map
+ * ------------------------------------------------------------------------- */
+void ppr_tb_testUlam_map()
+{
+    ulam_map_result r;
+    ulam_map_result reference;
+    int64_t a0;
+    int64_t max_steps;
+    int mismatches;
+    int expected;
+    int result;
+    
+    char *msg = "testUlam_map (test_ulam)";
+    
+    printf("========================================================\n");
+    printf("Ueberpruefe Testfaelle ( U L A M _ M A P ): ");
+    printf("\n========================================================\n");
+    printf("Testfall 39 ulam_map: Abbildungen A * an + B mit Teiler D\n");
+    fflush(stdout);
+
+    /* 3n+1: 27 erreicht 1 nach 111 Schritten mit Maximum 9232 */
+    r = ulam_map<3, 1, 2>::run(27, 1000);
+    expected = 1;
+    result = r.status == ULAM_MAP_ONE && r.peak == 9232 && r.steps == 111;
+    ppr_tb_assert_equal(msg, "ulam_map<3, 1, 2>", 27, -2, expected, result);
+
+    /* 5n+1: 13 liegt auf einem Zyklus der Laenge 10 mit Maximum 416 */
+    r = ulam_map<5, 1, 2>::run(13, 1000);
+    expected = 1;
+    result = r.status == ULAM_MAP_CYCLE && r.cycle_min == 13 
+             && r.cycle_len == 10 && r.peak == 416;
+    ppr_tb_assert_equal(msg, "ulam_map<5, 1, 2>", 13, -2, expected, result);
+
+    /* 3n-1: 17 laeuft in den Zyklus 17, 50, ..., 34 der Laenge 18 */
+    r = ulam_map<3, -1, 2>::run(17, 1000);
+    expected = 1;
+    result = r.status == ULAM_MAP_CYCLE && r.cycle_min == 17 
+             && r.cycle_len == 18;
+    ppr_tb_assert_equal(msg, "ulam_map<3, -1, 2>", 17, -2, expected, result);
+
+    /* 5n+1: 7 divergiert und endet mit Ueberlauf bzw. Schrittgrenze */
+    expected = 1;
+    result = ulam_map<5, 1, 2>::run(7, 100000).status == ULAM_MAP_OVERFLOW
+             && ulam_map<5, 1, 2>::run(7, 100).status == ULAM_MAP_LIMIT
+             && ulam_map<5, 1, 2>::run(7, 100).steps == 100;
+    ppr_tb_assert_equal(msg, "ulam_map<5, 1, 2>", 7, -2, expected, result);
+
+    /* Teiler 3: 4, 9, 3, 1 */
+    r = ulam_map<2, 1, 3>::run(4, 1000);
+    expected = 1;
+    result = r.status == ULAM_MAP_ONE && r.peak == 9 && r.steps == 3;
+    ppr_tb_assert_equal(msg, "ulam_map<2, 1, 3>", 4, -2, expected, result);
+
+    /* Die geraden Schritte der Spezialisierung enden an der Schrittgrenze */
+    r = ulam_map<3, 1, 2>::run(8, 1);
+    expected = 1;
+    result = r.status == ULAM_MAP_LIMIT && r.steps == 1;
+    ppr_tb_assert_equal(msg, "ulam_map<3, 1, 2>", 8, 1, expected, result);
+
+    /* Spezialisierung und schrittweise Regel bei kleinen Schrittgrenzen */
+    mismatches = 0;
+    for (a0 = 1; a0 <= 64; a0++)
+    {
+        for (max_steps = 0; max_steps <= 24; max_steps++)
+        {
+            r = ulam_map<3, 1, 2>::run(a0, max_steps);
+            reference = ppr_tb_map_reference(a0, max_steps);
+            if (r.status != reference.status || r.steps != reference.steps
+                || r.peak != reference.peak)
+            {
+                mismatches++;
+            }
+        }
+    }
+    expected = 0;
+    result = mismatches;
+    ppr_tb_assert_equal(msg, "ulam_map<3, 1, 2>", 64, 24, expected, result);
+
+    /* Negative Schrittgrenze bedeutet in beiden Varianten unbegrenzt */
+    r = ulam_map<3, 1, 2>::run(27, -1);
+    reference = ppr_tb_map_reference(27, -1);
+    expected = 1;
+    result = r.status == ULAM_MAP_ONE && r.steps == 111 
+             && reference.status == ULAM_MAP_ONE && reference.steps == 111
+             && ulam_map<5, 1, 2>::run(13, -1).status == ULAM_MAP_CYCLE;
+    ppr_tb_assert_equal(msg, "ulam_map<3, 1, 2>", 27, -1, expected, result);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ppr_tb_testUlam_traj
+ * ------------------------------------------------------------------------- */
+void ppr_tb_testUlam_traj()
+{
+    ulam_traj_stats stats;
+    ulam_traj_stats *range;
+    ulam_traj_stats single;
+    int a0;
+    int expected;
+    int result;
+    int mismatches;
+    
+    char *msg = "testUlam_traj (test_ulam)";
+    
+    printf("========================================================\n");
+    printf("Ueberpruefe Testfaelle ( U L A M _ T R A J ): ");
+    printf("\n========================================================\n");
+    printf("Testfall 40 ulam_traj: Kennzahlen in einem Durchlauf\n");
+    fflush(stdout);
+
+    /* 27: Maximum 9232 in Schritt 77, unter 27 nach 96, 1 nach 111 
+     * Schritten */
+    expected = 1;
+    result = ulam_traj(27, ULAM_TRAJ_ALL, &stats) == ULAM_OK
+             && stats.peak == 9232 && stats.peak_step == 77
+             && stats.glide == 96 && stats.stopping_time == 111;
+    ppr_tb_assert_equal(msg, "ulam_traj", 27, -2, expected, result);
+
+    /* Nur die Gleitzeit, die uebrigen Kennzahlen bleiben -1 */
+    expected = 1;
+    result = ulam_traj(27, ULAM_TRAJ_GLIDE, &stats) == ULAM_OK
+             && stats.glide == 96 && stats.peak == -1 
+             && stats.stopping_time == -1 && stats.peak_step == -1;
+    ppr_tb_assert_equal(msg, "ulam_traj", 27, -2, expected, result);
+
+    /* Ueberlauf und ungueltige Startzahl */
+    expected = 1;
+    result = ulam_traj(ULAM_MAX, ULAM_TRAJ_ALL, &stats) == ULAM_OVERFLOW
+             && stats.peak == ulam_max(ULAM_MAX) && stats.stopping_time == -1
+             && ulam_traj(0, ULAM_TRAJ_ALL, &stats) == ULAM_INVALID;
+    ppr_tb_assert_equal(msg, "ulam_traj", ULAM_MAX, -2, expected, result);
+
+    /* Bereich stimmt mit Einzelberechnung und ulam_max() ueberein */
+    range = (ulam_traj_stats *) malloc(10000 * sizeof(ulam_traj_stats));
+    mismatches = (range == NULL)
+                 || ulam_traj_range(1, 10000, ULAM_TRAJ_ALL, range) != 0;
+    for (a0 = 1; a0 <= 10000 && mismatches == 0; a0++)
+    {
+        ulam_traj(a0, ULAM_TRAJ_ALL, &single);
+        if (range[a0 - 1].peak != ulam_max(a0) 
+            || range[a0 - 1].stopping_time != single.stopping_time
+            || range[a0 - 1].glide != single.glide
+            || range[a0 - 1].peak_step != single.peak_step)
+        {
+            mismatches++;
+        }
+    }
+    free(range);
+    expected = 0;
+    result = mismatches;
+    ppr_tb_assert_equal(msg, "ulam_traj_range", 10000, -2, expected, result);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ppr_tb_testUlam_rmq
+ * ------------------------------------------------------------------------- */
+void ppr_tb_testUlam_rmq()
+{
+    int lo;
+    int hi;
+    int best;
+    int peak;
+    int a0;
+    int expected;
+    int result;
+    int mismatches;
+    
+    char *msg = "testUlam_rmq (test_ulam)";
+    
+    printf("========================================================\n");
+    printf("Ueberpruefe Testfaelle ( U L A M _ R M Q ): ");
+    printf("\n========================================================\n");
+    printf("Testfall 41 ulam_rmq_query: Bereichsmaxima\n");
+    fflush(stdout);
+
+    /* 27 hat das groesste Maximum 9232 in [1, 50], 31 folgt mit 9232 */
+    expected = 1;
+    result = ulam_rmq_build(1000) == 0
+             && ulam_rmq_query(1, 50, &peak) == 27 && peak == 9232
+             && ulam_rmq_query(28, 50, &peak) == 31 && peak == 9232;
+    ppr_tb_assert_equal(msg, "ulam_rmq_query", 50, -2, expected, result);
+
+    /* Bereiche ueber mehrere Bloecke stimmen mit einer Suche ueberein */
+    mismatches = 0;
+    for (lo = 1; lo <= 1000; lo += 37)
+    {
+        for (hi = lo; hi <= 1000; hi += 53)
+        {
+            best = lo;
+            for (a0 = lo; a0 <= hi; a0++)
+            {
+                if (ulam_max(a0) > ulam_max(best))
+                {
+                    best = a0;
+                }
+            }
+            if (ulam_rmq_query(lo, hi, NULL) != best)
+            {
+                mismatches++;
+            }
+        }
+    }
+    expected = 0;
+    result = mismatches;
+    ppr_tb_assert_equal(msg, "ulam_rmq_query", 1000, -2, expected, result);
+
+    /* Bereiche ausserhalb des Index */
+    expected = 1;
+    result = ulam_rmq_query(0, 10, NULL) == -1 
+             && ulam_rmq_query(10, 1001, NULL) == -1
+             && ulam_rmq_query(11, 10, NULL) == -1;
+    ulam_rmq_release();
+    result = result && ulam_rmq_query(1, 10, NULL) == -1;
+    ppr_tb_assert_equal(msg, "ulam_rmq_query", 1001, -2, expected, result);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ppr_tb_testUlam_records
+ * ------------------------------------------------------------------------- */
+void ppr_tb_testUlam_records()
+{
+    const char *path = "ppr_tb_test_ulam.rec";
+    ulam_records_state direct;
+    ulam_records_state resumed;
+    FILE *file;
+    int expected;
+    int result;
+    
+    char *msg = "testUlam_records (test_ulam)";
+    
+    printf("========================================================\n");
+    printf("Ueberpruefe Testfaelle ( U L A M _ R E C O R D S ): ");
+    printf("\n========================================================\n");
+    printf("Testfall 42 ulam_records_scan: Pfadrekorde bis 100000\n");
+    fflush(stdout);
+
+    /* 19 Rekorde von 1 bis 77671 mit dem Maximum 1570824736 */
+    ulam_records_init(&direct);
+    expected = 1;
+    result = ulam_records_scan(&direct, 100000, NULL, NULL) == 19
+             && direct.record_seed == 77671 
+             && direct.record_peak == 1570824736
+             && direct.next == 100001;
+    ppr_tb_assert_equal(msg, "ulam_records_scan", 100000, -2, 
+                        expected, result);
+
+    printf("Testfall 43 ulam_records_load: Suche fortsetzen\n");
+    fflush(stdout);
+
+    /* Unterbrochene Suche liefert denselben Stand */
+    ulam_records_init(&resumed);
+    expected = 1;
+    result = ulam_records_scan(&resumed, 50000, NULL, NULL) == 17
+             && ulam_records_save(path, &resumed) == 0
+             && ulam_records_load(path, &resumed) == 0
+             && ulam_records_scan(&resumed, 100000, NULL, NULL) == 2
+             && resumed.record_seed == direct.record_seed
+             && resumed.record_peak == direct.record_peak
+             && resumed.records == direct.records;
+    ppr_tb_assert_equal(msg, "ulam_records_load", 50000, -2, 
+                        expected, result);
+
+    /* Beschaedigte Datei wird abgelehnt */
+    file = fopen(path, "r+b");
+    if (file != NULL)
+    {
+        fseek(file, 16, SEEK_SET);
+        fputc(0x55, file);
+        fclose(file);
+    }
+    expected = -1;
+    result = ulam_records_load(path, &resumed);
+    ppr_tb_assert_equal(msg, "ulam_records_load", 0, -2, expected, result);
+    remove(path);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ppr_tb_check_sparse
+ * ------------------------------------------------------------------------- */
+static void ppr_tb_check_sparse(int lo, int hi, void *arg)
+{
+    int *mismatches = (int *) arg;
+    int a0;
+
+    for (a0 = lo; a0 <= hi; a0++)
+    {
+        if (ulam_max(a0) != ulam_max_jump(a0))
+        {
+            __atomic_add_fetch(mismatches, 1, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ppr_tb_testUlam_sparse
+ * ------------------------------------------------------------------------- */
+void ppr_tb_testUlam_sparse()
+{
+    int expected;
+    int result;
+    int mismatches;
+    
+    char *msg = "testUlam_sparse (test_ulam)";
+    
+    printf("========================================================\n");
+    printf("Ueberpruefe Testfaelle ( U L A M _ S P A R S E ): ");
+    printf("\n========================================================\n");
+    printf("Testfall 44 ulam_sparse: Cache fuer grosse Folgenglieder\n");
+    fflush(stdout);
+
+    /* Eintragen und Nachschlagen */
+    expected = 1;
+    result = ulam_sparse_set_budget(1 << 20) == 0
+             && ulam_sparse_get_budget() == (1 << 20)
+             && ulam_sparse_lookup(1000000) == 0;
+    ulam_sparse_insert(1000000, 1000000);
+    result = result && ulam_sparse_lookup(1000000) == 1000000;
+    ppr_tb_assert_equal(msg, "ulam_sparse_lookup", 1000000, -2, 
+                        expected, result);
+
+    /* Gleiche Werte wie ohne Cache bei gemeinsamer Nutzung durch 4 Threads,
+     * auch wenn ein kleiner Cache staendig verdraengen muss */
+    ulam_cache_release();
+    ulam_parallel_set_threads(4);
+    mismatches = 0;
+    ulam_sched_parallel_for(1000000, 1099999, 256, ppr_tb_check_sparse, 
+                            &mismatches);
+    ulam_sparse_set_budget(4096);
+    ulam_sched_parallel_for(2000000, 2099999, 256, ppr_tb_check_sparse, 
+                            &mismatches);
+    ulam_parallel_set_threads(0);
+    expected = 0;
+    result = mismatches;
+    ppr_tb_assert_equal(msg, "ulam_max", 1000000, -2, expected, result);
+
+    /* Budget 0 schaltet den Cache ab */
+    ulam_sparse_set_budget(0);
+    expected = 1;
+    result = ulam_sparse_get_budget() == 0 
+             && ulam_sparse_lookup(1000000) == 0;
+    ppr_tb_assert_equal(msg, "ulam_sparse_set_budget", 0, -2, 
+                        expected, result);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ppr_tb_testUlam_scan
+ * ------------------------------------------------------------------------- */
+void ppr_tb_testUlam_scan()
+{
+    const char *path = "ppr_tb_test_ulam.scn";
+    ulam_scan_state state;
+    ulam_scan_state resumed;
+    FILE *file;
+    int mismatches;
+    int limit;
+    int number;
+    int expected;
+    int result;
+    
+    char *msg = "testUlam_scan (test_ulam)";
+    
+    printf("========================================================\n");
+    printf("Ueberpruefe Testfaelle ( U L A M _ S C A N ): ");
+    printf("\n========================================================\n");
+    printf("Testfall 45 ulam_scan_multiples: wachsende Obergrenzen\n");
+    fflush(stdout);
+
+    /* Beispiele vom Uebungszettel mit fortgesetzter Suche */
+    ulam_scan_init(&state);
+    expected = 1;
+    result = ulam_scan_twins(&state, 1000) == 982
+             && ulam_scan_multiples(&state, 1000, 3) == 972
+             && ulam_scan_multiples(&state, 391, 6) == 386
+             && state.frontier == 1000;
+    ppr_tb_assert_equal(msg, "ulam_scan_multiples", 1000, -2, 
+                        expected, result);
+
+    /* Schrittweise erhoehte Obergrenzen wie ulam_multiples() */
+    mismatches = 0;
+    for (limit = 1500; limit <= 20000; limit += 1500)
+    {
+        for (number = 2; number <= 6; number++)
+        {
+            mismatches += ulam_scan_multiples(&state, limit, number) 
+                          != ulam_multiples(limit, number);
+        }
+    }
+    expected = 0;
+    result = mismatches;
+    ppr_tb_assert_equal(msg, "ulam_scan_multiples", 19500, -2, 
+                        expected, result);
+
+    printf("Testfall 46 ulam_scan_load: Suche fortsetzen\n");
+    fflush(stdout);
+
+    /* Gespeicherter Stand liefert nach dem Laden dieselben Ergebnisse */
+    ulam_scan_init(&resumed);
+    expected = 1;
+    result = ulam_scan_save(path, &state) == 0
+             && ulam_scan_load(path, &resumed) == 0
+             && resumed.frontier == state.frontier
+             && ulam_scan_twins(&resumed, 30000) == ulam_twins(30000)
+             && ulam_scan_multiples(&resumed, 30000, 4) 
+                == ulam_multiples(30000, 4);
+    ppr_tb_assert_equal(msg, "ulam_scan_load", 19500, -2, 
+                        expected, result);
+
+    /* Beschaedigte Datei wird abgelehnt */
+    file = fopen(path, "r+b");
+    if (file != NULL)
+    {
+        fseek(file, 12, SEEK_SET);
+        fputc(0x55, file);
+        fclose(file);
+    }
+    expected = -1;
+    result = ulam_scan_load(path, &resumed);
+    ppr_tb_assert_equal(msg, "ulam_scan_load", 0, -2, expected, result);
+    remove(path);
+    ulam_scan_free(&resumed);
+
+    /* Die Front darf INT_MAX erreichen */
+    ulam_scan_init(&resumed);
+    resumed.frontier = INT_MAX - 5;
+    expected = 1;
+    result = ulam_scan_extend(&resumed, INT_MAX) == 0 
+             && resumed.frontier == INT_MAX && resumed.run_len >= 1;
+    ppr_tb_assert_equal(msg, "ulam_scan_extend", INT_MAX, -2, 
+                        expected, result);
+
+    ulam_scan_free(&resumed);
+    ulam_scan_free(&state);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ppr_tb_hash_group
+ * ------------------------------------------------------------------------- */
+static int ppr_tb_hash_group(int start, int len, int peak, void *arg)
+{
+    unsigned long long *hash = (unsigned long long *) arg;
+
+    /* Reihenfolge und Inhalt aller Gruppen gehen in den Wert ein */
+    *hash = (*hash ^ (unsigned long long) start) * 1099511628211ULL;
+    *hash = (*hash ^ (unsigned long long) len) * 1099511628211ULL;
+    *hash = (*hash ^ (unsigned long long) peak) * 1099511628211ULL;
+
+    return 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ppr_tb_testUlam_shard
+ * ------------------------------------------------------------------------- */
+void ppr_tb_testUlam_shard()
+{
+    const char *prefix = "ppr_tb_test_ulam.shd";
+    const char *paths[8];
+    char names[8][64];
+    unsigned long long direct;
+    unsigned long long merged;
+    long direct_count;
+    long merged_count;
+    FILE *file;
+    int mismatches;
+    int limit;
+    int number;
+    int i;
+    int expected;
+    int result;
+    
+    char *msg = "testUlam_shard (test_ulam)";
+    
+    printf("========================================================\n");
+    printf("Ueberpruefe Testfaelle ( U L A M _ S H A R D ): ");
+    printf("\n========================================================\n");
+    printf("Testfall 47 ulam_shard_merge: Shards aus 4 Prozessen\n");
+    fflush(stdout);
+
+    for (i = 0; i < 8; i++)
+    {
+        ulam_shard_path(names[i], sizeof(names[i]), prefix, i);
+        paths[i] = names[i];
+    }
+
+    /* Zusammengefuehrte Shards liefern dieselben Gruppen wie ulam_groups() */
+    direct = 0;
+    merged = 0;
+    direct_count = ulam_groups(1, 300000, 2, ppr_tb_hash_group, &direct);
+    merged_count = -1;
+    if (ulam_shard_sweep(prefix, 1, 300000, 8, 4) == 0)
+    {
+        merged_count = ulam_shard_merge(paths, 8, 2, ppr_tb_hash_group, 
+                                        &merged);
+    }
+    expected = 1;
+    result = merged_count == direct_count && merged == direct;
+    ppr_tb_assert_equal(msg, "ulam_shard_merge", 300000, 2, 
+                        expected, result);
+
+    /* Shardgrenzen mitten in den Zwillingen 982, 983 und den Drillingen
+     * ab 972, ein Shard nur aus einem Glied */
+    direct = 0;
+    merged = 0;
+    direct_count = ulam_groups(1, 2000, 2, ppr_tb_hash_group, &direct);
+    result = ulam_shard_run(names[0], 1, 973) == 0
+             && ulam_shard_run(names[1], 974, 974) == 0
+             && ulam_shard_run(names[2], 975, 982) == 0
+             && ulam_shard_run(names[3], 983, 2000) == 0
+             && ulam_shard_merge(paths, 4, 2, ppr_tb_hash_group, &merged)
+                == direct_count
+             && merged == direct
+             && ulam_runs_build_shards(paths, 4) == 0
+             && ulam_runs_twins(1000) == 982
+             && ulam_runs_multiples(1000, 3) == 972;
+    ppr_tb_assert_equal(msg, "ulam_shard_merge", 2000, 2, 
+                        expected, result);
+
+    printf("Testfall 48 ulam_runs_build_shards: Index aus Shards\n");
+    fflush(stdout);
+
+    /* Index aus den Shards der Prozesse wie ulam_multiples() */
+    ulam_shard_sweep(prefix, 1, 300000, 8, 4);
+    mismatches = (ulam_runs_build_shards(paths, 8) != 0);
+    for (limit = 1000; limit <= 300000; limit += 49999)
+    {
+        for (number = 2; number <= 5; number++)
+        {
+            mismatches += ulam_runs_multiples(limit, number) 
+                          != ulam_multiples(limit, number);
+        }
+    }
+    ulam_runs_release();
+    expected = 0;
+    result = mismatches;
+    ppr_tb_assert_equal(msg, "ulam_runs_build_shards", 300000, -2, 
+                        expected, result);
+
+    /* Fehlender Shard in der Mitte wird abgelehnt */
+    paths[1] = names[2];
+    expected = -1;
+    result = (int) ulam_shard_merge(paths, 2, 2, ppr_tb_hash_group, &merged);
+    ppr_tb_assert_equal(msg, "ulam_shard_merge", 0, -2, expected, result);
+    paths[1] = names[1];
+
+    /* Beschaedigter Shard wird abgelehnt */
+    file = fopen(names[5], "r+b");
+    if (file != NULL)
+    {
+        fseek(file, -12, SEEK_END);
+        fputc(0x55, file);
+        fclose(file);
+    }
+    result = ulam_runs_build_shards(paths, 8);
+    ppr_tb_assert_equal(msg, "ulam_runs_build_shards", 0, -2, 
+                        expected, result);
+
+    for (i = 0; i < 8; i++)
+    {
+        remove(names[i]);
+    }
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ppr_tb_testUlam_column
+ * ------------------------------------------------------------------------- */
+void ppr_tb_testUlam_column()
+{
+    static int seeds[ULAM_COLUMN_BLOCK_ROWS];
+    static int peaks[ULAM_COLUMN_BLOCK_ROWS];
+    static int steps[ULAM_COLUMN_BLOCK_ROWS];
+    const char *path = "ppr_tb_test_ulam.col";
+    ulam_column_writer writer;
+    ulam_column_reader reader;
+    ulam_column_block block;
+    ulam_traj_stats stats;
+    FILE *file;
+    long size;
+    int mismatches;
+    int rows;
+    int total;
+    int blocks;
+    int wanted;
+    int i;
+    int expected;
+    int result;
+    
+    char *msg = "testUlam_column (test_ulam)";
+    
+    printf("========================================================\n");
+    printf("Ueberpruefe Testfaelle ( U L A M _ C O L U M N ): ");
+    printf("\n========================================================\n");
+    printf("Testfall 49 ulam_column_write_range: Spaltenformat bis 200000\n");
+    fflush(stdout);
+
+    /* Alle Zeilen kommen unveraendert zurueck, mit weniger als 6 Byte je
+     * Zeile statt etwa 25 Byte als Text */
+    mismatches = (ulam_column_write_range(path, 1, 200000) != 0);
+    total = 0;
+    blocks = 0;
+    if (ulam_column_read_open(&reader, path) == 0)
+    {
+        while (ulam_column_read_next(&reader, &block) == 1)
+        {
+            blocks++;
+            rows = ulam_column_read_decode(&reader, seeds, peaks, steps);
+            for (i = 0; i < rows; i++)
+            {
+                ulam_traj(seeds[i], ULAM_TRAJ_STOPPING_TIME, &stats);
+                mismatches += seeds[i] != total + i + 1
+                              || peaks[i] != ulam_max(seeds[i])
+                              || steps[i] != stats.stopping_time;
+            }
+            total += (rows > 0) ? rows : 0;
+        }
+        ulam_column_read_close(&reader);
+    }
+    file = fopen(path, "rb");
+    size = -1;
+    if (file != NULL)
+    {
+        fseek(file, 0, SEEK_END);
+        size = ftell(file);
+        fclose(file);
+    }
+    expected = 1;
+    result = mismatches == 0 && total == 200000 && blocks == 4
+             && size > 0 && size < 6L * 200000;
+    ppr_tb_assert_equal(msg, "ulam_column_write_range", 200000, -2, 
+                        expected, result);
+
+    /* Unsortierte Startzahlen und negative Werte */
+    result = ulam_column_open(&writer, path) == 0
+             && ulam_column_append(&writer, 5, -1, -1) == 0
+             && ulam_column_append(&writer, 2147483647, 0, 7) == 0
+             && ulam_column_append(&writer, 1, 2147483647, 0) == 0
+             && ulam_column_close(&writer) == 0
+             && ulam_column_read_open(&reader, path) == 0
+             && ulam_column_read_next(&reader, &block) == 1
+             && ulam_column_read_decode(&reader, seeds, peaks, steps) == 3
+             && ulam_column_read_next(&reader, &block) == 0
+             && seeds[0] == 5 && peaks[0] == -1 && steps[0] == -1
+             && seeds[1] == 2147483647 && peaks[1] == 0 && steps[1] == 7
+             && seeds[2] == 1 && peaks[2] == 2147483647 && steps[2] == 0;
+    ulam_column_read_close(&reader);
+    ppr_tb_assert_equal(msg, "ulam_column_append", 3, -2, 
+                        expected, result);
+
+    printf("Testfall 50 ulam_column_read_next: Bloecke ueberspringen\n");
+    fflush(stdout);
+
+    /* Nur der letzte Block enthaelt Maxima ab 1.9 * 10^9 */
+    wanted = 0;
+    for (i = 1; i <= 200000; i++)
+    {
+        wanted += ulam_max(i) >= 1900000000;
+    }
+    ulam_column_write_range(path, 1, 200000);
+    blocks = 0;
+    total = 0;
+    if (ulam_column_read_open(&reader, path) == 0)
+    {
+        while (ulam_column_read_next(&reader, &block) == 1)
+        {
+            if (block.peak_max < 1900000000)
+            {
+                continue;
+            }
+            blocks++;
+            rows = ulam_column_read_decode(&reader, seeds, peaks, steps);
+            for (i = 0; i < rows; i++)
+            {
+                total += peaks[i] >= 1900000000;
+            }
+        }
+        ulam_column_read_close(&reader);
+    }
+    result = blocks == 1 && total == wanted && wanted > 0;
+    ppr_tb_assert_equal(msg, "ulam_column_read_next", 1900000000, -2, 
+                        expected, result);
+
+    /* Beschaedigte Spalten werden erkannt */
+    file = fopen(path, "r+b");
+    if (file != NULL)
+    {
+        fseek(file, 100, SEEK_SET);
+        fputc(0x55 ^ fgetc(file), file);
+        fclose(file);
+    }
+    result = -2;
+    if (ulam_column_read_open(&reader, path) == 0)
+    {
+        result = ulam_column_read_next(&reader, &block) == 1
+                 ? ulam_column_read_decode(&reader, seeds, peaks, steps) : -2;
+        ulam_column_read_close(&reader);
+    }
+    expected = -1;
+    ppr_tb_assert_equal(msg, "ulam_column_read_decode", 0, -2, 
+                        expected, result);
+    remove(path);
+}
+
+/**
+ * Protokoll der Fortschrittsmeldungen einer asynchronen Suche.
+ */
+typedef struct
+{
+    ulam_async *cancel_job; /* nach der ersten Meldung abbrechen oder NULL */
+    int calls;              /* Anzahl der Meldungen */
+    int last;               /* zuletzt gemeldete Grenze */
+    int errors;             /* Meldungen, bei denen die Grenze nicht sank */
+} ppr_tb_progress_log;
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ppr_tb_async_progress
+ * ------------------------------------------------------------------------- */
+static void ppr_tb_async_progress(int limit, int verified_lo, void *arg)
+{
+    ppr_tb_progress_log *log = (ppr_tb_progress_log *) arg;
+
+    (void) limit;
+
+    /* Die gepruefte Grenze sinkt mit jedem Fenster */
+    log->errors += log->calls > 0 && verified_lo >= log->last;
+    log->calls++;
+    log->last = verified_lo;
+    if (log->cancel_job != NULL)
+    {
+        ulam_async_cancel(log->cancel_job);
+    }
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ppr_tb_testUlam_async
+ * ------------------------------------------------------------------------- */
+void ppr_tb_testUlam_async()
+{
+    ppr_tb_progress_log log;
+    ulam_async job;
+    ulam_async_status status;
+    int verified_lo;
+    int value;
+    int expected;
+    int result;
+    
+    char *msg = "testUlam_async (test_ulam)";
+    
+    printf("========================================================\n");
+    printf("Ueberpruefe Testfaelle ( U L A M _ A S Y N C ): ");
+    printf("\n========================================================\n");
+    printf("Testfall 51 ulam_async_multiples: Suche im Hintergrund\n");
+    fflush(stdout);
+
+    ulam_parallel_set_threads(4);
+
+    /* Beispiele vom Uebungszettel */
+    expected = 1;
+    result = ulam_async_multiples(&job, 1000, 3, 0, NULL, NULL) == 0
+             && ulam_async_wait(&job, &value, &verified_lo) 
+                == ULAM_ASYNC_DONE
+             && value == 972 && verified_lo == 972 && ulam_async_done(&job);
+    result = result && ulam_async_twins(&job, 1000, 0, NULL, NULL) == 0
+             && ulam_async_wait(&job, &value, NULL) == ULAM_ASYNC_DONE
+             && value == 982;
+    ppr_tb_assert_equal(msg, "ulam_async_multiples", 1000, 3, 
+                        expected, result);
+
+    /* Zwoelflinge bis 2000000 liegen weit unten, jedes Fenster meldet
+     * eine kleinere Grenze */
+    memset(&log, 0, sizeof(log));
+    status = ULAM_ASYNC_RUNNING;
+    if (ulam_async_multiples(&job, 2000000, 12, 0, ppr_tb_async_progress,
+                             &log) == 0)
+    {
+        status = ulam_async_wait(&job, &value, &verified_lo);
+    }
+    result = status == ULAM_ASYNC_DONE && value == 795202
+             && log.calls > 1 && log.errors == 0 && log.last > value;
+    ppr_tb_assert_equal(msg, "ulam_async_multiples", 2000000, 12, 
+                        expected, result);
+
+    printf("Testfall 52 ulam_async_cancel: Abbruch und Frist\n");
+    fflush(stdout);
+
+    /* Abbruch nach dem ersten Fenster: Teilergebnis oberhalb des
+     * tatsaechlichen Ergebnisses */
+    memset(&log, 0, sizeof(log));
+    log.cancel_job = &job;
+    status = ULAM_ASYNC_RUNNING;
+    if (ulam_async_multiples(&job, 2000000, 12, 0, ppr_tb_async_progress,
+                             &log) == 0)
+    {
+        status = ulam_async_wait(&job, &value, &verified_lo);
+    }
+    result = status == ULAM_ASYNC_CANCELLED && value == -1 
+             && log.calls == 1 && verified_lo == log.last
+             && verified_lo > 795202 && verified_lo <= 2000000;
+    ppr_tb_assert_equal(msg, "ulam_async_cancel", 2000000, 12, 
+                        expected, result);
+
+    /* Ohne Frist dauerte die Suche nach 1000 gleichen Maxima bis 10^9 
+     * Minuten */
+    status = ULAM_ASYNC_RUNNING;
+    if (ulam_async_multiples(&job, 1000000000, 1000, 20000, NULL, 
+                             NULL) == 0)
+    {
+        status = ulam_async_wait(&job, &value, &verified_lo);
+    }
+    result = status == ULAM_ASYNC_EXPIRED && value == -1 
+             && verified_lo > 0 && verified_lo <= 1000000000;
+    ppr_tb_assert_equal(msg, "ulam_async_multiples", 1000000000, 1000, 
+                        expected, result);
+
+    ulam_parallel_set_threads(0);
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: ppr_tb_assert_equal
+ * ------------------------------------------------------------------------- */
+static void ppr_tb_assert_equal(char *testcase, char *function,
+                                int a0_bzw_limit, int number, 
+                                int expected, int result)
+{    
+    if (result == expected)
+    {
+        ppr_tb_print_ok();
+    }
+    else
+    {
+        printf("[ERROR]\n");
+
+        if (number >= -1)
+        {
+            printf("   Aufruf von %s(%d, %d)\n", 
+                   function, a0_bzw_limit, number);
+        }
+        else
+        {
+            printf("   Aufruf von %s(%d)\n", function, a0_bzw_limit);
+        }
+        printf("   expected:<[\n");
+        printf("   %d\n", expected);
+        printf("   ]> but was:<[\n");
+        printf("   %d", result);
+        printf("\n   ]>\n");
+        fflush(stdout);
+
+#ifndef TESTBENCH
+        printf("%%TEST_FAILED%% time=0 testname=%s "
+               "message=expected: %d, but was %d\n", 
+               testcase, expected, result);
+#endif
+    }
+}
+
+/* ----------------------------------------------------------------------------
+ * Funktion: main
+ * ------------------------------------------------------------------------- */
+#ifndef TESTBENCH
+int main(void)
+{   
+    printf("%%SUITE_STARTING%% test_ulam\n");
+    printf("%%SUITE_STARTED%%\n");
+
+    printf("%%TEST_STARTED%%  testUlam_max (test_ulam)\n");
+    ppr_tb_testUlam_max();
+    printf("%%TEST_FINISHED%% time=0 testUlam_max (test_ulam)\n");
+
+    printf("%%TEST_STARTED%%  testUlam_twins (test_ulam)\n");
+    ppr_tb_testUlam_twins();
+    printf("%%TEST_FINISHED%% time=0 testUlam_twins (test_ulam)\n");
+
+    printf("%%TEST_STARTED%%  testUlam_multiples (test_ulam)\n");
+    ppr_tb_testUlam_multiples();
+    printf("%%TEST_FINISHED%% time=0 testUlam_multiples (test_ulam)\n");
+
+    printf("%%TEST_STARTED%%  testUlam_cache (test_ulam)\n");
+    ppr_tb_testUlam_cache();
+    printf("%%TEST_FINISHED%% time=0 testUlam_cache (test_ulam)\n");
+
+    printf("%%TEST_STARTED%%  testUlam_max_range (test_ulam)\n");
+    ppr_tb_testUlam_max_range();
+    printf("%%TEST_FINISHED%% time=0 testUlam_max_range (test_ulam)\n");
+
+    printf("%%TEST_STARTED%%  testUlam_parallel (test_ulam)\n");
+    ppr_tb_testUlam_parallel();
+    printf("%%TEST_FINISHED%% time=0 testUlam_parallel (test_ulam)\n");
+
+    printf("%%TEST_STARTED%%  testUlam_sched (test_ulam)\n");
+    ppr_tb_testUlam_sched();
+    printf("%%TEST_FINISHED%% time=0 testUlam_sched (test_ulam)\n");
+
+    printf("%%TEST_STARTED%%  testUlam_wide (test_ulam)\n");
+    ppr_tb_testUlam_wide();
+    printf("%%TEST_FINISHED%% time=0 testUlam_wide (test_ulam)\n");
+
+    printf("%%TEST_STARTED%%  testUlam_jump (test_ulam)\n");
+    ppr_tb_testUlam_jump();
+    printf("%%TEST_FINISHED%% time=0 testUlam_jump (test_ulam)\n");
+
+    printf("%%TEST_STARTED%%  testUlam_sieve (test_ulam)\n");
+    ppr_tb_testUlam_sieve();
+    printf("%%TEST_FINISHED%% time=0 testUlam_sieve (test_ulam)\n");
+
+    printf("%%TEST_STARTED%%  testUlam_index (test_ulam)\n");
+    ppr_tb_testUlam_index();
+    printf("%%TEST_FINISHED%% time=0 testUlam_index (test_ulam)\n");
+
+    printf("%%TEST_STARTED%%  testUlam_runs (test_ulam)\n");
+    ppr_tb_testUlam_runs();
+    printf("%%TEST_FINISHED%% time=0 testUlam_runs (test_ulam)\n");
+
+    printf("%%TEST_STARTED%%  testUlam_groups (test_ulam)\n");
+    ppr_tb_testUlam_groups();
+    printf("%%TEST_FINISHED%% time=0 testUlam_groups (test_ulam)\n");
+
+    printf("%%TEST_STARTED%%  testUlam_overflow (test_ulam)\n");
+    ppr_tb_testUlam_overflow();
+    printf("%%TEST_FINISHED%% time=0 testUlam_overflow (test_ulam)\n");
+
+    printf("%%TEST_STARTED%%  testUlam_stats (test_ulam)\n");
+    ppr_tb_testUlam_stats();
+    printf("%%TEST_FINISHED%% time=0 testUlam_stats (test_ulam)\n");
+
+    printf("%%TEST_STARTED%%  testUlam_query (test_ulam)\n");
+    ppr_tb_testUlam_query();
+    printf("%%TEST_FINISHED%% time=0 testUlam_query (test_ulam)\n");
+
+    printf("%%TEST_STARTED%%  testUlam_lru (test_ulam)\n");
+    ppr_tb_testUlam_lru();
+    printf("%%TEST_FINISHED%% time=0 testUlam_lru (test_ulam)\n");
+
+    printf("%%TEST_STARTED%%  testUlam_constexpr (test_ulam)\n");
+    ppr_tb_testUlam_constexpr();
+    printf("%%TEST_FINISHED%% time=0 testUlam_constexpr (test_ulam)\n");
+
+    printf("%%TEST_STARTED%%  testUlam_map (test_ulam)\n");
+    ppr_tb_testUlam_map();
+    printf("%%TEST_FINISHED%% time=0 testUlam_map (test_ulam)\n");
+
+    printf("%%TEST_STARTED%%  testUlam_traj (test_ulam)\n");
+    ppr_tb_testUlam_traj();
+    printf("%%TEST_FINISHED%% time=0 testUlam_traj (test_ulam)\n");
+
+    printf("%%TEST_STARTED%%  testUlam_rmq (test_ulam)\n");
+    ppr_tb_testUlam_rmq();
+    printf("%%TEST_FINISHED%% time=0 testUlam_rmq (test_ulam)\n");
+
+    printf("%%TEST_STARTED%%  testUlam_records (test_ulam)\n");
+    ppr_tb_testUlam_records();
+    printf("%%TEST_FINISHED%% time=0 testUlam_records (test_ulam)\n");
+
+    printf("%%TEST_STARTED%%  testUlam_sparse (test_ulam)\n");
+    ppr_tb_testUlam_sparse();
+    printf("%%TEST_FINISHED%% time=0 testUlam_sparse (test_ulam)\n");
+
+    printf("%%TEST_STARTED%%  testUlam_scan (test_ulam)\n");
+    ppr_tb_testUlam_scan();
+    printf("%%TEST_FINISHED%% time=0 testUlam_scan (test_ulam)\n");
+
+    printf("%%TEST_STARTED%%  testUlam_shard (test_ulam)\n");
+    ppr_tb_testUlam_shard();
+    printf("%%TEST_FINISHED%% time=0 testUlam_shard (test_ulam)\n");
+
+    printf("%%TEST_STARTED%%  testUlam_column (test_ulam)\n");
+    ppr_tb_testUlam_column();
+    printf("%%TEST_FINISHED%% time=0 testUlam_column (test_ulam)\n");
+
+    printf("%%TEST_STARTED%%  testUlam_async (test_ulam)\n");
+    ppr_tb_testUlam_async();
+    printf("%%TEST_FINISHED%% time=0 testUlam_async (test_ulam)\n");
 
     printf("%%SUITE_FINISHED%% time=0\n");
     
@@ -346,11 +2460,35 @@ int main(void)
 #ifdef TESTBENCH
 int main(int argc, char **argv)
 {  
-    ppr_tb_write_total_assert(18);
+    ppr_tb_write_total_assert(117);
 
     ppr_tb_testUlam_max();
     ppr_tb_testUlam_twins();
     ppr_tb_testUlam_multiples();
+    ppr_tb_testUlam_cache();
+    ppr_tb_testUlam_max_range();
+    ppr_tb_testUlam_parallel();
+    ppr_tb_testUlam_sched();
+    ppr_tb_testUlam_wide();
+    ppr_tb_testUlam_jump();
+    ppr_tb_testUlam_sieve();
+    ppr_tb_testUlam_index();
+    ppr_tb_testUlam_runs();
+    ppr_tb_testUlam_groups();
+    ppr_tb_testUlam_overflow();
+    ppr_tb_testUlam_stats();
+    ppr_tb_testUlam_query();
+    ppr_tb_testUlam_lru();
+    ppr_tb_testUlam_constexpr();
+    ppr_tb_testUlam_map();
+    ppr_tb_testUlam_traj();
+    ppr_tb_testUlam_rmq();
+    ppr_tb_testUlam_records();
+    ppr_tb_testUlam_sparse();
+    ppr_tb_testUlam_scan();
+    ppr_tb_testUlam_shard();
+    ppr_tb_testUlam_column();
+    ppr_tb_testUlam_async();
     
     ppr_tb_write_summary("", argv[1]);
     